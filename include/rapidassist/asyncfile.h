@@ -0,0 +1,173 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_ASYNCFILE_H
+#define RA_ASYNCFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#include "rapidassist/config.h"
+
+namespace ra { namespace threading {
+  class ThreadPool;
+} //namespace threading
+} //namespace ra
+
+namespace ra { namespace filesystem {
+
+  struct AsyncOperation;
+  struct AsyncRing;
+  class AsyncFileQueue;
+
+  /// <summary>
+  /// The completion handle of an asynchronous file operation.
+  /// Handles can be copied. All copies refer to the same operation.
+  /// </summary>
+  class AsyncHandle {
+  public:
+    /// <summary>
+    /// Create an invalid handle.
+    /// </summary>
+    AsyncHandle();
+    AsyncHandle(const AsyncHandle & other);
+    AsyncHandle & operator=(const AsyncHandle & other);
+    virtual ~AsyncHandle();
+
+    /// <summary>
+    /// Returns true if the handle refers to an operation.
+    /// </summary>
+    bool IsValid() const;
+
+    /// <summary>
+    /// Returns true if the operation is completed. This function does not block.
+    /// </summary>
+    bool IsCompleted() const;
+
+    /// <summary>
+    /// Wait for the operation to complete.
+    /// </summary>
+    /// <returns>Returns true if the operation is successful. Returns false otherwise.</returns>
+    bool Wait() const;
+
+    /// <summary>
+    /// Returns true if the operation is completed and successful.
+    /// </summary>
+    bool IsSuccess() const;
+
+    /// <summary>
+    /// Get the content of the file of a read operation.
+    /// The content is only valid once the operation is completed.
+    /// </summary>
+    /// <returns>Returns the content of the file. Returns an empty string for other operations.</returns>
+    const std::string & GetData() const;
+
+  private:
+    friend class AsyncFileQueue;
+    AsyncHandle(AsyncOperation * operation);
+
+  private:
+    AsyncOperation * operation_;
+  };
+
+  /// <summary>
+  /// Execute file operations asynchronously.
+  /// On Linux, reads and writes are submitted to the kernel with io_uring which allows a single thread
+  /// to keep many operations in flight. Otherwise, operations are executed by a bounded pool of threads.
+  /// </summary>
+  class AsyncFileQueue {
+  public:
+    /// <summary>
+    /// The default maximum number of operations in flight.
+    /// </summary>
+    static const size_t DEFAULT_QUEUE_DEPTH;
+
+    /// <summary>
+    /// Create a queue with the default depth.
+    /// </summary>
+    AsyncFileQueue();
+
+    /// <summary>
+    /// Create a queue.
+    /// </summary>
+    /// <param name="queue_depth">The maximum number of operations in flight. Use 0 for the default depth.</param>
+    /// <param name="allow_io_uring">Defines if io_uring can be used when supported by the kernel.</param>
+    AsyncFileQueue(size_t queue_depth, bool allow_io_uring);
+
+    /// <summary>
+    /// Wait for all operations to complete.
+    /// </summary>
+    virtual ~AsyncFileQueue();
+
+    /// <summary>
+    /// Returns true if reads and writes are executed with io_uring.
+    /// </summary>
+    bool IsUsingIoUring() const;
+
+    /// <summary>
+    /// Read the content of a file asynchronously.
+    /// </summary>
+    /// <param name="path">The path of the file.</param>
+    /// <returns>Returns a handle to the operation. The content is available from AsyncHandle::GetData() once the operation is completed.</returns>
+    AsyncHandle ReadFileAsync(const std::string & path);
+
+    /// <summary>
+    /// Write data to a file asynchronously. The data is copied before the function returns.
+    /// </summary>
+    /// <param name="path">The path of the file.</param>
+    /// <param name="data">The data to write to the file.</param>
+    /// <returns>Returns a handle to the operation.</returns>
+    AsyncHandle WriteFileAsync(const std::string & path, const std::string & data);
+
+    /// <summary>
+    /// Copy a file asynchronously with CopyFile().
+    /// </summary>
+    /// <param name="source_path">The source file path to copy.</param>
+    /// <param name="destination_path">The destination file path.</param>
+    /// <returns>Returns a handle to the operation.</returns>
+    AsyncHandle CopyFileAsync(const std::string & source_path, const std::string & destination_path);
+
+    /// <summary>
+    /// Wait for all operations to complete.
+    /// </summary>
+    void WaitAll();
+
+  private:
+    //disable copy
+    AsyncFileQueue(const AsyncFileQueue &);
+    AsyncFileQueue & operator=(const AsyncFileQueue &);
+
+    void Init(size_t queue_depth, bool allow_io_uring);
+    AsyncHandle SubmitTask(AsyncOperation * operation);
+
+  private:
+    AsyncRing * ring_;
+    ra::threading::ThreadPool * pool_;
+  };
+
+} //namespace filesystem
+} //namespace ra
+
+#endif //RA_ASYNCFILE_H
@@ -0,0 +1,125 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_CPU_H
+#define RA_CPU_H
+
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+
+#ifdef __linux__
+
+namespace ra { namespace cpu {
+
+  /// <summary>Defines a list of logical cpu numbers.</summary>
+  typedef std::vector<int> CpuList;
+
+  /// <summary>
+  /// Defines the topology of a logical cpu.
+  /// </summary>
+  struct CpuInfo {
+    /// <summary>The logical cpu number.</summary>
+    int cpu;
+    /// <summary>True if the cpu is online.</summary>
+    bool online;
+    /// <summary>The physical core id of the cpu, unique within a package. Set to -1 if unknown.</summary>
+    int core_id;
+    /// <summary>The physical package (socket) id of the cpu. Set to -1 if unknown.</summary>
+    int package_id;
+    /// <summary>The logical cpus that share the same physical core, including this cpu (hyper-threading siblings).</summary>
+    CpuList thread_siblings;
+  };
+
+  /// <summary>Defines a list of CpuInfo.</summary>
+  typedef std::vector<CpuInfo> CpuInfoList;
+
+  /// <summary>
+  /// Parse a list of cpus in the kernel's cpulist format. For example: "0-3,8,10-11".
+  /// </summary>
+  /// <param name="value">The cpulist string to parse.</param>
+  /// <param name="cpus">The output sorted list of cpus.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ParseCpuList(const std::string & value, CpuList & cpus);
+
+  /// <summary>
+  /// Get the topology of all possible cpus of the system from '/sys/devices/system/cpu'.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="cpus">The output list of cpus, sorted by cpu number.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetCpuTopology(CpuInfoList & cpus);
+
+  /// <summary>
+  /// Get the list of online cpus of the system.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="cpus">The output list of online cpus.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetOnlineCpus(CpuList & cpus);
+
+  /// <summary>
+  /// Get the list of cpus the current thread is allowed to run on.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="cpus">The output list of cpus.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetCurrentThreadAffinity(CpuList & cpus);
+
+  /// <summary>
+  /// Restrict the current thread to the given list of cpus.
+  /// Pinning a thread to a single cpu provides stable timings for benchmarks.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="cpus">The list of cpus the current thread is allowed to run on.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool SetCurrentThreadAffinity(const CpuList & cpus);
+
+  /// <summary>
+  /// Get the list of cpus the main thread of the given process is allowed to run on.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="cpus">The output list of cpus.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessAffinity(const ra::process::processid_t & pid, CpuList & cpus);
+
+  /// <summary>
+  /// Restrict all threads of the given process to the given list of cpus.
+  /// Threads created afterwards by the process inherit the affinity of their creator.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="cpus">The list of cpus the process is allowed to run on.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool SetProcessAffinity(const ra::process::processid_t & pid, const CpuList & cpus);
+
+} //namespace cpu
+} //namespace ra
+
+#endif //__linux__
+
+#endif //RA_CPU_H
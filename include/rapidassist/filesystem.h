@@ -63,6 +63,61 @@ namespace ra { namespace filesystem {
   /// <returns>Returns the size of the given file path in bytes.</returns>
   uint64_t GetFileSize64(const char * path);
 
+  /// <summary>
+  /// Defines the type of a directory entry.
+  /// </summary>
+  enum DirectoryEntryType {
+    ENTRY_UNKNOWN,
+    ENTRY_FILE,
+    ENTRY_DIRECTORY,
+    ENTRY_SYMLINK,
+    ENTRY_OTHER, //devices, fifos, sockets
+  };
+
+  /// <summary>
+  /// Defines the metadata of a file or directory.
+  /// </summary>
+  struct FileInfo {
+    /// <summary>The type of the file. Symbolic links are followed.</summary>
+    DirectoryEntryType type;
+    /// <summary>The size of the file in bytes.</summary>
+    uint64_t size;
+    /// <summary>The last modification time of the file in seconds since epoch.</summary>
+    uint64_t modified_time;
+    /// <summary>The nanoseconds part of the last modification time. Set to 0 if the platform does not support it.</summary>
+    uint32_t modified_time_nsec;
+    /// <summary>The file type and permission bits of the file (st_mode).</summary>
+    uint32_t mode;
+    /// <summary>The number of 512 bytes blocks allocated for the file. Set to 0 if the platform does not support it.</summary>
+    uint64_t blocks;
+    /// <summary>An identifier of the device that contains the file. Set to 0 if the platform does not support it.</summary>
+    uint64_t device;
+    /// <summary>The inode number of the file on its device. Set to 0 if the platform does not support it.</summary>
+    uint64_t inode;
+    /// <summary>The number of hard links to the file.</summary>
+    uint32_t link_count;
+  };
+
+  /// <summary>
+  /// Get the metadata of a file or directory with a single system call.
+  /// On linux, the metadata is read with statx().
+  /// </summary>
+  /// <param name="path">An valid file or directory path.</param>
+  /// <param name="info">The metadata of the file.</param>
+  /// <returns>Returns true if the file or directory exists. Returns false otherwise.</returns>
+  bool GetFileInfo(const char * path, FileInfo & info);
+
+  /// <summary>
+  /// Get the metadata of multiple files or directories using multiple threads.
+  /// The system calls of each path are issued concurrently which hides their latency on network or FUSE file systems.
+  /// </summary>
+  /// <param name="paths">The list of file or directory paths.</param>
+  /// <param name="infos">The metadata of each path, in the same order as paths. The type of the paths that do not exist is set to ENTRY_UNKNOWN and all other fields are set to 0.</param>
+  /// <param name="num_threads">The number of threads used for the queries. Use 0 for the number of processors.</param>
+  /// <returns>Returns the number of paths that exist.</returns>
+  size_t GetFileInfos(const ra::strings::StringVector & paths, std::vector<FileInfo> & infos, size_t num_threads);
+  inline size_t GetFileInfos(const ra::strings::StringVector & paths, std::vector<FileInfo> & infos) { return GetFileInfos(paths, infos, 0); }
+
   /// <summary>
   /// Returns the filename of the given path.
   /// </summary>
@@ -141,6 +196,117 @@ namespace ra { namespace filesystem {
   bool FindFiles(ra::strings::StringVector & files, const char * path, int depth);
   inline bool FindFiles(ra::strings::StringVector & files, const char * path) { return FindFiles(files, path, -1); }
 
+  /// <summary>
+  /// Find files in a directory / subdirectory using multiple threads.
+  /// Each directory is scanned by a task of a work-stealing thread pool.
+  /// The function finds the same files as FindFiles() but the order of the files may differ between calls unless sorted is true.
+  /// </summary>
+  /// <param name="files">The list of files found.</param>
+  /// <param name="path">An valid directory path.</param>
+  /// <param name="depth">The search depth. Use 0 for finding files in directory path (without subdirectories). Use -1 for find all files in directory path (including subdirectories).</param>
+  /// <param name="num_threads">The number of threads used for the search. Use 0 for the number of processors.</param>
+  /// <param name="sorted">Set to true to sort the list of files found in ascending order.</param>
+  /// <returns>Returns true when files contains the list of files from directory path. Returns false otherwise.</returns>
+  bool FindFilesParallel(ra::strings::StringVector & files, const char * path, int depth, size_t num_threads, bool sorted);
+  inline bool FindFilesParallel(ra::strings::StringVector & files, const char * path) { return FindFilesParallel(files, path, -1, 0, false); }
+
+  /// <summary>
+  /// Defines an entry found while browsing a directory.
+  /// </summary>
+  struct DirectoryEntry {
+    /// <summary>The full path of the entry. The path starts with the browsed directory path.</summary>
+    std::string path;
+    /// <summary>The filename of the entry.</summary>
+    std::string name;
+    /// <summary>The type of the entry. The type is read from the directory itself when the file system supports it.</summary>
+    DirectoryEntryType type;
+    /// <summary>The depth of the entry. Entries of the browsed directory have a depth of 0.</summary>
+    int depth;
+  };
+
+  /// <summary>
+  /// Browse the entries of a directory / subdirectory one at a time.
+  /// Entries are returned in the same order as FindFiles(): each directory entry is followed by its content.
+  /// Only the directories that are currently browsed are kept in memory.
+  /// </summary>
+  class DirectoryIterator {
+  public:
+    DirectoryIterator();
+    virtual ~DirectoryIterator();
+
+    /// <summary>
+    /// Start browsing a directory. Any previously opened directory is closed.
+    /// </summary>
+    /// <param name="path">An valid directory path.</param>
+    /// <param name="depth">The search depth. Use 0 for browsing the directory only (without subdirectories). Use -1 for browsing all subdirectories.</param>
+    /// <returns>Returns true if the directory is opened. Returns false otherwise.</returns>
+    bool Open(const char * path, int depth);
+
+    /// <summary>
+    /// Get the next entry.
+    /// </summary>
+    /// <param name="entry">The next entry.</param>
+    /// <returns>Returns true if an entry is available. Returns false when all entries were returned.</returns>
+    bool Next(DirectoryEntry & entry);
+
+    /// <summary>
+    /// Do not browse the content of the last directory entry returned by Next().
+    /// </summary>
+    void SkipSubtree();
+
+    /// <summary>
+    /// Stop browsing and release all resources.
+    /// </summary>
+    void Close();
+
+  private:
+    //disable copy
+    DirectoryIterator(const DirectoryIterator &);
+    DirectoryIterator & operator=(const DirectoryIterator &);
+
+    struct Frame;
+    bool Push(const std::string & path, int depth);
+    void Pop();
+
+  private:
+    std::vector<Frame *> frames_;
+    int max_depth_;
+    bool has_pending_directory_;
+    std::string pending_path_;
+    int pending_depth_;
+  };
+
+  /// <summary>
+  /// Defines the action to take after visiting a directory entry.
+  /// </summary>
+  enum VisitAction {
+    VISIT_CONTINUE,     //continue browsing, including the content of the visited directory.
+    VISIT_SKIP_SUBTREE, //continue browsing but skip the content of the visited directory.
+    VISIT_STOP,         //stop browsing.
+  };
+
+  /// <summary>
+  /// VisitDirectory() callback interface
+  /// </summary>
+  class IDirectoryVisitor {
+  public:
+    /// <summary>
+    /// VisitDirectory() callback function. Called once for each directory entry.
+    /// </summary>
+    /// <param name="entry">The visited entry.</param>
+    /// <returns>Returns the action to take after visiting the entry.</returns>
+    virtual VisitAction OnDirectoryEntry(const DirectoryEntry & entry) = 0;
+  };
+
+  /// <summary>
+  /// Visit the entries of a directory / subdirectory without storing them.
+  /// </summary>
+  /// <param name="path">An valid directory path.</param>
+  /// <param name="depth">The search depth. Use 0 for visiting the directory only (without subdirectories). Use -1 for visiting all subdirectories.</param>
+  /// <param name="visitor">The visitor that is called for each entry.</param>
+  /// <returns>Returns true if the directory was browsed. Returns false otherwise.</returns>
+  bool VisitDirectory(const char * path, int depth, IDirectoryVisitor * visitor);
+
   /// <summary>
   /// Finds a file using the PATH environment variable.
   /// </summary>
@@ -373,6 +539,10 @@ namespace ra { namespace filesystem {
   /// <param name="source_path">The source file path to copy.</param>
   /// <param name="destination_path">The destination file path.</param>
   /// <returns>Returns true if file copy is successful. Returns false otherwise.</returns>
+  /// <remarks>
+  /// On Linux, the file data is shared with the source file (reflink) when supported by the file system.
+  /// Otherwise, the file is copied in kernel space with copy_file_range() or sendfile() and falls back to a read/write loop.
+  /// </remarks>
   bool CopyFile(const std::string & source_path, const std::string & destination_path);
 
   /// <summary>
@@ -393,6 +563,46 @@ namespace ra { namespace filesystem {
   /// <returns>Returns true if file copy is successful. Returns false otherwise.</returns>
   bool CopyFile(const std::string & source_path, const std::string & destination_path, ProgressReportCallback progress_function);
 
+  /// <summary>
+  /// CopyDirectory() options.
+  /// </summary>
+  struct CopyDirectoryOptions {
+    /// <summary>Create options with default values.</summary>
+    CopyDirectoryOptions();
+
+    /// <summary>Replace the files that already exist in the destination directory. Existing files are skipped when false. Defaults to true.</summary>
+    bool overwrite;
+    /// <summary>Copy the last modification time of the source files and directories. Defaults to false.</summary>
+    bool preserve_times;
+    /// <summary>Copy the permission bits of the source files and directories. Defaults to true.</summary>
+    bool preserve_mode;
+    /// <summary>Recreate the hard links between the source files instead of copying their content multiple times. Defaults to false.</summary>
+    bool preserve_hardlinks;
+    /// <summary>The number of threads that copies files. Use 0 for the number of processors. Defaults to 0.</summary>
+    size_t num_threads;
+  };
+
+  /// <summary>
+  /// Copy a directory and all its content to another destination.
+  /// Files are copied in parallel with CopyFile() by a pool of threads.
+  /// Symbolic links are recreated in the destination directory instead of being followed.
+  /// </summary>
+  /// <param name="source_path">The source directory path to copy.</param>
+  /// <param name="destination_path">The destination directory path. The directory is created if it does not exist.</param>
+  /// <param name="options">The options of the copy.</param>
+  /// <param name="progress_functor">A IProgressReport pointer to handle the progress of the whole copy based on the number of bytes copied. Can be NULL.
+  /// The progress is reported from the worker threads, one thread at a time.</param>
+  /// <returns>Returns true if all files and directories are copied. Returns false otherwise.</returns>
+  bool CopyDirectory(const std::string & source_path, const std::string & destination_path, const CopyDirectoryOptions & options, IProgressReport * progress_functor);
+
+  /// <summary>
+  /// Copy a directory and all its content to another destination with the default options.
+  /// </summary>
+  /// <param name="source_path">The source directory path to copy.</param>
+  /// <param name="destination_path">The destination directory path. The directory is created if it does not exist.</param>
+  /// <returns>Returns true if all files and directories are copied. Returns false otherwise.</returns>
+  inline bool CopyDirectory(const std::string & source_path, const std::string & destination_path) { return CopyDirectory(source_path, destination_path, CopyDirectoryOptions(), NULL); }
+
   /// <summary>
   /// Reads the first 'size' bytes of file 'path' and copy the binary data to 'data' variable.
   /// </summary>
@@ -418,8 +628,76 @@ namespace ra { namespace filesystem {
   /// <returns>Returns true when the function is successful. Returns false otherwise.</returns>
   bool WriteFile(const std::string & path, const std::string & data);
 
+  /// <summary>
+  /// Write data to a file atomically and durably.
+  /// The data is written to a temporary file in the same directory which is flushed to the storage device
+  /// and renamed over the given file. The directory is then flushed to make the rename durable.
+  /// After a crash, the file contains either its previous content or the new data.
+  /// </summary>
+  /// <param name="path">The path of the file.</param>
+  /// <param name="data">The data to write to the file.</param>
+  /// <returns>Returns true when the function is successful. Returns false otherwise.</returns>
+  bool AtomicWriteFile(const std::string & path, const std::string & data);
+
+  /// <summary>
+  /// Write multiple files atomically and durably while flushing the storage device once for the whole batch.
+  /// Each file is written to a temporary file when it is added to the batch.
+  /// Commit() flushes all temporary files at once and renames them over their destination.
+  /// On Linux, each file system is flushed with a single syncfs() call instead of one fsync() per file.
+  /// </summary>
+  class DurableWriteBatch {
+  public:
+    DurableWriteBatch();
+
+    /// <summary>
+    /// Discard the files that are not committed.
+    /// </summary>
+    virtual ~DurableWriteBatch();
+
+    /// <summary>
+    /// Add a file to the batch. The file is not modified until Commit() is called.
+    /// </summary>
+    /// <param name="path">The path of the file.</param>
+    /// <param name="data">The data to write to the file.</param>
+    /// <returns>Returns true when the data is written to a temporary file. Returns false otherwise.</returns>
+    bool Add(const std::string & path, const std::string & data);
+
+    /// <summary>
+    /// Get the number of files that are not committed.
+    /// </summary>
+    /// <returns>Returns the number of files that are not committed.</returns>
+    size_t GetCount() const;
+
+    /// <summary>
+    /// Flush all the files of the batch and replace their destination. The batch is empty after the call.
+    /// </summary>
+    /// <returns>Returns true when all files are replaced and flushed. Returns false otherwise.</returns>
+    bool Commit();
+
+    /// <summary>
+    /// Discard the files that are not committed.
+    /// </summary>
+    void Clear();
+
+  private:
+    //disable copy
+    DurableWriteBatch(const DurableWriteBatch &);
+    DurableWriteBatch & operator=(const DurableWriteBatch &);
+
+    struct Entry {
+      std::string path;
+      std::string temp_path;
+    };
+    std::vector<Entry> entries_;
+  };
+
   /// <summary>
   /// Process a search and replace operation on the data of the given file.
+  /// The file is processed in chunks and the result is written to a temporary file which replaces the original file with a rename.
+  /// Memory usage does not depend on the size of the file. The file is not modified if old_value is not found.
+  /// Symbolic links are resolved and their target is modified. If the file has multiple hard links or if its owner
+  /// cannot be restored, the new content is copied over the original file instead of renamed, which is not atomic.
+  /// Other attributes of the original file such as extended attributes and ACLs are not preserved by the rename.
   /// </summary>
   /// <param name="path">The path of the file.</param>
   /// <param name="old_value">The old value to replace by the new value.</param>
@@ -446,6 +724,16 @@ namespace ra { namespace filesystem {
   /// <returns>Returns true when the function is successful. Returns false otherwise.</returns>
   bool ReadTextFile(const std::string & path, std::string & content);
 
+  /// <summary>
+  /// Reads a text file and store the content into the 'content' variable.
+  /// The content is read in a single pass into a buffer allocated once from the size of the file.
+  /// </summary>
+  /// <param name="path">The path of the file.</param>
+  /// <param name="content">The content of the text file.</param>
+  /// <param name="normalize_newline_characters">Defines if CRLF line endings should be converted to LF line endings.</param>
+  /// <returns>Returns true when the function is successful. Returns false otherwise.</returns>
+  bool ReadTextFile(const std::string & path, std::string & content, bool normalize_newline_characters);
+
   /// <summary>
   /// Write the given content into a text file.
   /// Note that on Windows platform, CR line ending will be converted to CRLF line ending.
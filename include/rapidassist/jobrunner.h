@@ -0,0 +1,173 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_JOBRUNNER_H
+#define RA_JOBRUNNER_H
+
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+#include "rapidassist/strings.h"
+
+#ifndef _WIN32
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines a command executed by a JobRunner.
+  /// </summary>
+  struct Job {
+    /// <summary>The path to the executable to start.</summary>
+    std::string exec_path;
+    /// <summary>The directory to run the command from.</summary>
+    std::string default_directory;
+    /// <summary>The list of arguments for the new process.</summary>
+    ra::strings::StringVector arguments;
+  };
+
+  /// <summary>Defines a list of Job.</summary>
+  typedef std::vector<Job> JobList;
+
+  /// <summary>
+  /// Defines the result of a Job executed by a JobRunner.
+  /// </summary>
+  struct JobResult {
+    /// <summary>The index of the job in the order the jobs were added.</summary>
+    size_t index;
+    /// <summary>The process id of the job. Set to INVALID_PROCESS_ID if the job has failed to start.</summary>
+    processid_t pid;
+    /// <summary>The exit code of the job. Set to -1 if the job has failed to start or was terminated by a signal.</summary>
+    int exit_code;
+    /// <summary>The signal that terminated the job. Set to 0 if the job exited normally.</summary>
+    int term_signal;
+    /// <summary>The elapsed time in seconds between the job launch and its termination.</summary>
+    double runtime;
+  };
+
+  /// <summary>Defines a list of JobResult.</summary>
+  typedef std::vector<JobResult> JobResultList;
+
+  /// <summary>
+  /// JobRunner callback interface.
+  /// </summary>
+  class IJobListener {
+  public:
+    /// <summary>
+    /// JobRunner callback function. Called once for each job that terminates or fails to start.
+    /// </summary>
+    /// <param name="job">The terminated job.</param>
+    /// <param name="result">The result of the terminated job.</param>
+    virtual void OnJobExit(const Job & job, const JobResult & result) = 0;
+  };
+
+  /// <summary>
+  /// Execute a queue of commands with a limited number of concurrent processes, like 'xargs -P'.
+  /// The next job is started as soon as any running job terminates.
+  /// Note: this api is only available on linux and macOS.
+  /// </summary>
+  class JobRunner {
+  public:
+    /// <summary>
+    /// Ctor for the JobRunner class.
+    /// The default maximum number of concurrent jobs is the number of online processors.
+    /// </summary>
+    JobRunner();
+    virtual ~JobRunner();
+
+    /// <summary>
+    /// Set the maximum number of jobs running concurrently.
+    /// </summary>
+    /// <param name="max_parallelism">The maximum number of jobs running concurrently. A value of 0 is interpreted as 1.</param>
+    virtual void SetMaxParallelism(size_t max_parallelism);
+
+    /// <summary>
+    /// Get the maximum number of jobs running concurrently.
+    /// </summary>
+    /// <returns>Returns the maximum number of jobs running concurrently.</returns>
+    virtual size_t GetMaxParallelism() const;
+
+    /// <summary>
+    /// Set the listener that is notified when a job terminates.
+    /// </summary>
+    /// <param name="listener">A valid IJobListener pointer or NULL to disable notifications.</param>
+    virtual void SetListener(IJobListener * listener);
+
+    /// <summary>
+    /// Add a job to the queue.
+    /// </summary>
+    /// <param name="job">The job to add.</param>
+    /// <returns>Returns the index of the job.</returns>
+    virtual size_t Add(const Job & job);
+
+    /// <summary>
+    /// Add a job to the queue.
+    /// </summary>
+    /// <param name="exec_path">The path to the executable to start.</param>
+    /// <param name="default_directory">The directory to run the command from.</param>
+    /// <param name="arguments">The list of arguments for the new process.</param>
+    /// <returns>Returns the index of the job.</returns>
+    virtual size_t Add(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments);
+
+    /// <summary>
+    /// Add a shell command line to the queue. The command is executed with '/bin/sh -c'.
+    /// </summary>
+    /// <param name="command_line">The command line to execute.</param>
+    /// <param name="default_directory">The directory to run the command from.</param>
+    /// <returns>Returns the index of the job.</returns>
+    virtual size_t AddCommandLine(const std::string & command_line, const std::string & default_directory);
+
+    /// <summary>
+    /// Get the number of jobs in the queue.
+    /// </summary>
+    /// <returns>Returns the number of jobs in the queue.</returns>
+    virtual size_t GetJobCount() const;
+
+    /// <summary>
+    /// Execute all jobs of the queue and wait for their termination.
+    /// The queue is emptied when the function returns.
+    /// </summary>
+    /// <returns>Returns true if all jobs have started and exited with code 0. Returns false otherwise.</returns>
+    virtual bool Run();
+
+    /// <summary>
+    /// Get the results of the last call to Run(), in the order the jobs were added.
+    /// </summary>
+    /// <returns>Returns the results of the last call to Run().</returns>
+    virtual const JobResultList & GetResults() const;
+
+  private:
+    size_t max_parallelism_;
+    IJobListener * listener_;
+    JobList jobs_;
+    JobResultList results_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
+
+#endif //RA_JOBRUNNER_H
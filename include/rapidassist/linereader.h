@@ -0,0 +1,130 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_LINEREADER_H
+#define RA_LINEREADER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+
+namespace ra { namespace filesystem {
+
+  /// <summary>
+  /// Read the lines of a text file one at a time in constant memory.
+  /// The file is read in large blocks and lines are returned as views inside the internal buffer without being copied.
+  /// Lines of any length are supported. The internal buffer grows to fit the longest line of the file.
+  /// Lines are separated by the '\n' character. The sequence "\r\n" is also recognized when new-line characters are trimmed.
+  /// </summary>
+  class LineReader {
+  public:
+    /// <summary>
+    /// The default size of the blocks read from the file.
+    /// </summary>
+    static const size_t DEFAULT_BUFFER_SIZE;
+
+    LineReader();
+    virtual ~LineReader();
+
+    /// <summary>
+    /// Open a file for reading. Any previously opened file is closed.
+    /// </summary>
+    /// <param name="path">The path of the file to read.</param>
+    /// <param name="trim_newline_characters">Defines if the new-line characters at the end of each line should be removed.</param>
+    /// <returns>Returns true if the file is opened. Returns false otherwise.</returns>
+    bool Open(const std::string & path, bool trim_newline_characters = true);
+
+    /// <summary>
+    /// Open a file for reading with a custom block size. Any previously opened file is closed.
+    /// </summary>
+    /// <param name="path">The path of the file to read.</param>
+    /// <param name="trim_newline_characters">Defines if the new-line characters at the end of each line should be removed.</param>
+    /// <param name="buffer_size">The size in bytes of the blocks read from the file.</param>
+    /// <returns>Returns true if the file is opened. Returns false otherwise.</returns>
+    bool Open(const std::string & path, bool trim_newline_characters, size_t buffer_size);
+
+    /// <summary>
+    /// Close the file.
+    /// </summary>
+    void Close();
+
+    /// <summary>
+    /// Returns true if a file is opened.
+    /// </summary>
+    bool IsOpen() const;
+
+    /// <summary>
+    /// Read the next line of the file.
+    /// The returned view is not null-terminated and is only valid until the next call to Next() or Close().
+    /// </summary>
+    /// <param name="data">The first character of the line.</param>
+    /// <param name="size">The size of the line in bytes.</param>
+    /// <returns>Returns true if a line is read. Returns false at the end of the file or if an error occurs. See HasError().</returns>
+    bool Next(const char *& data, size_t & size);
+
+    /// <summary>
+    /// Read the next line of the file into a string.
+    /// </summary>
+    /// <param name="line">The content of the line.</param>
+    /// <returns>Returns true if a line is read. Returns false at the end of the file or if an error occurs. See HasError().</returns>
+    bool Next(std::string & line);
+
+    /// <summary>
+    /// Get the number of lines read so far.
+    /// </summary>
+    /// <returns>Returns the number of lines read since the file was opened.</returns>
+    uint64_t GetLineCount() const;
+
+    /// <summary>
+    /// Returns true if an error occured while reading the file.
+    /// </summary>
+    bool HasError() const;
+
+  private:
+    //disable copy
+    LineReader(const LineReader &);
+    LineReader & operator=(const LineReader &);
+
+    bool Fill();
+
+  private:
+    FILE * file_;
+    bool trim_newline_characters_;
+    bool eof_;
+    bool error_;
+    std::vector<char> buffer_;
+    size_t begin_; //offset of the first character of the next line
+    size_t end_;   //offset past the last character read from the file
+    size_t scan_;  //offset where the search for the next new-line character resumes
+    uint64_t line_count_;
+  };
+
+} //namespace filesystem
+} //namespace ra
+
+#endif //RA_LINEREADER_H
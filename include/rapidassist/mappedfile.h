@@ -0,0 +1,114 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_MAPPEDFILE_H
+#define RA_MAPPEDFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#include "rapidassist/config.h"
+
+namespace ra { namespace filesystem {
+
+  /// <summary>
+  /// A read-only view of a file mapped in memory.
+  /// The content of the file is read on demand from the page cache without being copied to the heap.
+  /// The file is unmapped when the instance is destroyed.
+  /// </summary>
+  class MappedFile {
+  public:
+    /// <summary>
+    /// Defines how the mapped content is expected to be accessed.
+    /// </summary>
+    enum AccessPattern {
+      ACCESS_NORMAL,      //no hint
+      ACCESS_SEQUENTIAL,  //the content is read from the start to the end. The file is read ahead aggressively.
+      ACCESS_RANDOM,      //the content is read in random order. Read ahead is disabled.
+    };
+
+    MappedFile();
+    virtual ~MappedFile();
+
+    /// <summary>
+    /// Map a file in memory for sequential access. Any previously mapped file is unmapped.
+    /// </summary>
+    /// <param name="path">The path of the file to map.</param>
+    /// <returns>Returns true if the file is mapped. Returns false otherwise.</returns>
+    bool Open(const std::string & path);
+
+    /// <summary>
+    /// Map a file in memory. Any previously mapped file is unmapped.
+    /// </summary>
+    /// <param name="path">The path of the file to map.</param>
+    /// <param name="pattern">The expected access pattern of the content.</param>
+    /// <returns>Returns true if the file is mapped. Returns false otherwise.</returns>
+    bool Open(const std::string & path, AccessPattern pattern);
+
+    /// <summary>
+    /// Unmap the file.
+    /// </summary>
+    void Close();
+
+    /// <summary>
+    /// Returns true if a file is mapped.
+    /// </summary>
+    bool IsOpen() const;
+
+    /// <summary>
+    /// Get the content of the file.
+    /// </summary>
+    /// <returns>Returns a pointer to the first byte of the file. Returns NULL if the file is empty or not mapped.</returns>
+    const uint8_t * GetData() const;
+
+    /// <summary>
+    /// Get the size of the file.
+    /// </summary>
+    /// <returns>Returns the size of the file in bytes. Returns 0 if the file is not mapped.</returns>
+    uint64_t GetSize() const;
+
+    /// <summary>
+    /// Advise the system that a range of the file will be accessed soon. The range is read asynchronously.
+    /// </summary>
+    /// <param name="offset">The offset of the range in bytes.</param>
+    /// <param name="length">The length of the range in bytes.</param>
+    /// <returns>Returns true if the advice is accepted. Returns false otherwise.</returns>
+    bool WillNeed(uint64_t offset, uint64_t length);
+
+  private:
+    //disable copy
+    MappedFile(const MappedFile &);
+    MappedFile & operator=(const MappedFile &);
+
+  private:
+    uint8_t * data_;
+    uint64_t size_;
+    bool is_open_;
+  };
+
+} //namespace filesystem
+} //namespace ra
+
+#endif //RA_MAPPEDFILE_H
@@ -0,0 +1,190 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PATHFILTER_H
+#define RA_PATHFILTER_H
+
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/strings.h"
+
+namespace ra { namespace filesystem {
+
+  /// <summary>
+  /// A compiled glob pattern using the .gitignore syntax.
+  /// The following wildcards are supported: '*' matches anything except a path separator, '?' matches any single character,
+  /// '[a-z]' matches a character class ('[!a-z]' for the negation) and '**' matches any number of directories.
+  /// A leading '!' negates the pattern and a trailing '/' only matches directories.
+  /// A pattern without a separator (except a trailing one) matches a filename at any depth. Other patterns are relative to the root directory.
+  /// </summary>
+  class GlobPattern {
+  public:
+    GlobPattern();
+    virtual ~GlobPattern();
+
+    /// <summary>
+    /// Compile a pattern.
+    /// </summary>
+    /// <param name="pattern">The pattern to compile. Blank lines and lines starting with '#' are not patterns.</param>
+    /// <returns>Returns true if the pattern is compiled. Returns false otherwise.</returns>
+    bool Compile(const std::string & pattern);
+
+    /// <summary>
+    /// Get the original pattern.
+    /// </summary>
+    /// <returns>Returns the pattern given to Compile().</returns>
+    const std::string & GetPattern() const;
+
+    /// <summary>
+    /// Returns true if the pattern starts with '!'.
+    /// </summary>
+    bool IsNegated() const;
+
+    /// <summary>
+    /// Returns true if the pattern ends with '/'.
+    /// </summary>
+    bool IsDirectoryOnly() const;
+
+    /// <summary>
+    /// Match a path against the pattern. The negation of the pattern is ignored.
+    /// </summary>
+    /// <param name="path">A path relative to the root directory. Use '/' as separator.</param>
+    /// <param name="is_directory">Set to true if the path is a directory.</param>
+    /// <returns>Returns true if the path matches the pattern. Returns false otherwise.</returns>
+    bool Match(const std::string & path, bool is_directory) const;
+
+    /// <summary>
+    /// Match a path against the pattern. The negation of the pattern is ignored.
+    /// </summary>
+    /// <param name="names">The elements of a path relative to the root directory.</param>
+    /// <param name="is_directory">Set to true if the path is a directory.</param>
+    /// <returns>Returns true if the path matches the pattern. Returns false otherwise.</returns>
+    bool Match(const ra::strings::StringVector & names, bool is_directory) const;
+
+  private:
+    bool MatchNames(size_t segment_index, const ra::strings::StringVector & names, size_t name_index) const;
+
+  private:
+    std::string pattern_;
+    ra::strings::StringVector segments_; //each element of the pattern
+    bool negated_;
+    bool directory_only_;
+  };
+
+  /// <summary>
+  /// Filters the files and directories found while browsing a directory.
+  /// Exclude patterns use the .gitignore rules: the last matching pattern wins and the content of an excluded directory is never browsed.
+  /// Include patterns select the entries that are reported. All entries are included if there is no include pattern.
+  /// </summary>
+  class PathFilter {
+  public:
+    PathFilter();
+    virtual ~PathFilter();
+
+    /// <summary>
+    /// Remove all patterns.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Add a pattern that selects the entries to report. For example '**/*.log'.
+    /// </summary>
+    /// <param name="pattern">A GlobPattern pattern.</param>
+    /// <returns>Returns true if the pattern is valid. Returns false otherwise.</returns>
+    bool AddIncludePattern(const std::string & pattern);
+
+    /// <summary>
+    /// Add a pattern that excludes entries. For example 'build/' or '!important.log'.
+    /// </summary>
+    /// <param name="pattern">A GlobPattern pattern.</param>
+    /// <returns>Returns true if the pattern is valid. Returns false otherwise.</returns>
+    bool AddExcludePattern(const std::string & pattern);
+
+    /// <summary>
+    /// Add the exclude patterns of an ignore file (for example a .gitignore file), one pattern per line.
+    /// </summary>
+    /// <param name="path">The path of the ignore file.</param>
+    /// <returns>Returns true if the file was read. Returns false otherwise.</returns>
+    bool LoadIgnoreFile(const std::string & path);
+
+    /// <summary>
+    /// Get the number of include patterns.
+    /// </summary>
+    size_t GetIncludeCount() const;
+
+    /// <summary>
+    /// Get the number of exclude patterns.
+    /// </summary>
+    size_t GetExcludeCount() const;
+
+    /// <summary>
+    /// Check if an entry is excluded. An entry is also excluded if one of its parent directory is excluded.
+    /// </summary>
+    /// <param name="path">A path relative to the root directory. Use '/' as separator.</param>
+    /// <param name="is_directory">Set to true if the path is a directory.</param>
+    /// <returns>Returns true if the entry is excluded. Returns false otherwise.</returns>
+    bool IsExcluded(const std::string & path, bool is_directory) const;
+
+    /// <summary>
+    /// Check if an entry matches the exclude patterns. The parent directories are not checked.
+    /// </summary>
+    /// <param name="names">The elements of a path relative to the root directory.</param>
+    /// <param name="is_directory">Set to true if the path is a directory.</param>
+    /// <returns>Returns true if the entry is excluded. Returns false otherwise.</returns>
+    bool IsExcluded(const ra::strings::StringVector & names, bool is_directory) const;
+
+    /// <summary>
+    /// Check if an entry matches the include patterns.
+    /// </summary>
+    /// <param name="names">The elements of a path relative to the root directory.</param>
+    /// <param name="is_directory">Set to true if the path is a directory.</param>
+    /// <returns>Returns true if the entry is included. Returns false otherwise.</returns>
+    bool IsIncluded(const ra::strings::StringVector & names, bool is_directory) const;
+
+  private:
+    typedef std::vector<GlobPattern> GlobPatternList;
+    static bool Evaluate(const GlobPatternList & patterns, const ra::strings::StringVector & names, bool is_directory, bool default_value);
+
+  private:
+    GlobPatternList includes_;
+    GlobPatternList excludes_;
+  };
+
+  /// <summary>
+  /// Find files in a directory / subdirectory that are selected by a filter.
+  /// Excluded directories are not browsed.
+  /// </summary>
+  /// <param name="files">The list of files found.</param>
+  /// <param name="path">An valid directory path.</param>
+  /// <param name="depth">The search depth. Use 0 for finding files in directory path (without subdirectories). Use -1 for find all files in directory path (including subdirectories).</param>
+  /// <param name="filter">The filter that selects the files.</param>
+  /// <returns>Returns true when files contains the list of files from directory path. Returns false otherwise.</returns>
+  bool FindFiles(ra::strings::StringVector & files, const char * path, int depth, const PathFilter & filter);
+
+} //namespace filesystem
+} //namespace ra
+
+#endif //RA_PATHFILTER_H
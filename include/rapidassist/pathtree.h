@@ -0,0 +1,175 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PATHTREE_H
+#define RA_PATHTREE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/strings.h"
+
+namespace ra { namespace filesystem {
+
+  /// <summary>
+  /// A compact list of files and directories stored as a tree.
+  /// Each entry only stores its name and the index of its parent directory. All names are stored in a single contiguous buffer.
+  /// Full paths are built on demand which avoids storing the same directory prefix for each entry.
+  /// Entries are indexed in insertion order. A parent entry must be added before its children.
+  /// </summary>
+  class PathTree {
+  public:
+    /// <summary>The parent index of the entries that are located directly in the root directory.</summary>
+    static const size_t INVALID_INDEX = (size_t)-1;
+
+    PathTree();
+    virtual ~PathTree();
+
+    /// <summary>
+    /// Remove all entries and the root path.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Set the path of the root directory. The root path is the prefix of all full paths.
+    /// </summary>
+    /// <param name="path">A directory path. Use an empty path for relative entries.</param>
+    void SetRootPath(const std::string & path);
+
+    /// <summary>
+    /// Get the path of the root directory.
+    /// </summary>
+    /// <returns>Returns the path of the root directory.</returns>
+    const std::string & GetRootPath() const;
+
+    /// <summary>
+    /// Get the number of entries.
+    /// </summary>
+    /// <returns>Returns the number of entries.</returns>
+    size_t GetCount() const;
+
+    /// <summary>
+    /// Add a new entry.
+    /// </summary>
+    /// <param name="parent">The index of the parent directory. Use INVALID_INDEX for an entry of the root directory.</param>
+    /// <param name="name">The filename of the entry.</param>
+    /// <param name="type">The type of the entry.</param>
+    /// <returns>Returns the index of the new entry. Returns INVALID_INDEX if the parent index is invalid.</returns>
+    size_t Add(size_t parent, const char * name, DirectoryEntryType type);
+
+    /// <summary>
+    /// Get the index of the parent directory of an entry.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <returns>Returns the index of the parent directory. Returns INVALID_INDEX for entries of the root directory.</returns>
+    size_t GetParent(size_t index) const;
+
+    /// <summary>
+    /// Get the filename of an entry.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <returns>Returns the filename of the entry. The returned pointer is invalidated when a new entry is added.</returns>
+    const char * GetName(size_t index) const;
+
+    /// <summary>
+    /// Get the type of an entry.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <returns>Returns the type of the entry.</returns>
+    DirectoryEntryType GetType(size_t index) const;
+
+    /// <summary>
+    /// Get the depth of an entry. Entries of the root directory have a depth of 0.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <returns>Returns the depth of the entry.</returns>
+    int GetDepth(size_t index) const;
+
+    /// <summary>
+    /// Build the full path of an entry.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <param name="path">The full path of the entry.</param>
+    void GetPath(size_t index, std::string & path) const;
+
+    /// <summary>
+    /// Build the full path of an entry.
+    /// </summary>
+    /// <param name="index">The index of the entry.</param>
+    /// <returns>Returns the full path of the entry.</returns>
+    std::string GetPath(size_t index) const;
+
+    /// <summary>
+    /// Get the indices of all entries in sorted order.
+    /// Entries are sorted by name within each directory and each directory is followed by its content.
+    /// Iterating over the indices in reverse order returns the content of each directory before the directory itself.
+    /// </summary>
+    /// <param name="indices">The sorted indices.</param>
+    void GetSortedIndices(std::vector<size_t> & indices) const;
+
+    /// <summary>
+    /// Get the full path of all entries.
+    /// </summary>
+    /// <param name="files">The list of full paths in insertion order.</param>
+    void GetPaths(ra::strings::StringVector & files) const;
+
+    /// <summary>
+    /// Get the number of bytes used by the tree.
+    /// </summary>
+    /// <returns>Returns the number of bytes allocated by the tree.</returns>
+    size_t GetMemoryUsage() const;
+
+    /// <summary>
+    /// Find files in a directory / subdirectory. The tree is cleared and the given path becomes the root path.
+    /// Entries are added in the same order as FindFiles().
+    /// </summary>
+    /// <param name="path">An valid directory path.</param>
+    /// <param name="depth">The search depth. Use 0 for finding files in directory path (without subdirectories). Use -1 for find all files in directory path (including subdirectories).</param>
+    /// <returns>Returns true when the tree contains the list of files from directory path. Returns false otherwise.</returns>
+    bool FindFiles(const char * path, int depth);
+    inline bool FindFiles(const char * path) { return FindFiles(path, -1); }
+
+  private:
+    struct Node {
+      size_t name_offset;   //offset of the name in names_
+      uint32_t parent;      //index of the parent node or 0xFFFFFFFF
+      uint16_t name_length;
+      uint8_t type;
+      uint8_t depth;        //saturated at 255
+    };
+    typedef std::vector<Node> NodeList;
+
+    NodeList nodes_;
+    std::string names_; //each name is null-terminated
+    std::string root_;
+    std::string prefix_; //root path and separator
+  };
+
+} //namespace filesystem
+} //namespace ra
+
+#endif //RA_PATHTREE_H
@@ -31,6 +31,7 @@
 #ifdef _WIN32
 #include <stdint.h>
 #else
+#include <stdint.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -119,6 +120,176 @@ namespace ra { namespace process {
   /// <param name="arguments">The list of arguments for the new process.</param>
   /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
   processid_t StartProcess(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments);
+
+  /// <summary>
+  /// Defines the io scheduling classes of a process. See ioprio_set().
+  /// </summary>
+  enum IoPriorityClass {
+    IO_PRIORITY_CLASS_INHERIT = -1,
+    IO_PRIORITY_CLASS_REALTIME = 1,
+    IO_PRIORITY_CLASS_BEST_EFFORT = 2,
+    IO_PRIORITY_CLASS_IDLE = 3,
+  };
+
+  /// <summary>
+  /// Defines a resource limit of a process. See setrlimit().
+  /// </summary>
+  struct ResourceLimit {
+    /// <summary>The resource to limit. For example RLIMIT_AS, RLIMIT_CPU or RLIMIT_NOFILE.</summary>
+    int resource;
+    /// <summary>The soft limit of the resource. Use RLIM_INFINITY for no limit.</summary>
+    uint64_t soft_limit;
+    /// <summary>The hard limit of the resource. Use RLIM_INFINITY for no limit.</summary>
+    uint64_t hard_limit;
+  };
+
+  /// <summary>Defines a list of ResourceLimit.</summary>
+  typedef std::vector<ResourceLimit> ResourceLimitList;
+
+  /// <summary>
+  /// Defines the options for launching a new process.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  struct SpawnOptions {
+    /// <summary>The file descriptor to use as the standard input of the new process. Use -1 to inherit from the current process.</summary>
+    int stdin_fd;
+    /// <summary>The file descriptor to use as the standard output of the new process. Use -1 to inherit from the current process.</summary>
+    int stdout_fd;
+    /// <summary>The file descriptor to use as the standard error of the new process. Use -1 to inherit from the current process.</summary>
+    int stderr_fd;
+    /// <summary>Place the new process in a new process group which id is the process id of the new process. See TerminateGroup() and KillGroup().</summary>
+    bool new_process_group;
+    /// <summary>The increment added to the nice value of the new process. Use 0 to inherit the priority of the current process.</summary>
+    int nice_increment;
+    /// <summary>The io scheduling class of the new process. Use IO_PRIORITY_CLASS_INHERIT to inherit from the current process. Only available on linux.</summary>
+    IoPriorityClass io_priority_class;
+    /// <summary>The io priority of the new process within its io scheduling class, from 0 (highest) to 7 (lowest).</summary>
+    int io_priority_level;
+    /// <summary>The list of cpus the new process is allowed to run on. Leave empty to inherit from the current process. Only available on linux.</summary>
+    std::vector<int> cpu_affinity;
+    /// <summary>The resource limits of the new process.</summary>
+    ResourceLimitList resource_limits;
+
+    SpawnOptions() :
+      stdin_fd(-1),
+      stdout_fd(-1),
+      stderr_fd(-1),
+      new_process_group(false),
+      nice_increment(0),
+      io_priority_class(IO_PRIORITY_CLASS_INHERIT),
+      io_priority_level(4)
+    {
+    }
+  };
+
+  /// <summary>
+  /// Start the given process with the given arguments and options from the given directory.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="exec_path">The path to the executable to start.</param>
+  /// <param name="default_directory">The directory to run the command from.</param>
+  /// <param name="arguments">The list of arguments for the new process.</param>
+  /// <param name="options">The options for the new process.</param>
+  /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
+  processid_t StartProcess(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, const SpawnOptions & options);
+
+  /// <summary>
+  /// ExecuteAndCapture() callback interface
+  /// </summary>
+  class IOutputHandler {
+  public:
+    /// <summary>
+    /// ExecuteAndCapture() callback function. Called every time a block of output is read from the process.
+    /// </summary>
+    /// <param name="stream_id">The stream that produced the output. Either STDOUT_FILENO or STDERR_FILENO.</param>
+    /// <param name="buffer">The output data. The buffer is not NULL terminated.</param>
+    /// <param name="size">The size of the output data in bytes.</param>
+    virtual void OnOutput(int stream_id, const char * buffer, size_t size) = 0;
+  };
+
+  /// <summary>
+  /// Execute the given process with the given arguments from the given directory and capture its output.
+  /// The standard output and the standard error of the process are read through pipes as the process is running.
+  /// The function does not use a shell and does not use temporary files.
+  /// The function returns when the process has exited.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="exec_path">The path to the executable to start.</param>
+  /// <param name="default_directory">The directory to run the command from.</param>
+  /// <param name="arguments">The list of arguments for the new process.</param>
+  /// <param name="handler">A valid IOutputHandler pointer which receives the output of the process.</param>
+  /// <param name="exit_code">The process exit code if the function is successful. Set to -1 if the process was terminated by a signal.</param>
+  /// <returns>Returns true if the process was executed and has exited. Returns false otherwise.</returns>
+  bool ExecuteAndCapture(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, IOutputHandler * handler, int & exit_code);
+
+  /// <summary>
+  /// Execute the given process with the given arguments from the given directory and capture its output.
+  /// The standard output and the standard error of the process are read through pipes as the process is running.
+  /// The function does not use a shell and does not use temporary files.
+  /// The function returns when the process has exited.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="exec_path">The path to the executable to start.</param>
+  /// <param name="default_directory">The directory to run the command from.</param>
+  /// <param name="arguments">The list of arguments for the new process.</param>
+  /// <param name="std_out">The standard output of the process.</param>
+  /// <param name="std_err">The standard error of the process.</param>
+  /// <param name="exit_code">The process exit code if the function is successful. Set to -1 if the process was terminated by a signal.</param>
+  /// <returns>Returns true if the process was executed and has exited. Returns false otherwise.</returns>
+  bool ExecuteAndCapture(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, std::string & std_out, std::string & std_err, int & exit_code);
+
+  /// <summary>
+  /// Wait for the given child process termination for a maximum amount of time and return the process exit code.
+  /// The process must be a child process of the current process for the function to be successful.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pid">The process id to wait for.</param>
+  /// <param name="exit_code">The process exit code if the function is successful. Set to -1 if the process was terminated by a signal.</param>
+  /// <param name="timeout_ms">The maximum time to wait in milliseconds. Use 0 to return immediately. Use -1 to wait indefinitely.</param>
+  /// <returns>Returns true if the process has terminated. Returns false if the timeout has expired or on error.</returns>
+  bool WaitExit(const processid_t & pid, int & exit_code, int timeout_ms);
+
+  /// <summary>
+  /// Wait for the termination of any of the given child processes for a maximum amount of time.
+  /// The terminated process is reaped. The other processes are left untouched.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pids">The list of process ids to wait for.</param>
+  /// <param name="timeout_ms">The maximum time to wait in milliseconds. Use 0 to return immediately. Use -1 to wait indefinitely.</param>
+  /// <param name="pid">The process id of the terminated process if the function is successful.</param>
+  /// <param name="exit_code">The exit code of the terminated process. Set to -1 if the process was terminated by a signal or is not a child process.</param>
+  /// <returns>Returns true if a process has terminated. Returns false if the timeout has expired or on error.</returns>
+  bool WaitAny(const ProcessIdList & pids, int timeout_ms, processid_t & pid, int & exit_code);
+
+  /// <summary>
+  /// Terminate gracefully an existing process using the process id.
+  /// The process is killed if it is still running after the given timeout.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pid">The process id of the target process to Terminate.</param>
+  /// <param name="timeout_ms">The maximum time in milliseconds allowed to the process to exit gracefully.</param>
+  /// <returns>Returns true if the process was successfully terminated. Returns false otherwise.</returns>
+  bool Terminate(const processid_t & pid, int timeout_ms);
+
+  /// <summary>
+  /// Terminate gracefully all processes of a process group.
+  /// The remaining processes of the group are killed after the given timeout.
+  /// The group leader is reaped if it is a child process of the current process.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pgid">The process group id. This is the process id of a process started with SpawnOptions::new_process_group.</param>
+  /// <param name="timeout_ms">The maximum time in milliseconds allowed to the processes to exit gracefully.</param>
+  /// <returns>Returns true if all processes of the group have terminated. Returns false if the group does not exist or if processes of the group are still running after being killed.</returns>
+  bool TerminateGroup(const processid_t & pgid, int timeout_ms);
+
+  /// <summary>
+  /// Kill all processes of a process group.
+  /// The group leader is reaped if it is a child process of the current process.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="pgid">The process group id. This is the process id of a process started with SpawnOptions::new_process_group.</param>
+  /// <returns>Returns true if the process group was successfully killed. Returns false otherwise.</returns>
+  bool KillGroup(const processid_t & pgid);
 #endif
 
   /// <summary>
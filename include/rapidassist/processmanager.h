@@ -0,0 +1,238 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PROCESSMANAGER_H
+#define RA_PROCESSMANAGER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+#include "rapidassist/strings.h"
+
+#ifndef _WIN32
+
+#include <poll.h>
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines the result of a process which was reaped by a ProcessManager.
+  /// </summary>
+  struct ProcessResult {
+    /// <summary>The process id of the terminated process.</summary>
+    processid_t pid;
+    /// <summary>The exit code of the process. Set to -1 if the process was terminated by a signal.</summary>
+    int exit_code;
+    /// <summary>The signal that terminated the process. Set to 0 if the process exited normally.</summary>
+    int term_signal;
+    /// <summary>The elapsed time in seconds between the process launch and its termination.</summary>
+    double runtime;
+    /// <summary>The CPU time in seconds spent by the process in user mode.</summary>
+    double user_time;
+    /// <summary>The CPU time in seconds spent by the process in kernel mode.</summary>
+    double system_time;
+    /// <summary>The maximum resident set size of the process (in kilobytes on linux, in bytes on macOS).</summary>
+    long max_rss;
+  };
+
+  struct ProcessState;
+
+  /// <summary>
+  /// A reference to a child process launched or added to a ProcessManager.
+  /// The result of the process remains available through the handle after the process is reaped,
+  /// even if its process id is recycled by the system.
+  /// Note: handles are not thread safe and must be used from the thread that owns the ProcessManager.
+  /// </summary>
+  class ProcessHandle {
+  public:
+    /// <summary>
+    /// Create an invalid handle.
+    /// </summary>
+    ProcessHandle();
+    ProcessHandle(const ProcessHandle & other);
+    ProcessHandle & operator=(const ProcessHandle & other);
+    virtual ~ProcessHandle();
+
+    /// <summary>
+    /// Returns true if the handle refers to a process.
+    /// </summary>
+    bool IsValid() const;
+
+    /// <summary>
+    /// Get the process id of the process.
+    /// </summary>
+    /// <returns>Returns the process id of the process. Returns INVALID_PROCESS_ID if the handle is invalid.</returns>
+    processid_t GetProcessId() const;
+
+    /// <summary>
+    /// Returns true if the process has terminated and was reaped.
+    /// </summary>
+    bool IsCompleted() const;
+
+    /// <summary>
+    /// Get the result of the process.
+    /// The result is only valid once the process is completed.
+    /// </summary>
+    /// <returns>Returns the result of the process.</returns>
+    const ProcessResult & GetResult() const;
+
+  private:
+    friend class ProcessManager;
+    ProcessHandle(ProcessState * state);
+
+  private:
+    ProcessState * state_;
+  };
+
+  /// <summary>
+  /// ProcessManager callback interface.
+  /// </summary>
+  class IProcessListener {
+  public:
+    /// <summary>
+    /// ProcessManager callback function. Called once for each process that terminates.
+    /// </summary>
+    /// <param name="result">The result of the terminated process.</param>
+    virtual void OnProcessExit(const ProcessResult & result) = 0;
+  };
+
+  /// <summary>
+  /// Launch many child processes concurrently and reap them from a single thread.
+  /// Each process is identified by a ProcessHandle which holds its result once reaped.
+  /// On linux, each child process is monitored with a process file descriptor (pidfd)
+  /// and all of them are waited for with a single call to poll().
+  /// Note: this api is only available on linux and macOS.
+  /// </summary>
+  class ProcessManager {
+  public:
+    /// <summary>
+    /// Ctor for the ProcessManager class.
+    /// </summary>
+    ProcessManager();
+
+    /// <summary>
+    /// Dtor for the ProcessManager class.
+    /// Processes that are still running are not waited for. Call WaitAll() to reap all processes.
+    /// </summary>
+    virtual ~ProcessManager();
+
+    /// <summary>
+    /// Set the listener that is notified when a process terminates.
+    /// </summary>
+    /// <param name="listener">A valid IProcessListener pointer or NULL to disable notifications.</param>
+    virtual void SetListener(IProcessListener * listener);
+
+    /// <summary>
+    /// Start the given process with the given arguments from the given directory.
+    /// </summary>
+    /// <param name="exec_path">The path to the executable to start.</param>
+    /// <param name="default_directory">The directory to run the command from.</param>
+    /// <param name="arguments">The list of arguments for the new process.</param>
+    /// <returns>Returns a valid handle to the new process when successful. Returns an invalid handle otherwise.</returns>
+    virtual ProcessHandle Start(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments);
+
+    /// <summary>
+    /// Add an existing child process to the list of processes managed by this instance.
+    /// </summary>
+    /// <param name="pid">The process id of a child process of the current process.</param>
+    /// <returns>Returns a valid handle to the process when successful. Returns an invalid handle otherwise.</returns>
+    virtual ProcessHandle Add(const processid_t & pid);
+
+    /// <summary>
+    /// Get the number of managed processes that are still running.
+    /// </summary>
+    /// <returns>Returns the number of managed processes that are still running.</returns>
+    virtual size_t GetRunningCount() const;
+
+    /// <summary>
+    /// Get the list of managed processes that are still running.
+    /// </summary>
+    /// <returns>Returns the list of managed processes that are still running.</returns>
+    virtual ProcessIdList GetRunningProcesses() const;
+
+    /// <summary>
+    /// Wait for at least one managed process to terminate and reap all terminated processes.
+    /// </summary>
+    /// <param name="timeout_ms">The maximum time to wait in milliseconds. Use 0 to return immediately. Use -1 to wait indefinitely.</param>
+    /// <returns>Returns the number of processes that were reaped.</returns>
+    virtual size_t Poll(int timeout_ms);
+
+    /// <summary>
+    /// Wait for the given process to terminate.
+    /// </summary>
+    /// <param name="handle">The handle of the process to wait for.</param>
+    /// <param name="result">The result of the terminated process.</param>
+    /// <returns>Returns true if the process has terminated. Returns false if the process is running but not managed by this instance.</returns>
+    virtual bool Wait(const ProcessHandle & handle, ProcessResult & result);
+
+    /// <summary>
+    /// Wait for all managed processes to terminate.
+    /// </summary>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool WaitAll();
+
+  private:
+    /// <summary>
+    /// Reap the managed processes that are terminated without blocking.
+    /// Only the processes signaled by the last call to poll() and the processes without a pidfd are checked.
+    /// </summary>
+    /// <param name="check_all">Check all managed processes regardless of the result of poll().</param>
+    /// <returns>Returns the number of processes that were reaped.</returns>
+    size_t Reap(bool check_all);
+
+    /// <summary>
+    /// Reap the managed process at the given index if it is terminated.
+    /// </summary>
+    /// <param name="index">The index of the process in the list of running processes.</param>
+    /// <returns>Returns true if the process was reaped. Returns false otherwise.</returns>
+    bool TryReap(size_t index);
+
+    /// <summary>
+    /// Remove the managed process at the given index by moving the last process in its place.
+    /// </summary>
+    /// <param name="index">The index of the process in the list of running processes.</param>
+    void Remove(size_t index);
+
+  private:
+    struct ProcessEntry {
+      ProcessState * state;
+      uint64_t start_time; //in microseconds
+    };
+    typedef std::vector<ProcessEntry> ProcessEntryList;
+    typedef std::vector<struct pollfd> PollFdList;
+    ProcessEntryList running_;
+    PollFdList fds_; //the pidfd of each running process, in the same order as running_. Set to -1 if not available.
+    size_t num_without_pidfd_;
+    IProcessListener * listener_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
+
+#endif //RA_PROCESSMANAGER_H
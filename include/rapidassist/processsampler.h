@@ -0,0 +1,180 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PROCESSSAMPLER_H
+#define RA_PROCESSSAMPLER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+
+#ifdef __linux__
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines the resource usage of a process at a given time.
+  /// </summary>
+  struct ProcessSample {
+    /// <summary>The process id.</summary>
+    processid_t pid;
+    /// <summary>The time of the sample in seconds. See ra::timing::GetMicrosecondsTimer().</summary>
+    double timestamp;
+    /// <summary>The CPU time in seconds spent by the process in user mode.</summary>
+    double user_time;
+    /// <summary>The CPU time in seconds spent by the process in kernel mode.</summary>
+    double system_time;
+    /// <summary>The resident set size of the process in bytes.</summary>
+    uint64_t rss;
+    /// <summary>The number of voluntary context switches of the process.</summary>
+    uint64_t voluntary_ctxt_switches;
+    /// <summary>The number of involuntary context switches of the process.</summary>
+    uint64_t nonvoluntary_ctxt_switches;
+    /// <summary>The number of bytes read by the process with read() like system calls. Set to 0 if not available.</summary>
+    uint64_t read_chars;
+    /// <summary>The number of bytes written by the process with write() like system calls. Set to 0 if not available.</summary>
+    uint64_t write_chars;
+    /// <summary>The number of bytes read by the process from the storage layer. Set to 0 if not available.</summary>
+    uint64_t read_bytes;
+    /// <summary>The number of bytes written by the process to the storage layer. Set to 0 if not available.</summary>
+    uint64_t write_bytes;
+  };
+
+  /// <summary>Defines a list of ProcessSample.</summary>
+  typedef std::vector<ProcessSample> ProcessSampleList;
+
+  /// <summary>
+  /// Record the resource usage of a set of processes at a fixed interval.
+  /// The files '/proc/[pid]/stat', '/proc/[pid]/status' and '/proc/[pid]/io' of each process
+  /// are opened once and read again with pread() for each sample.
+  /// Samples are stored in a preallocated ring buffer. When the buffer is full, the oldest samples are overwritten.
+  /// A process is removed from the sampler when it terminates.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  class ProcessSampler {
+  public:
+    /// <summary>
+    /// Create a sampler.
+    /// </summary>
+    /// <param name="capacity">The maximum number of samples kept by the sampler.</param>
+    ProcessSampler(size_t capacity = 4096);
+    virtual ~ProcessSampler();
+
+    /// <summary>
+    /// Add a process to the sampler.
+    /// </summary>
+    /// <param name="pid">The process id to sample.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    bool Add(const processid_t & pid);
+
+    /// <summary>
+    /// Remove a process from the sampler.
+    /// </summary>
+    /// <param name="pid">The process id to remove.</param>
+    /// <returns>Returns true if the function is successful. Returns false if the process is not sampled.</returns>
+    bool Remove(const processid_t & pid);
+
+    /// <summary>
+    /// Get the number of processes sampled by the sampler.
+    /// </summary>
+    /// <returns>Returns the number of processes sampled by the sampler.</returns>
+    size_t GetProcessCount() const;
+
+    /// <summary>
+    /// Record a sample for each process of the sampler.
+    /// Processes that have terminated are removed from the sampler.
+    /// A last sample is recorded for terminated processes that are not reaped yet (zombie).
+    /// </summary>
+    /// <returns>Returns the number of recorded samples.</returns>
+    size_t Sample();
+
+    /// <summary>
+    /// Record samples at a fixed interval until all processes of the sampler have terminated.
+    /// </summary>
+    /// <param name="interval_ms">The interval between samples in milliseconds.</param>
+    void Run(uint32_t interval_ms);
+
+    /// <summary>
+    /// Get the maximum number of samples kept by the sampler.
+    /// </summary>
+    /// <returns>Returns the maximum number of samples kept by the sampler.</returns>
+    size_t GetCapacity() const;
+
+    /// <summary>
+    /// Get the number of samples in the sampler.
+    /// </summary>
+    /// <returns>Returns the number of samples in the sampler.</returns>
+    size_t GetSampleCount() const;
+
+    /// <summary>
+    /// Get the samples of the sampler, from the oldest to the most recent.
+    /// </summary>
+    /// <param name="samples">The output list of samples.</param>
+    void GetSamples(ProcessSampleList & samples) const;
+
+    /// <summary>
+    /// Delete all samples from the sampler.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Save the samples of the sampler to a comma-separated values (CSV) file.
+    /// The first line of the file contains the name of each column.
+    /// </summary>
+    /// <param name="path">The path of the output file.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    bool Dump(const std::string & path) const;
+
+  private:
+    struct SampledProcess {
+      processid_t pid;
+      int stat_fd;
+      int status_fd;
+      int io_fd;
+    };
+    typedef std::vector<SampledProcess> SampledProcessList;
+
+    bool Read(const SampledProcess & process, ProcessSample & sample, bool & terminated);
+    void Push(const ProcessSample & sample);
+    void Close(SampledProcess & process);
+
+  private:
+    long clock_ticks_;
+    long page_size_;
+    SampledProcessList processes_;
+    ProcessSampleList samples_;
+    size_t first_; //index of the oldest sample
+    size_t count_;
+    std::vector<char> buffer_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //__linux__
+
+#endif //RA_PROCESSSAMPLER_H
@@ -0,0 +1,111 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_PROCESSSNAPSHOT_H
+#define RA_PROCESSSNAPSHOT_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+
+#ifdef __linux__
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Defines the statistics of a process at the time of a ProcessSnapshot.
+  /// </summary>
+  struct ProcessInfo {
+    /// <summary>The process id.</summary>
+    processid_t pid;
+    /// <summary>The process id of the parent process.</summary>
+    processid_t ppid;
+    /// <summary>The process state. One of 'R', 'S', 'D', 'Z', 'T', 't', 'X', 'I'. See proc(5) for details.</summary>
+    char state;
+    /// <summary>The name of the process executable, truncated to 15 characters by the kernel.</summary>
+    std::string name;
+    /// <summary>The number of threads of the process.</summary>
+    long num_threads;
+    /// <summary>The CPU time in seconds spent by the process in user mode.</summary>
+    double user_time;
+    /// <summary>The CPU time in seconds spent by the process in kernel mode.</summary>
+    double system_time;
+    /// <summary>The resident set size of the process in bytes.</summary>
+    uint64_t rss;
+  };
+
+  /// <summary>Defines a list of ProcessInfo.</summary>
+  typedef std::vector<ProcessInfo> ProcessInfoList;
+
+  /// <summary>
+  /// Capture the statistics of all processes of the system in a single pass over '/proc'.
+  /// Process ids are read from the directory entries of '/proc' with getdents64()
+  /// and each process statistics are parsed from a single read of '/proc/[pid]/stat'.
+  /// The '/proc' file descriptor and the buffers are reused between calls to Update()
+  /// which allows polling a system with thousands of processes at a high frequency.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  class ProcessSnapshot {
+  public:
+    ProcessSnapshot();
+    virtual ~ProcessSnapshot();
+
+    /// <summary>
+    /// Capture the statistics of all processes of the system.
+    /// Processes that terminate during the capture are skipped.
+    /// </summary>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    bool Update();
+
+    /// <summary>
+    /// Get the processes of the last captured snapshot, sorted by process id.
+    /// </summary>
+    /// <returns>Returns the processes of the last captured snapshot.</returns>
+    const ProcessInfoList & GetProcesses() const;
+
+    /// <summary>
+    /// Find the statistics of the given process id in the last captured snapshot.
+    /// </summary>
+    /// <param name="pid">The process id to search for.</param>
+    /// <returns>Returns a pointer to the statistics of the process. Returns NULL if the process is not found.</returns>
+    const ProcessInfo * Find(const processid_t & pid) const;
+
+  private:
+    int proc_fd_;
+    long clock_ticks_;
+    long page_size_;
+    std::vector<char> dirent_buffer_;
+    ProcessIdList pids_;
+    ProcessInfoList processes_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //__linux__
+
+#endif //RA_PROCESSSNAPSHOT_H
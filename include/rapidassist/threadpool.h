@@ -0,0 +1,191 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_THREADPOOL_H
+#define RA_THREADPOOL_H
+
+#include <stddef.h>
+
+#include "rapidassist/config.h"
+
+namespace ra { namespace threading {
+
+  class ThreadPool;
+
+  /// <summary>
+  /// A non-recursive mutex.
+  /// </summary>
+  class Mutex {
+  public:
+    Mutex();
+    ~Mutex();
+
+    /// <summary>
+    /// Lock the mutex. Blocks until the mutex is available.
+    /// </summary>
+    void Lock();
+
+    /// <summary>
+    /// Unlock the mutex. The mutex must be locked by the calling thread.
+    /// </summary>
+    void Unlock();
+
+  private:
+    Mutex(const Mutex &); //not copyable
+    Mutex & operator=(const Mutex &);
+
+  private:
+    friend class ConditionVariable;
+    struct Impl;
+    Impl * impl_;
+  };
+
+  /// <summary>
+  /// A condition variable associated with a Mutex.
+  /// </summary>
+  class ConditionVariable {
+  public:
+    ConditionVariable();
+    ~ConditionVariable();
+
+    /// <summary>
+    /// Unlock the mutex, wait for a notification and lock the mutex again. The mutex must be locked by the calling thread.
+    /// Spurious wakeups may occur. The waited condition must be checked again in a loop.
+    /// </summary>
+    /// <param name="mutex">The mutex that protects the waited condition.</param>
+    void Wait(Mutex & mutex);
+
+    /// <summary>
+    /// Wake up one waiting thread.
+    /// </summary>
+    void NotifyOne();
+
+    /// <summary>
+    /// Wake up all waiting threads.
+    /// </summary>
+    void NotifyAll();
+
+  private:
+    ConditionVariable(const ConditionVariable &); //not copyable
+    ConditionVariable & operator=(const ConditionVariable &);
+
+  private:
+    struct Impl;
+    Impl * impl_;
+  };
+
+  /// <summary>
+  /// Lock a mutex for the lifetime of the instance.
+  /// </summary>
+  class ScopedLock {
+  public:
+    ScopedLock(Mutex & mutex) : mutex_(mutex) { mutex_.Lock(); }
+    ~ScopedLock() { mutex_.Unlock(); }
+
+  private:
+    Mutex & mutex_;
+  };
+
+  /// <summary>
+  /// A unit of work executed by a ThreadPool.
+  /// </summary>
+  class ITask {
+  public:
+    virtual ~ITask() {}
+
+    /// <summary>
+    /// Execute the task.
+    /// </summary>
+    /// <param name="pool">The pool that executes the task. New tasks can be submitted to the pool from this function.</param>
+    /// <param name="worker_index">The index of the worker thread that executes the task. The value is lower than ThreadPool::GetThreadCount().</param>
+    virtual void Run(ThreadPool & pool, size_t worker_index) = 0;
+  };
+
+  /// <summary>
+  /// Get the number of processors available to the current process.
+  /// </summary>
+  /// <returns>Returns the number of processors available to the current process. Returns 1 on error.</returns>
+  size_t GetProcessorCount();
+
+  /// <summary>
+  /// A fixed-size pool of worker threads with work stealing.
+  /// Each worker owns a queue of tasks. A worker executes the most recent task of its own queue first
+  /// and steals the oldest task of another worker's queue when its own queue is empty.
+  /// Tasks submitted from a running task are queued to the worker that runs the submitting task
+  /// which keeps related work on the same thread.
+  /// </summary>
+  class ThreadPool {
+  public:
+    /// <summary>
+    /// Create a pool and start its worker threads.
+    /// </summary>
+    /// <param name="num_threads">The number of worker threads. Use 0 for the number of processors.</param>
+    ThreadPool(size_t num_threads);
+
+    /// <summary>
+    /// Wait for all tasks to complete and stop the worker threads.
+    /// </summary>
+    virtual ~ThreadPool();
+
+    /// <summary>
+    /// Get the number of worker threads of the pool.
+    /// </summary>
+    /// <returns>Returns the number of worker threads of the pool.</returns>
+    size_t GetThreadCount() const;
+
+    /// <summary>
+    /// Submit a task to the pool. The pool takes ownership of the task and deletes it after its execution.
+    /// </summary>
+    /// <param name="task">The task to execute.</param>
+    void Submit(ITask * task);
+
+    /// <summary>
+    /// Submit a task to the queue of the given worker. The pool takes ownership of the task and deletes it after its execution.
+    /// This function is usually called from ITask::Run() with the worker index of the running task.
+    /// </summary>
+    /// <param name="task">The task to execute.</param>
+    /// <param name="worker_index">The index of the worker thread which queue receives the task.</param>
+    void Submit(ITask * task, size_t worker_index);
+
+    /// <summary>
+    /// Wait for all submitted tasks to complete, including the tasks submitted by running tasks.
+    /// This function must not be called from a worker thread.
+    /// </summary>
+    void Wait();
+
+  private:
+    friend class WorkerThread;
+    struct WorkerContext;
+    void WorkerLoop(size_t worker_index);
+    ITask * PopTask(size_t worker_index);
+
+  private:
+    struct Impl;
+    Impl * impl_;
+  };
+
+} //namespace threading
+} //namespace ra
+
+#endif //RA_THREADPOOL_H
@@ -0,0 +1,140 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#ifndef RA_ZYGOTE_H
+#define RA_ZYGOTE_H
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <set>
+
+#include "rapidassist/config.h"
+#include "rapidassist/process.h"
+#include "rapidassist/strings.h"
+
+#ifndef _WIN32
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Run the fork server loop if the current process was started by Zygote::Start().
+  /// This function must be called at the beginning of the main() function of the helper executable, before any threads are created.
+  /// When the current process is not a zygote, the function returns false immediately.
+  /// When the current process is a zygote, the function only returns in the forked children: it returns true and
+  /// the argc and argv arguments are replaced by the arguments requested with Zygote::Spawn().
+  /// The zygote process exits when the Zygote instance that started it is stopped.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  /// <param name="argc">The argc argument of the main() function.</param>
+  /// <param name="argv">The argv argument of the main() function.</param>
+  /// <returns>Returns true in a forked child process. Returns false if the current process is not a zygote.</returns>
+  bool RunZygote(int & argc, char ** & argv);
+
+  /// <summary>
+  /// Launch the same helper executable many times with a low latency.
+  /// The helper executable is started once (the zygote) and stays resident. Each call to Spawn() asks
+  /// the zygote to fork a pre-initialized child process over a local socket which avoids
+  /// the cost of exec() and dynamic linking for each new process.
+  /// The helper executable must call RunZygote() at the beginning of its main() function.
+  /// The forked children are children of the zygote and not of the current process. Use WaitExit() of this class
+  /// instead of ra::process::WaitExit() to get their exit code.
+  /// Note: this api is only available on linux.
+  /// </summary>
+  class Zygote {
+  public:
+    /// <summary>
+    /// Ctor for the Zygote class.
+    /// </summary>
+    Zygote();
+
+    /// <summary>
+    /// Dtor for the Zygote class. Stops the zygote process.
+    /// </summary>
+    virtual ~Zygote();
+
+    /// <summary>
+    /// Start the zygote process.
+    /// The standard input of the zygote is used for communicating with the current process.
+    /// </summary>
+    /// <param name="exec_path">The path to the helper executable to start.</param>
+    /// <param name="default_directory">The directory to run the zygote from.</param>
+    /// <returns>Returns true if the zygote is started. Returns false otherwise.</returns>
+    virtual bool Start(const std::string & exec_path, const std::string & default_directory);
+
+    /// <summary>
+    /// Stop the zygote process. Children that are still running are not terminated.
+    /// </summary>
+    /// <returns>Returns true if the zygote was stopped. Returns false otherwise.</returns>
+    virtual bool Stop();
+
+    /// <summary>
+    /// Verify if the zygote is started.
+    /// </summary>
+    /// <returns>Returns true if the zygote is started. Returns false otherwise.</returns>
+    virtual bool IsStarted() const;
+
+    /// <summary>
+    /// Get the process id of the zygote process.
+    /// </summary>
+    /// <returns>Returns the process id of the zygote process. Returns INVALID_PROCESS_ID if the zygote is not started.</returns>
+    virtual processid_t GetZygoteProcessId() const;
+
+    /// <summary>
+    /// Fork a new child process from the zygote with the given arguments.
+    /// The standard input of the new process is redirected to /dev/null.
+    /// </summary>
+    /// <param name="default_directory">The directory to run the child process from.</param>
+    /// <param name="arguments">The list of arguments for the new process.</param>
+    /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
+    virtual processid_t Spawn(const std::string & default_directory, const ra::strings::StringVector & arguments);
+
+    /// <summary>
+    /// Wait for the given child process termination and return the process exit code.
+    /// </summary>
+    /// <param name="pid">The process id returned by Spawn().</param>
+    /// <param name="exit_code">The process exit code if the function is successful. Set to -1 if the process was terminated by a signal.</param>
+    /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+    virtual bool WaitExit(const processid_t & pid, int & exit_code);
+
+  private:
+    bool SendMessage(uint32_t type, const std::string & payload);
+    bool ReadMessage(uint32_t & type, std::string & payload);
+    bool ProcessExitMessage(const std::string & payload);
+
+  private:
+    typedef std::set<processid_t> ProcessIdSet;
+    typedef std::map<processid_t, int> ProcessStatusMap;
+    int socket_;
+    processid_t zygote_pid_;
+    ProcessIdSet running_;
+    ProcessStatusMap exit_statuses_;
+  };
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
+
+#endif //RA_ZYGOTE_H
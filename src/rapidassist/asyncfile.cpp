@@ -0,0 +1,634 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/asyncfile.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/threadpool.h"
+
+#include <string.h> //for memset()
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#if defined(__linux__) && defined(IORING_FEAT_RW_CUR_POS)
+#define RA_HAVE_IO_URING //IORING_OP_READ and IORING_OP_WRITE are available since linux 5.6
+#include <sys/syscall.h> //for syscall()
+#include <sys/mman.h>    //for mmap()
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>       //for open()
+#include <unistd.h>      //for close()
+#include <sched.h>       //for sched_yield()
+#include <errno.h>
+#endif
+
+namespace ra { namespace filesystem {
+
+  enum AsyncOperationType {
+    ASYNC_READ,
+    ASYNC_WRITE,
+    ASYNC_COPY,
+  };
+
+  struct AsyncOperation {
+    AsyncOperation(AsyncOperationType type, const std::string & path) :
+      type(type),
+      path(path),
+      fd(-1),
+      offset(0),
+      references(0),
+      completed(false),
+      success(false)
+    {
+    }
+
+    AsyncOperationType type;
+    std::string path;
+    std::string destination_path; //for copies
+    std::string data; //the content of the file that is read or written
+    int fd; //the file descriptor used by io_uring
+    size_t offset; //number of bytes read or written with io_uring
+
+    ra::threading::Mutex mutex; //protects the members below
+    ra::threading::ConditionVariable completed_condition;
+    size_t references;
+    bool completed;
+    bool success;
+  };
+
+  void AddReference(AsyncOperation * operation) {
+    ra::threading::ScopedLock lock(operation->mutex);
+    operation->references++;
+  }
+
+  void ReleaseReference(AsyncOperation * operation) {
+    bool destroy = false;
+    {
+      ra::threading::ScopedLock lock(operation->mutex);
+      operation->references--;
+      destroy = (operation->references == 0);
+    }
+    if (destroy)
+      delete operation;
+  }
+
+  void CompleteOperation(AsyncOperation * operation, bool success) {
+    if (operation->type == ASYNC_WRITE)
+      std::string().swap(operation->data); //release the copy of the written data
+
+    ra::threading::ScopedLock lock(operation->mutex);
+    operation->success = success;
+    operation->completed = true;
+    operation->completed_condition.NotifyAll();
+  }
+
+  ///=========================================================================================
+  ///                                 AsyncHandle
+  ///=========================================================================================
+
+  AsyncHandle::AsyncHandle() :
+    operation_(NULL)
+  {
+  }
+
+  AsyncHandle::AsyncHandle(AsyncOperation * operation) :
+    operation_(operation)
+  {
+    if (operation_)
+      AddReference(operation_);
+  }
+
+  AsyncHandle::AsyncHandle(const AsyncHandle & other) :
+    operation_(other.operation_)
+  {
+    if (operation_)
+      AddReference(operation_);
+  }
+
+  AsyncHandle & AsyncHandle::operator=(const AsyncHandle & other) {
+    if (other.operation_)
+      AddReference(other.operation_);
+    if (operation_)
+      ReleaseReference(operation_);
+    operation_ = other.operation_;
+    return *this;
+  }
+
+  AsyncHandle::~AsyncHandle() {
+    if (operation_)
+      ReleaseReference(operation_);
+  }
+
+  bool AsyncHandle::IsValid() const {
+    return operation_ != NULL;
+  }
+
+  bool AsyncHandle::IsCompleted() const {
+    if (!operation_)
+      return false;
+    ra::threading::ScopedLock lock(operation_->mutex);
+    return operation_->completed;
+  }
+
+  bool AsyncHandle::Wait() const {
+    if (!operation_)
+      return false;
+    ra::threading::ScopedLock lock(operation_->mutex);
+    while (!operation_->completed) {
+      operation_->completed_condition.Wait(operation_->mutex);
+    }
+    return operation_->success;
+  }
+
+  bool AsyncHandle::IsSuccess() const {
+    if (!operation_)
+      return false;
+    ra::threading::ScopedLock lock(operation_->mutex);
+    return operation_->completed && operation_->success;
+  }
+
+  const std::string & AsyncHandle::GetData() const {
+    static const std::string EMPTY;
+    if (!operation_ || operation_->type != ASYNC_READ)
+      return EMPTY;
+    return operation_->data;
+  }
+
+  ///=========================================================================================
+  ///                                 Thread pool backend
+  ///=========================================================================================
+
+  //executes an operation with the blocking functions of ra::filesystem
+  class AsyncTask : public ra::threading::ITask {
+  public:
+    AsyncTask(AsyncOperation * operation) :
+      operation_(operation)
+    {
+      AddReference(operation_);
+    }
+
+    virtual ~AsyncTask() {
+      ReleaseReference(operation_);
+    }
+
+    virtual void Run(ra::threading::ThreadPool & /*pool*/, size_t /*worker_index*/) {
+      bool success = false;
+      switch (operation_->type) {
+      case ASYNC_READ:
+        success = ReadFile(operation_->path, operation_->data);
+        break;
+      case ASYNC_WRITE:
+        success = WriteFile(operation_->path, operation_->data);
+        break;
+      case ASYNC_COPY:
+        success = CopyFile(operation_->path, operation_->destination_path);
+        break;
+      }
+      CompleteOperation(operation_, success);
+    }
+
+  private:
+    AsyncOperation * operation_;
+  };
+
+  ///=========================================================================================
+  ///                                 io_uring backend
+  ///=========================================================================================
+
+#ifdef RA_HAVE_IO_URING
+  struct AsyncRing {
+    int fd;
+    size_t max_in_flight;
+    void * sq_ptr;
+    size_t sq_size;
+    void * cq_ptr;
+    size_t cq_size;
+    struct io_uring_sqe * sqes;
+    size_t sqes_size;
+    unsigned * sq_head;
+    unsigned * sq_tail;
+    unsigned * sq_mask;
+    unsigned * sq_array;
+    unsigned * cq_head;
+    unsigned * cq_tail;
+    unsigned * cq_mask;
+    struct io_uring_cqe * cqes;
+    ra::threading::ThreadPool * reaper; //a single thread that processes the completions
+
+    ra::threading::Mutex mutex; //protects the submission queue and the members below
+    ra::threading::ConditionVariable slot_available; //signaled when an operation completes
+    size_t in_flight;
+    bool stopping; //set when the reaper thread must exit
+  };
+
+  void DestroyRing(AsyncRing * ring) {
+    if (ring->sqes)
+      munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr)
+      munmap(ring->cq_ptr, ring->cq_size);
+    if (ring->sq_ptr)
+      munmap(ring->sq_ptr, ring->sq_size);
+    close(ring->fd);
+    delete ring;
+  }
+
+  //map the queues of a new io_uring instance. Returns NULL if io_uring is not supported.
+  AsyncRing * CreateRing(size_t queue_depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    unsigned entries = (unsigned)(queue_depth < 4096 ? queue_depth : 4096);
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0)
+      return NULL; //not supported by the kernel or disabled
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+      close(fd); //kernel older than 5.6
+      return NULL;
+    }
+
+    AsyncRing * ring = new AsyncRing();
+    ring->fd = fd;
+    ring->max_in_flight = (queue_depth < params.sq_entries ? queue_depth : params.sq_entries);
+    ring->in_flight = 0;
+    ring->stopping = false;
+    ring->reaper = NULL;
+    ring->sq_ptr = NULL;
+    ring->cq_ptr = NULL;
+    ring->sqes = NULL;
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      if (ring->cq_size > ring->sq_size)
+        ring->sq_size = ring->cq_size;
+      ring->cq_size = ring->sq_size;
+    }
+
+    void * sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+      DestroyRing(ring);
+      return NULL;
+    }
+    ring->sq_ptr = sq_ptr;
+
+    void * cq_ptr = sq_ptr;
+    if (!single_mmap)
+      cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ptr == MAP_FAILED) {
+      DestroyRing(ring);
+      return NULL;
+    }
+    ring->cq_ptr = cq_ptr;
+
+    void * sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      DestroyRing(ring);
+      return NULL;
+    }
+    ring->sqes = (struct io_uring_sqe *)sqes;
+
+    char * sq = (char *)sq_ptr;
+    char * cq = (char *)cq_ptr;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return ring;
+  }
+
+  //queue and submit the next read or write of an operation. A NULL operation submits a request that stops the reaper thread.
+  //The ring mutex must be locked by the calling thread.
+  //Returns false if the request could not be submitted. The request is then removed from the queue and no completion is received for it.
+  bool PushSubmission(AsyncRing * ring, AsyncOperation * operation) {
+    //1 GB per request since the length of a request is limited to 32 bits
+    static const size_t MAX_REQUEST_SIZE = 1024 * 1024 * 1024;
+
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe * sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    if (operation == NULL) {
+      sqe->opcode = IORING_OP_NOP;
+      sqe->user_data = 0;
+    }
+    else {
+      size_t size = operation->data.size() - operation->offset;
+      if (size > MAX_REQUEST_SIZE)
+        size = MAX_REQUEST_SIZE;
+      sqe->opcode = (operation->type == ASYNC_READ ? IORING_OP_READ : IORING_OP_WRITE);
+      sqe->fd = operation->fd;
+      sqe->off = operation->offset;
+      sqe->addr = (uint64_t)(uintptr_t)(&operation->data[0] + operation->offset);
+      sqe->len = (uint32_t)size;
+      sqe->user_data = (uint64_t)(uintptr_t)operation;
+    }
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    while (true) {
+      int submitted = (int)syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+      if (submitted > 0)
+        return true;
+      if (submitted < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        break;
+      sched_yield(); //the kernel is temporarily out of resources
+    }
+
+    //the request was not consumed by the kernel. Remove it from the queue.
+    if (__atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == tail) {
+      __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+      return false;
+    }
+    return true; //consumed by the kernel, its completion will be received
+  }
+
+  //complete an operation of the ring and release its slot.
+  void FinishRingOperation(AsyncRing * ring, AsyncOperation * operation, bool success) {
+    close(operation->fd);
+    operation->fd = -1;
+    if (operation->type == ASYNC_READ && !success)
+      operation->data.clear();
+    CompleteOperation(operation, success);
+    ReleaseReference(operation);
+
+    ra::threading::ScopedLock lock(ring->mutex);
+    ring->in_flight--;
+    ring->slot_available.NotifyAll();
+  }
+
+  //process the result of a read or write. Submits the remaining bytes or completes the operation.
+  void ProcessCompletion(AsyncRing * ring, AsyncOperation * operation, int result) {
+    bool completed = false;
+    bool success = false;
+    if (result == -EINTR || result == -EAGAIN) {
+      //retry
+    }
+    else if (result < 0) {
+      completed = true;
+    }
+    else if (result == 0) {
+      completed = true; //the file was truncated while reading or the disk is full
+    }
+    else {
+      operation->offset += (size_t)result;
+      if (operation->offset >= operation->data.size()) {
+        completed = true;
+        success = true;
+      }
+    }
+
+    if (!completed) {
+      //submit the remaining bytes
+      bool submitted = false;
+      {
+        ra::threading::ScopedLock lock(ring->mutex);
+        submitted = PushSubmission(ring, operation);
+      }
+      if (submitted)
+        return;
+    }
+
+    FinishRingOperation(ring, operation, success);
+  }
+
+  //waits for completions of the ring until the stop request is received
+  class AsyncRingReaper : public ra::threading::ITask {
+  public:
+    AsyncRingReaper(AsyncRing * ring) : ring_(ring) {}
+
+    virtual void Run(ra::threading::ThreadPool & /*pool*/, size_t /*worker_index*/) {
+      bool stop = false;
+      while (!stop) {
+        int result = (int)syscall(__NR_io_uring_enter, ring_->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (result < 0 && errno != EINTR) {
+          //the ring is unusable. Exit if the stop request could not be submitted either.
+          ra::threading::ScopedLock lock(ring_->mutex);
+          if (ring_->stopping)
+            stop = true;
+        }
+
+        unsigned head = *ring_->cq_head;
+        unsigned tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+          struct io_uring_cqe * cqe = &ring_->cqes[head & *ring_->cq_mask];
+          uint64_t user_data = cqe->user_data;
+          int result = cqe->res;
+          head++;
+          __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+
+          if (user_data == 0)
+            stop = true;
+          else
+            ProcessCompletion(ring_, (AsyncOperation *)(uintptr_t)user_data, result);
+        }
+      }
+    }
+
+  private:
+    AsyncRing * ring_;
+  };
+
+  //submit a new operation which file is opened. Blocks while the maximum number of operations are in flight.
+  void SubmitRingOperation(AsyncRing * ring, AsyncOperation * operation) {
+    AddReference(operation);
+    {
+      ra::threading::ScopedLock lock(ring->mutex);
+      while (ring->in_flight >= ring->max_in_flight) {
+        ring->slot_available.Wait(ring->mutex);
+      }
+      ring->in_flight++;
+      if (PushSubmission(ring, operation))
+        return;
+    }
+
+    //the operation will not receive a completion
+    FinishRingOperation(ring, operation, false);
+  }
+#else
+  struct AsyncRing {
+  };
+#endif //RA_HAVE_IO_URING
+
+  ///=========================================================================================
+  ///                                 AsyncFileQueue
+  ///=========================================================================================
+
+  const size_t AsyncFileQueue::DEFAULT_QUEUE_DEPTH = 64;
+
+  AsyncFileQueue::AsyncFileQueue() :
+    ring_(NULL),
+    pool_(NULL)
+  {
+    Init(DEFAULT_QUEUE_DEPTH, true);
+  }
+
+  AsyncFileQueue::AsyncFileQueue(size_t queue_depth, bool allow_io_uring) :
+    ring_(NULL),
+    pool_(NULL)
+  {
+    Init(queue_depth, allow_io_uring);
+  }
+
+  void AsyncFileQueue::Init(size_t queue_depth, bool allow_io_uring) {
+    //threads of the pool are mostly waiting for the storage device
+    static const size_t MAX_THREADS = 16;
+
+    if (queue_depth == 0)
+      queue_depth = DEFAULT_QUEUE_DEPTH;
+
+#ifdef RA_HAVE_IO_URING
+    if (allow_io_uring) {
+      ring_ = CreateRing(queue_depth);
+      if (ring_) {
+        ring_->reaper = new ra::threading::ThreadPool(1);
+        ring_->reaper->Submit(new AsyncRingReaper(ring_));
+      }
+    }
+#endif
+
+    //the pool executes all operations when io_uring is not available and copies otherwise
+    pool_ = new ra::threading::ThreadPool(queue_depth < MAX_THREADS ? queue_depth : MAX_THREADS);
+  }
+
+  AsyncFileQueue::~AsyncFileQueue() {
+    WaitAll();
+
+#ifdef RA_HAVE_IO_URING
+    if (ring_) {
+      //stop the reaper thread
+      {
+        ra::threading::ScopedLock lock(ring_->mutex);
+        ring_->stopping = true;
+        PushSubmission(ring_, NULL); //on failure, the reaper thread exits when its own wait fails
+      }
+      delete ring_->reaper;
+      DestroyRing(ring_);
+      ring_ = NULL;
+    }
+#endif
+
+    delete pool_;
+  }
+
+  bool AsyncFileQueue::IsUsingIoUring() const {
+    return ring_ != NULL;
+  }
+
+  AsyncHandle AsyncFileQueue::ReadFileAsync(const std::string & path) {
+    AsyncOperation * operation = new AsyncOperation(ASYNC_READ, path);
+    AsyncHandle handle(operation);
+
+#ifdef RA_HAVE_IO_URING
+    if (ring_) {
+      //open the file and allocate the buffer in the calling thread
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        CompleteOperation(operation, false);
+        return handle;
+      }
+      struct stat64 file_stat;
+      if (fstat64(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || (uint64_t)file_stat.st_size > (uint64_t)((size_t)-1)) {
+        close(fd);
+        CompleteOperation(operation, false);
+        return handle;
+      }
+      if (file_stat.st_size == 0) {
+        close(fd);
+        CompleteOperation(operation, true);
+        return handle;
+      }
+
+      operation->data.resize((size_t)file_stat.st_size);
+      operation->fd = fd;
+      SubmitRingOperation(ring_, operation);
+      return handle;
+    }
+#endif
+
+    return SubmitTask(operation);
+  }
+
+  AsyncHandle AsyncFileQueue::WriteFileAsync(const std::string & path, const std::string & data) {
+    AsyncOperation * operation = new AsyncOperation(ASYNC_WRITE, path);
+    operation->data = data;
+    AsyncHandle handle(operation);
+
+#ifdef RA_HAVE_IO_URING
+    if (ring_) {
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+      if (fd < 0) {
+        CompleteOperation(operation, false);
+        return handle;
+      }
+      if (data.empty()) {
+        close(fd);
+        CompleteOperation(operation, true);
+        return handle;
+      }
+
+      operation->fd = fd;
+      SubmitRingOperation(ring_, operation);
+      return handle;
+    }
+#endif
+
+    return SubmitTask(operation);
+  }
+
+  AsyncHandle AsyncFileQueue::CopyFileAsync(const std::string & source_path, const std::string & destination_path) {
+    AsyncOperation * operation = new AsyncOperation(ASYNC_COPY, source_path);
+    operation->destination_path = destination_path;
+    return SubmitTask(operation);
+  }
+
+  AsyncHandle AsyncFileQueue::SubmitTask(AsyncOperation * operation) {
+    AsyncHandle handle(operation);
+    pool_->Submit(new AsyncTask(operation));
+    return handle;
+  }
+
+  void AsyncFileQueue::WaitAll() {
+    pool_->Wait();
+
+#ifdef RA_HAVE_IO_URING
+    if (ring_) {
+      ra::threading::ScopedLock lock(ring_->mutex);
+      while (ring_->in_flight > 0) {
+        ring_->slot_available.Wait(ring_->mutex);
+      }
+    }
+#endif
+  }
+
+} //namespace filesystem
+} //namespace ra
@@ -0,0 +1,244 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/cpu.h"
+
+#ifdef __linux__
+
+#include "rapidassist/strings.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace ra { namespace cpu {
+
+  static const char * CPU_SYSFS_DIR = "/sys/devices/system/cpu";
+
+  /// <summary>
+  /// Read the first line of a sysfs file.
+  /// </summary>
+  /// <param name="path">The path of the file.</param>
+  /// <param name="value">The first line of the file without the new line character.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ReadSysfsValue(const std::string & path, std::string & value) {
+    FILE * f = fopen(path.c_str(), "r");
+    if (!f)
+      return false;
+    char buffer[4096];
+    char * line = fgets(buffer, sizeof(buffer), f);
+    fclose(f);
+    if (line == NULL)
+      return false;
+    value = ra::strings::TrimRight(buffer, '\n');
+    return true;
+  }
+
+  /// <summary>
+  /// Read an integer from a sysfs file.
+  /// </summary>
+  /// <param name="path">The path of the file.</param>
+  /// <param name="default_value">The value returned if the file cannot be read.</param>
+  /// <returns>Returns the integer value of the file. Returns default_value on error.</returns>
+  int ReadSysfsInt(const std::string & path, int default_value) {
+    std::string value;
+    int result = default_value;
+    if (!ReadSysfsValue(path, value) || !ra::strings::Parse(value, result))
+      return default_value;
+    return result;
+  }
+
+  /// <summary>
+  /// Convert a list of cpus to a cpu_set_t.
+  /// </summary>
+  /// <param name="cpus">The list of cpus.</param>
+  /// <param name="set">The output cpu set.</param>
+  /// <returns>Returns true if the function is successful. Returns false if the list is empty or contains invalid cpus.</returns>
+  bool ToCpuSet(const CpuList & cpus, cpu_set_t & set) {
+    CPU_ZERO(&set);
+    if (cpus.empty())
+      return false;
+    for (size_t i = 0; i < cpus.size(); i++) {
+      const int & cpu = cpus[i];
+      if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+      CPU_SET(cpu, &set);
+    }
+    return true;
+  }
+
+  /// <summary>
+  /// Convert a cpu_set_t to a list of cpus.
+  /// </summary>
+  /// <param name="set">The cpu set.</param>
+  /// <param name="cpus">The output list of cpus.</param>
+  void ToCpuList(const cpu_set_t & set, CpuList & cpus) {
+    cpus.clear();
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set))
+        cpus.push_back(cpu);
+    }
+  }
+
+  bool ParseCpuList(const std::string & value, CpuList & cpus) {
+    cpus.clear();
+
+    ra::strings::StringVector ranges;
+    ra::strings::Split(ranges, value, ",");
+    for (size_t i = 0; i < ranges.size(); i++) {
+      const std::string range = ra::strings::Trim(ranges[i]);
+      if (range.empty())
+        continue;
+
+      int first = 0;
+      int last = 0;
+      size_t dash = range.find('-');
+      if (dash == std::string::npos) {
+        if (!ra::strings::Parse(range, first))
+          return false;
+        last = first;
+      }
+      else {
+        if (!ra::strings::Parse(range.substr(0, dash), first))
+          return false;
+        if (!ra::strings::Parse(range.substr(dash + 1), last))
+          return false;
+      }
+      if (first < 0 || last < first)
+        return false;
+
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+  }
+
+  bool GetCpuTopology(CpuInfoList & cpus) {
+    cpus.clear();
+
+    const std::string cpu_dir = CPU_SYSFS_DIR;
+    std::string value;
+    CpuList possible;
+    if (!ReadSysfsValue(cpu_dir + "/possible", value) || !ParseCpuList(value, possible))
+      return false;
+    CpuList online;
+    if (!ReadSysfsValue(cpu_dir + "/online", value) || !ParseCpuList(value, online))
+      return false;
+
+    cpus.reserve(possible.size());
+    for (size_t i = 0; i < possible.size(); i++) {
+      const int cpu = possible[i];
+      const std::string topology_dir = cpu_dir + "/cpu" + ra::strings::ToString(cpu) + "/topology";
+
+      CpuInfo info;
+      info.cpu = cpu;
+      info.online = std::binary_search(online.begin(), online.end(), cpu);
+
+      //the topology of offline cpus is not available
+      info.core_id = ReadSysfsInt(topology_dir + "/core_id", -1);
+      info.package_id = ReadSysfsInt(topology_dir + "/physical_package_id", -1);
+      if (!ReadSysfsValue(topology_dir + "/thread_siblings_list", value) || !ParseCpuList(value, info.thread_siblings))
+        info.thread_siblings.clear();
+
+      cpus.push_back(info);
+    }
+
+    return true;
+  }
+
+  bool GetOnlineCpus(CpuList & cpus) {
+    std::string value;
+    const std::string path = std::string(CPU_SYSFS_DIR) + "/online";
+    bool success = ReadSysfsValue(path, value) && ParseCpuList(value, cpus);
+    return success;
+  }
+
+  bool GetCurrentThreadAffinity(CpuList & cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+      return false;
+    ToCpuList(set, cpus);
+    return true;
+  }
+
+  bool SetCurrentThreadAffinity(const CpuList & cpus) {
+    cpu_set_t set;
+    if (!ToCpuSet(cpus, set))
+      return false;
+    bool success = (sched_setaffinity(0, sizeof(set), &set) == 0);
+    return success;
+  }
+
+  bool GetProcessAffinity(const ra::process::processid_t & pid, CpuList & cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pid <= 0 || sched_getaffinity(pid, sizeof(set), &set) != 0)
+      return false;
+    ToCpuList(set, cpus);
+    return true;
+  }
+
+  bool SetProcessAffinity(const ra::process::processid_t & pid, const CpuList & cpus) {
+    cpu_set_t set;
+    if (pid <= 0 || !ToCpuSet(cpus, set))
+      return false;
+
+    //sched_setaffinity() applies to a single thread. Apply to all threads of the process.
+    const std::string task_dir = std::string("/proc/") + ra::strings::ToString(pid) + "/task";
+    DIR * dir = opendir(task_dir.c_str());
+    if (dir == NULL)
+      return false;
+
+    bool success = true;
+    size_t count = 0;
+    struct dirent * entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+      pid_t tid = 0;
+      if (entry->d_name[0] == '.' || !ra::strings::Parse(entry->d_name, tid))
+        continue;
+      if (sched_setaffinity(tid, sizeof(set), &set) != 0 && errno != ESRCH)
+        success = false;
+      count++;
+    }
+    closedir(dir);
+
+    if (count == 0)
+      success = false;
+    return success;
+  }
+
+} //namespace cpu
+} //namespace ra
+
+#endif //__linux__
@@ -29,10 +29,15 @@
 #include "rapidassist/process.h"
 #include "rapidassist/unicode.h"
 #include "rapidassist/macros.h"
+#include "rapidassist/threadpool.h"
+#include "rapidassist/pathtree.h"
+#include "rapidassist/linereader.h"
 
 #include <algorithm>  //for std::transform(), sort()
+#include <map>
 #include <string.h>   //for strdup()
 #include <stdlib.h>   //for realpath()
+#include <errno.h>    //for errno
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -44,6 +49,8 @@
 #define __chdir _chdir
 #define __rmdir _rmdir
 #include <direct.h> //for _chdir(), _getcwd()
+#include <io.h> //for _chmod()
+#include <sys/utime.h> //for _utime64()
 #include <shlwapi.h> // for PathIsDirectoryEmptyA()
 #pragma comment(lib, "Shlwapi.lib") //for PathIsDirectoryEmptyA()
 #include <Windows.h> //for GetShortPathName()
@@ -54,6 +61,7 @@
 #define __rmdir rmdir
 #include <unistd.h> //for getcwd()
 #include <dirent.h> //for opendir() and closedir()
+#include <fcntl.h> //for AT_FDCWD
 #endif
 
 // https://github.com/end2endzone/RapidAssist/issues/81
@@ -67,17 +75,22 @@
 
 #if defined(__linux__)
 #include <linux/limits.h> //for PATH_MAX
+#include <sys/ioctl.h> //for ioctl()
+#include <sys/sendfile.h> //for sendfile()
+#include <linux/fs.h> //for FICLONE
+#include <sys/sysmacros.h> //for makedev()
+#if defined(STATX_BASIC_STATS) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 28))
+#define RA_HAVE_STATX //statx() is available since glibc 2.28
+#endif
+#if (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define RA_HAVE_COPY_FILE_RANGE //copy_file_range() is available since glibc 2.27
+#endif
 #elif defined(__APPLE__)
 #include <limits.h> //for PATH_MAX
 #endif
 
 namespace ra { namespace filesystem {
 
-  struct greater {
-    template<class T>
-    bool operator()(T const &a, T const &b) const { return a > b; }
-  };
-
   void NormalizePath(std::string & path) {
     char separator = GetPathSeparator();
 
@@ -98,14 +111,9 @@ namespace ra { namespace filesystem {
   }
 
   uint32_t GetFileSize(const char * path) {
-    if (path == NULL || path[0] == '\0')
-      return 0;
-
-    struct stat sb;
-    if (stat(path, &sb) == 0) {
-      return sb.st_size;
-    }
-
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return (uint32_t)info.size;
     return 0;
   }
 
@@ -120,15 +128,83 @@ namespace ra { namespace filesystem {
   }
 
   uint64_t GetFileSize64(const char * path) {
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return info.size;
+    return 0;
+  }
+
+  DirectoryEntryType GetEntryType(uint32_t mode) {
+    switch (mode & S_IFMT) {
+    case S_IFREG: return ENTRY_FILE;
+    case S_IFDIR: return ENTRY_DIRECTORY;
+#ifndef _WIN32
+    case S_IFLNK: return ENTRY_SYMLINK;
+#endif
+    default: return ENTRY_OTHER;
+    };
+  }
+
+  bool GetFileInfo(const char * path, FileInfo & info) {
     if (path == NULL || path[0] == '\0')
-      return 0;
+      return false;
 
-    struct stat64 sb;
-    if (stat64(path, &sb) == 0) {
-      return sb.st_size;
+#ifdef RA_HAVE_STATX
+    //set when statx() is not supported by the kernel or blocked by a seccomp filter
+    static bool statx_unavailable = false;
+
+    struct statx sx;
+    const unsigned int mask = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME | STATX_BLOCKS | STATX_INO | STATX_NLINK;
+    int statx_result = -1;
+    if (!__atomic_load_n(&statx_unavailable, __ATOMIC_RELAXED)) {
+      statx_result = statx(AT_FDCWD, path, AT_STATX_SYNC_AS_STAT, mask, &sx);
+      if (statx_result != 0 && errno != ENOSYS && errno != EPERM)
+        return false;
+      if (statx_result != 0)
+        __atomic_store_n(&statx_unavailable, true, __ATOMIC_RELAXED);
     }
 
-    return 0;
+    //fallback to stat64() if the file system did not return all the requested fields
+    if (statx_result == 0 && (sx.stx_mask & mask) == mask) {
+      info.type = GetEntryType(sx.stx_mode);
+      info.size = sx.stx_size;
+      info.modified_time = sx.stx_mtime.tv_sec;
+      info.modified_time_nsec = sx.stx_mtime.tv_nsec;
+      info.mode = sx.stx_mode;
+      info.blocks = sx.stx_blocks;
+      info.device = makedev(sx.stx_dev_major, sx.stx_dev_minor); //same encoding as st_dev
+      info.inode = sx.stx_ino;
+      info.link_count = sx.stx_nlink;
+      return true;
+    }
+#endif
+
+    struct stat64 sb;
+    if (stat64(path, &sb) != 0)
+      return false;
+
+    info.type = GetEntryType(sb.st_mode);
+    info.size = sb.st_size;
+    info.modified_time = sb.st_mtime;
+#if defined(__linux__)
+    info.modified_time_nsec = (uint32_t)sb.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    info.modified_time_nsec = (uint32_t)sb.st_mtimespec.tv_nsec;
+#else
+    info.modified_time_nsec = 0;
+#endif
+    info.mode = sb.st_mode;
+#ifdef _WIN32
+    info.blocks = 0;
+    info.device = 0;
+    info.inode = 0;
+#else
+    info.blocks = sb.st_blocks;
+    info.device = sb.st_dev;
+    info.inode = sb.st_ino;
+#endif
+    info.link_count = sb.st_nlink;
+    return true;
   }
 
   std::string GetFilename(const char * path) {
@@ -158,39 +234,90 @@ namespace ra { namespace filesystem {
     return filename_without_extension;
   }
 
-  bool FileExists(const char * path) {
-    if (path == NULL || path[0] == '\0')
-      return false;
+  //queries the metadata of a range of paths for GetFileInfos()
+  void GetFileInfoRange(const ra::strings::StringVector & paths, std::vector<FileInfo> & infos, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      FileInfo & info = infos[i];
+      if (!GetFileInfo(paths[i].c_str(), info))
+        memset(&info, 0, sizeof(info)); //ENTRY_UNKNOWN
+    }
+  }
 
-    struct stat64 sb;
-    if (stat64(path, &sb) == 0) {
-      if ((sb.st_mode & S_IFREG) == S_IFREG)
-        return true;
+  class FileInfoTask : public ra::threading::ITask {
+  public:
+    FileInfoTask(const ra::strings::StringVector * paths, std::vector<FileInfo> * infos, size_t begin, size_t end) :
+      paths_(paths),
+      infos_(infos),
+      begin_(begin),
+      end_(end)
+    {
+    }
+
+    virtual void Run(ra::threading::ThreadPool & /*pool*/, size_t /*worker_index*/) {
+      GetFileInfoRange(*paths_, *infos_, begin_, end_);
+    }
+
+  private:
+    const ra::strings::StringVector * paths_;
+    std::vector<FileInfo> * infos_;
+    size_t begin_;
+    size_t end_;
+  };
+
+  size_t GetFileInfos(const ra::strings::StringVector & paths, std::vector<FileInfo> & infos, size_t num_threads) {
+    infos.resize(paths.size());
+    if (paths.empty())
+      return 0;
+
+    //small lists are not worth starting threads
+    static const size_t MIN_PATHS_PER_TASK = 16;
+    if (num_threads == 0)
+      num_threads = ra::threading::GetProcessorCount();
+    if (num_threads == 1 || paths.size() <= MIN_PATHS_PER_TASK) {
+      GetFileInfoRange(paths, infos, 0, paths.size());
+    }
+    else {
+      //split the list in more tasks than threads to balance the load between slow and fast paths
+      size_t task_size = paths.size() / (num_threads * 8);
+      if (task_size < MIN_PATHS_PER_TASK)
+        task_size = MIN_PATHS_PER_TASK;
+
+      ra::threading::ThreadPool pool(num_threads);
+      for (size_t begin = 0; begin < paths.size(); begin += task_size) {
+        size_t end = begin + task_size;
+        if (end > paths.size())
+          end = paths.size();
+        pool.Submit(new FileInfoTask(&paths, &infos, begin, end));
+      }
+      pool.Wait();
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < infos.size(); i++) {
+      if (infos[i].type != ENTRY_UNKNOWN)
+        count++;
     }
+    return count;
+  }
+
+  bool FileExists(const char * path) {
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return (info.type == ENTRY_FILE);
     return false;
   }
 
   bool HasFileReadAccess(const char * path) {
-    if (path == NULL || path[0] == '\0')
-      return false;
-
-    struct stat64 sb;
-    if (stat64(path, &sb) == 0) {
-      if ((sb.st_mode & S_IREAD) == S_IREAD)
-        return true;
-    }
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return ((info.mode & S_IREAD) == S_IREAD);
     return false;
   }
 
   bool HasFileWriteAccess(const char * path) {
-    if (path == NULL || path[0] == '\0')
-      return false;
-
-    struct stat64 sb;
-    if (stat64(path, &sb) == 0) {
-      if ((sb.st_mode & S_IWRITE) == S_IWRITE)
-        return true;
-    }
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return ((info.mode & S_IWRITE) == S_IWRITE);
     return false;
   }
 
@@ -337,6 +464,304 @@ namespace ra { namespace filesystem {
 #endif
   }
 
+  //shared state of a FindFilesParallel() search
+  struct ParallelSearch {
+    std::vector<ra::strings::StringVector> files; //one list per worker thread
+    bool root_found;
+  };
+
+  //scans a single directory for FindFilesParallel() and submits a new task for each subdirectory.
+  class FindFilesTask : public ra::threading::ITask {
+  public:
+    FindFilesTask(ParallelSearch * search, const std::string & path, int depth, bool is_root) :
+      search_(search),
+      path_(path),
+      depth_(depth),
+      is_root_(is_root)
+    {
+    }
+
+    virtual void Run(ra::threading::ThreadPool & pool, size_t worker_index) {
+      ra::strings::StringVector & files = search_->files[worker_index];
+
+#ifdef _WIN32
+      //Build a *.* query
+      std::string query = path_;
+      NormalizePath(query);
+      query << "\\*";
+
+      WIN32_FIND_DATA find_data;
+      HANDLE hFind = FindFirstFile(query.c_str(), &find_data);
+      if (hFind == INVALID_HANDLE_VALUE)
+        return;
+      if (is_root_)
+        search_->root_found = true;
+
+      do {
+        bool is_directory = ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+        ProcessEntry(pool, worker_index, files, find_data.cFileName, is_directory);
+      } while (FindNextFile(hFind, &find_data));
+      FindClose(hFind);
+#elif defined(__linux__) || defined(__APPLE__)
+      DIR *dp;
+      struct dirent *dirp;
+      if ((dp = opendir(path_.c_str())) == NULL)
+        return;
+      if (is_root_)
+        search_->root_found = true;
+
+      while ((dirp = readdir(dp)) != NULL) {
+        bool is_directory = (dirp->d_type == DT_DIR);
+        ProcessEntry(pool, worker_index, files, dirp->d_name, is_directory);
+      }
+      closedir(dp);
+#endif
+    }
+
+  private:
+    void ProcessEntry(ra::threading::ThreadPool & pool, size_t worker_index, ra::strings::StringVector & files, const char * filename, bool is_directory) {
+      //is it a valid item ?
+      if (strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0)
+        return;
+
+      //build full path
+      std::string full_filename = path_;
+      NormalizePath(full_filename);
+      full_filename.append(GetPathSeparatorStr());
+      full_filename.append(filename);
+
+      //add this path to the list
+      files.push_back(full_filename);
+
+      //should we recurse on directory ?
+      if (is_directory && depth_ != 0) {
+        //compute new depth
+        int sub_depth = depth_ - 1;
+        if (sub_depth < -1)
+          sub_depth = -1;
+
+        //queue the subdirectory on this worker. Idle workers will steal it.
+        pool.Submit(new FindFilesTask(search_, full_filename, sub_depth, false), worker_index);
+      }
+    }
+
+    ParallelSearch * search_;
+    std::string path_;
+    int depth_;
+    bool is_root_;
+  };
+
+  bool FindFilesParallel(ra::strings::StringVector & files, const char * path, int depth, size_t num_threads, bool sorted) {
+    if (path == NULL)
+      return false;
+
+    ra::threading::ThreadPool pool(num_threads);
+
+    ParallelSearch search;
+    search.files.resize(pool.GetThreadCount());
+    search.root_found = false;
+
+    pool.Submit(new FindFilesTask(&search, path, depth, true));
+    pool.Wait();
+
+    if (!search.root_found)
+      return false;
+
+    //merge the results of each worker
+    size_t count = 0;
+    for (size_t i = 0; i < search.files.size(); i++) {
+      count += search.files[i].size();
+    }
+    ra::strings::StringVector found;
+    found.reserve(count);
+    for (size_t i = 0; i < search.files.size(); i++) {
+      found.insert(found.end(), search.files[i].begin(), search.files[i].end());
+    }
+
+    if (sorted)
+      std::sort(found.begin(), found.end());
+
+    files.insert(files.end(), found.begin(), found.end());
+    return true;
+  }
+
+  struct DirectoryIterator::Frame {
+    std::string path; //normalized directory path
+    int depth;
+#ifdef _WIN32
+    HANDLE handle;
+    WIN32_FIND_DATAA find_data;
+    bool has_data;
+#elif defined(__linux__) || defined(__APPLE__)
+    DIR * dir;
+#endif
+  };
+
+  DirectoryIterator::DirectoryIterator() :
+    max_depth_(-1),
+    has_pending_directory_(false),
+    pending_depth_(0)
+  {
+  }
+
+  DirectoryIterator::~DirectoryIterator() {
+    Close();
+  }
+
+  bool DirectoryIterator::Open(const char * path, int depth) {
+    Close();
+    if (path == NULL)
+      return false;
+
+    max_depth_ = depth;
+    return Push(path, 0);
+  }
+
+  void DirectoryIterator::Close() {
+    while (!frames_.empty()) {
+      Pop();
+    }
+    has_pending_directory_ = false;
+    pending_path_.clear();
+  }
+
+  void DirectoryIterator::SkipSubtree() {
+    has_pending_directory_ = false;
+  }
+
+  bool DirectoryIterator::Push(const std::string & path, int depth) {
+    Frame * frame = new Frame();
+    frame->path = path;
+    NormalizePath(frame->path);
+    frame->depth = depth;
+
+#ifdef _WIN32
+    //Build a *.* query
+    std::string query = frame->path;
+    query << "\\*";
+
+    frame->handle = FindFirstFileA(query.c_str(), &frame->find_data);
+    if (frame->handle == INVALID_HANDLE_VALUE) {
+      delete frame;
+      return false;
+    }
+    frame->has_data = true;
+#elif defined(__linux__) || defined(__APPLE__)
+    frame->dir = opendir(path.c_str());
+    if (frame->dir == NULL) {
+      delete frame;
+      return false;
+    }
+#endif
+
+    frames_.push_back(frame);
+    return true;
+  }
+
+  void DirectoryIterator::Pop() {
+    Frame * frame = frames_.back();
+#ifdef _WIN32
+    FindClose(frame->handle);
+#elif defined(__linux__) || defined(__APPLE__)
+    closedir(frame->dir);
+#endif
+    delete frame;
+    frames_.pop_back();
+  }
+
+  bool DirectoryIterator::Next(DirectoryEntry & entry) {
+    //browse the content of the last directory returned
+    if (has_pending_directory_) {
+      has_pending_directory_ = false;
+      Push(pending_path_, pending_depth_); //directories that cannot be opened are skipped like FindFiles()
+    }
+
+    while (!frames_.empty()) {
+      Frame * frame = frames_.back();
+
+      const char * filename = NULL;
+      DirectoryEntryType type = ENTRY_UNKNOWN;
+#ifdef _WIN32
+      if (!frame->has_data) {
+        Pop();
+        continue;
+      }
+      entry.name = frame->find_data.cFileName;
+      if (frame->find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        type = ENTRY_DIRECTORY;
+      else
+        type = ENTRY_FILE;
+      frame->has_data = (FindNextFileA(frame->handle, &frame->find_data) != 0);
+      filename = entry.name.c_str();
+#elif defined(__linux__) || defined(__APPLE__)
+      struct dirent * dirp = readdir(frame->dir);
+      if (dirp == NULL) {
+        Pop();
+        continue;
+      }
+      filename = dirp->d_name;
+      switch (dirp->d_type) {
+      case DT_REG: type = ENTRY_FILE; break;
+      case DT_DIR: type = ENTRY_DIRECTORY; break;
+      case DT_LNK: type = ENTRY_SYMLINK; break;
+      case DT_UNKNOWN: type = ENTRY_UNKNOWN; break;
+      default: type = ENTRY_OTHER; break;
+      };
+#endif
+
+      //is it a valid item ?
+      if (strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0)
+        continue;
+
+      //build full path
+      entry.name = filename;
+      entry.path = frame->path;
+      entry.path.append(GetPathSeparatorStr());
+      entry.path.append(filename);
+      entry.depth = frame->depth;
+
+#if defined(__linux__) || defined(__APPLE__)
+      //some file systems do not report the type of the entries
+      if (type == ENTRY_UNKNOWN) {
+        struct stat sb;
+        if (lstat(entry.path.c_str(), &sb) == 0)
+          type = GetEntryType(sb.st_mode);
+      }
+#endif
+      entry.type = type;
+
+      //should we browse this directory on next call ?
+      if (type == ENTRY_DIRECTORY && (max_depth_ < 0 || frame->depth < max_depth_)) {
+        has_pending_directory_ = true;
+        pending_path_ = entry.path;
+        pending_depth_ = frame->depth + 1;
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+  bool VisitDirectory(const char * path, int depth, IDirectoryVisitor * visitor) {
+    if (visitor == NULL)
+      return false;
+
+    DirectoryIterator iterator;
+    if (!iterator.Open(path, depth))
+      return false;
+
+    DirectoryEntry entry;
+    while (iterator.Next(entry)) {
+      VisitAction action = visitor->OnDirectoryEntry(entry);
+      if (action == VISIT_STOP)
+        break;
+      else if (action == VISIT_SKIP_SUBTREE)
+        iterator.SkipSubtree();
+    }
+    return true;
+  }
+
   bool FindFileFromPaths(const std::string & filename, ra::strings::StringVector & locations) {
     locations.clear();
 
@@ -399,11 +824,9 @@ namespace ra { namespace filesystem {
     //For instance, 'C:\Users\All Users\Favorites' exists but 'C:\Users\All Users' don't.
 #endif
 
-    struct stat64 sb;
-    if (stat64(path, &sb) == 0) {
-      if ((sb.st_mode & S_IFDIR) == S_IFDIR)
-        return true;
-    }
+    FileInfo info;
+    if (GetFileInfo(path, info))
+      return (info.type == ENTRY_DIRECTORY);
     return false;
   }
 
@@ -475,29 +898,28 @@ namespace ra { namespace filesystem {
     //directory exists and must be deleted
 
     //find all files and directories in specified directory
-    ra::strings::StringVector files;
-    bool found = FindFiles(files, path);
+    PathTree tree;
+    bool found = tree.FindFiles(path);
     if (!found)
       return false;
 
-    //sort files in reverse order
-    //this allows deleting sub-directories and sub-files first
-    std::sort(files.begin(), files.end(), greater());
-
-    //process files and directories
-    for (size_t i = 0; i < files.size(); i++) {
-      const std::string & direntry = files[i];
-      if (FileExists(direntry.c_str())) {
-        bool deleted = DeleteFile(direntry.c_str());
-        if (!deleted)
-          return false; //failed to delete file
-      }
-      else {
-        //assume direntry is a directory
+    //process files and directories in reverse order
+    //each directory is found before its content which allows deleting sub-directories and sub-files first
+    std::string direntry;
+    for (size_t i = tree.GetCount(); i > 0; i--) {
+      const size_t index = i - 1;
+      tree.GetPath(index, direntry);
+      if (tree.GetType(index) == ENTRY_DIRECTORY) {
         int result = __rmdir(direntry.c_str());
         if (result != 0)
           return false; //failed deleting directory.
       }
+      else {
+        //files, symbolic links and other entries
+        bool deleted = DeleteFile(direntry.c_str());
+        if (!deleted)
+          return false; //failed to delete file
+      }
     }
 
     //delete the specified directory
@@ -909,12 +1331,10 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
   }
 
   uint64_t GetFileModifiedDate(const std::string & path) {
-    struct stat64 result;
-    uint64_t mod_time = 0;
-    if (stat64(path.c_str(), &result) == 0) {
-      mod_time = result.st_mtime;
-    }
-    return mod_time;
+    FileInfo info;
+    if (GetFileInfo(path.c_str(), info))
+      return info.modified_time;
+    return 0;
   }
 
   bool IsDirectoryEmpty(const std::string & path) {
@@ -1114,56 +1534,271 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     return resolved;
   }
 
-  bool CopyFileInternal(const std::string & source_path, const std::string & destination_path, IProgressReport * progress_functor, ProgressReportCallback progress_function, bool force_win32_utf8) {
-    uint64_t file_size = ra::filesystem::GetFileSize64(source_path.c_str());
-    if (force_win32_utf8)
-    {
-      file_size = ra::filesystem::GetFileSize64Utf8(source_path.c_str());
-    }
-
-    FILE* fin = NULL;
-    if (!force_win32_utf8)
-      fin = fopen(source_path.c_str(), "rb");
-#ifdef _WIN32 // UTF-8
-    if (force_win32_utf8)
-    {
-      std::wstring source_path_w = ra::unicode::Utf8ToUnicode(source_path);
-      fin = _wfopen(source_path_w.c_str(), L"rb");
-    }
-#endif // UTF-8
+  void PublishProgress(IProgressReport * progress_functor, ProgressReportCallback progress_function, double progress) {
+    if (progress_functor)
+      progress_functor->OnProgressReport(progress);
+    if (progress_function)
+      progress_function(progress);
+  }
 
-    if (!fin)
+#ifdef __linux__
+  //returns true if the given error code means that a kernel copy method is not supported for the given files.
+  bool IsKernelCopyUnsupported(int error_code) {
+    switch (error_code) {
+    case ENOSYS:
+    case EXDEV:
+    case EINVAL:
+    case EOPNOTSUPP:
+    case EBADF:
+    case EPERM:
+      return true;
+    default:
       return false;
-
-    FILE* fout = NULL;
-    if (!force_win32_utf8)
-      fout = fopen(destination_path.c_str(), "wb");
-#ifdef _WIN32 // UTF-8
-    if (force_win32_utf8)
-    {
-      std::wstring destination_w = ra::unicode::Utf8ToUnicode(destination_path);
-      fout = _wfopen(destination_w.c_str(), L"wb");
     }
-#endif // UTF-8
-    
-    if (!fout) {
-      fclose(fin);
-      return false;
+  }
+
+  //write all the given bytes to a file descriptor.
+  bool WriteFully(int fd, const uint8_t * buffer, size_t size) {
+    while (size) {
+      ssize_t size_written = write(fd, buffer, size);
+      if (size_written < 0 && errno == EINTR)
+        continue;
+      if (size_written <= 0)
+        return false;
+      buffer += size_written;
+      size -= (size_t)size_written;
     }
+    return true;
+  }
 
-    //publish progress
-    double progress = 0.0;
-    if (progress_functor)
-      progress_functor->OnProgressReport(progress);
-    if (progress_function)
-      progress_function(progress);
+  struct KernelCopyState {
+    IProgressReport * progress_functor;
+    ProgressReportCallback progress_function;
+    bool use_copy_file_range;
+    bool use_sendfile;
+    uint64_t file_size;
+    uint64_t copied_size; //number of bytes of the source file processed so far, including holes
+    double progress;
+  };
 
+  //copy up to max_size bytes from fd_in to fd_out from their current offsets, using the fastest method supported by the file systems.
+  //The methods are tried in the following order: copy_file_range(), sendfile() and a read()/write() loop.
+  //The copy stops early if the end of the source file is reached.
+  bool CopyFileChunks(int fd_in, int fd_out, uint64_t max_size, KernelCopyState & state) {
+    const size_t chunk_size = 8 * 1024 * 1024; //8 MB per kernel call
     const size_t buffer_size = 100 * 1024; //100k memory buffer
     uint8_t buffer[buffer_size];
 
-    size_t copied_size = 0;
-
-    while (!feof(fin)) {
+    while (max_size > 0) {
+      size_t request_size = (max_size < chunk_size ? (size_t)max_size : chunk_size);
+      ssize_t count = 0;
+      if (state.use_copy_file_range) {
+#ifdef RA_HAVE_COPY_FILE_RANGE
+        count = copy_file_range(fd_in, NULL, fd_out, NULL, request_size, 0);
+#endif
+        if (count < 0) {
+          if (errno == EINTR)
+            continue;
+          if (!IsKernelCopyUnsupported(errno))
+            return false;
+          state.use_copy_file_range = false; //fallback to the next method. File offsets are not modified on failure.
+          continue;
+        }
+      }
+      else if (state.use_sendfile) {
+        count = sendfile(fd_out, fd_in, NULL, request_size);
+        if (count < 0) {
+          if (errno == EINTR)
+            continue;
+          if (!IsKernelCopyUnsupported(errno))
+            return false;
+          state.use_sendfile = false;
+          continue;
+        }
+      }
+      else {
+        if (request_size > buffer_size)
+          request_size = buffer_size;
+        count = read(fd_in, buffer, request_size);
+        if (count < 0 && errno == EINTR)
+          continue;
+        if (count < 0)
+          return false;
+        if (count > 0 && !WriteFully(fd_out, buffer, (size_t)count))
+          return false;
+      }
+
+      if (count == 0)
+        break; //end of file
+
+      state.copied_size += (uint64_t)count;
+      max_size -= (uint64_t)count;
+
+      //publish progress
+      if (state.file_size > 0) {
+        state.progress = double(state.copied_size) / double(state.file_size);
+        if (state.progress > 1.0)
+          state.progress = 1.0;
+        PublishProgress(state.progress_functor, state.progress_function, state.progress);
+      }
+    }
+
+    return true;
+  }
+
+  //copy the data extents of a sparse file and leave the holes unallocated in the destination file.
+  //The destination file must be empty.
+  bool CopyFileExtents(int fd_in, int fd_out, KernelCopyState & state) {
+    uint64_t offset = 0;
+    while (offset < state.file_size) {
+      off64_t data_begin = lseek64(fd_in, (off64_t)offset, SEEK_DATA);
+      if (data_begin < 0 && errno == ENXIO)
+        break; //no more data until the end of the file
+      if (data_begin < 0)
+        return false;
+      off64_t data_end = lseek64(fd_in, data_begin, SEEK_HOLE);
+      if (data_end < 0)
+        return false;
+
+      //skip the hole in both files
+      if (lseek64(fd_in, data_begin, SEEK_SET) < 0 || lseek64(fd_out, data_begin, SEEK_SET) < 0)
+        return false;
+      state.copied_size = (uint64_t)data_begin;
+
+      if (!CopyFileChunks(fd_in, fd_out, (uint64_t)(data_end - data_begin), state))
+        return false;
+      if (state.copied_size != (uint64_t)data_end)
+        return true; //the source file was truncated while copying
+
+      offset = (uint64_t)data_end;
+    }
+
+    //recreate the trailing hole
+    if (ftruncate64(fd_out, (off64_t)state.file_size) != 0)
+      return false;
+    state.copied_size = state.file_size;
+    return true;
+  }
+
+  bool CopyFileKernel(const std::string & source_path, const std::string & destination_path, IProgressReport * progress_functor, ProgressReportCallback progress_function) {
+    int fd_in = open(source_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_in < 0)
+      return false;
+
+    struct stat64 source_stat;
+    if (fstat64(fd_in, &source_stat) != 0) {
+      close(fd_in);
+      return false;
+    }
+
+    int fd_out = open(destination_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd_out < 0) {
+      close(fd_in);
+      return false;
+    }
+
+    KernelCopyState state;
+    state.progress_functor = progress_functor;
+    state.progress_function = progress_function;
+    state.file_size = (uint64_t)source_stat.st_size;
+    state.copied_size = 0;
+    state.progress = 0.0;
+
+    //kernel methods are skipped for files that reports an empty size but may have content (ie /proc files)
+    state.use_copy_file_range = (state.file_size > 0);
+    state.use_sendfile = (state.file_size > 0);
+#ifndef RA_HAVE_COPY_FILE_RANGE
+    state.use_copy_file_range = false;
+#endif
+
+    //publish progress
+    PublishProgress(progress_functor, progress_function, state.progress);
+
+    bool success = false;
+#ifdef FICLONE
+    //share the data blocks of the source file on copy-on-write file systems (btrfs, xfs)
+    if (state.file_size > 0 && ioctl(fd_out, FICLONE, fd_in) == 0) {
+      state.copied_size = state.file_size;
+      success = true;
+    }
+#endif
+    if (!success) {
+      //a file that uses less blocks than its size has holes
+      bool is_sparse = (uint64_t)source_stat.st_blocks * 512 < state.file_size;
+      if (is_sparse)
+        success = CopyFileExtents(fd_in, fd_out, state);
+      else
+        success = CopyFileChunks(fd_in, fd_out, (uint64_t)-1, state);
+    }
+
+    close(fd_in);
+    if (close(fd_out) != 0)
+      success = false;
+
+    //files which size is unknown (ie /proc files) are copied until the end of the file
+    if (state.file_size > 0)
+      success = success && (state.file_size == state.copied_size);
+
+    if (success && state.progress < 1.0) //if 100% progress not already sent
+      PublishProgress(progress_functor, progress_function, 1.0);
+
+    return success;
+  }
+#endif //__linux__
+
+  bool CopyFileInternal(const std::string & source_path, const std::string & destination_path, IProgressReport * progress_functor, ProgressReportCallback progress_function, bool force_win32_utf8) {
+#ifdef __linux__
+    //copy the file in kernel space when possible
+    if (!force_win32_utf8)
+      return CopyFileKernel(source_path, destination_path, progress_functor, progress_function);
+#endif
+
+    uint64_t file_size = ra::filesystem::GetFileSize64(source_path.c_str());
+    if (force_win32_utf8)
+    {
+      file_size = ra::filesystem::GetFileSize64Utf8(source_path.c_str());
+    }
+
+    FILE* fin = NULL;
+    if (!force_win32_utf8)
+      fin = fopen(source_path.c_str(), "rb");
+#ifdef _WIN32 // UTF-8
+    if (force_win32_utf8)
+    {
+      std::wstring source_path_w = ra::unicode::Utf8ToUnicode(source_path);
+      fin = _wfopen(source_path_w.c_str(), L"rb");
+    }
+#endif // UTF-8
+
+    if (!fin)
+      return false;
+
+    FILE* fout = NULL;
+    if (!force_win32_utf8)
+      fout = fopen(destination_path.c_str(), "wb");
+#ifdef _WIN32 // UTF-8
+    if (force_win32_utf8)
+    {
+      std::wstring destination_w = ra::unicode::Utf8ToUnicode(destination_path);
+      fout = _wfopen(destination_w.c_str(), L"wb");
+    }
+#endif // UTF-8
+    
+    if (!fout) {
+      fclose(fin);
+      return false;
+    }
+
+    //publish progress
+    double progress = 0.0;
+    PublishProgress(progress_functor, progress_function, progress);
+
+    const size_t buffer_size = 100 * 1024; //100k memory buffer
+    uint8_t buffer[buffer_size];
+
+    uint64_t copied_size = 0;
+
+    while (!feof(fin)) {
       size_t size_readed = fread(buffer, 1, buffer_size, fin);
       if (size_readed) {
         size_t size_writen = fwrite(buffer, 1, size_readed, fout);
@@ -1171,10 +1806,7 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
 
         //publish progress
         progress = double(copied_size) / double(file_size);
-        if (progress_functor)
-          progress_functor->OnProgressReport(progress);
-        if (progress_function)
-          progress_function(progress);
+        PublishProgress(progress_functor, progress_function, progress);
       }
     }
 
@@ -1187,10 +1819,7 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     {
       //publish progress
       progress = 1.0;
-      if (progress_functor)
-        progress_functor->OnProgressReport(progress);
-      if (progress_function)
-        progress_function(progress);
+      PublishProgress(progress_functor, progress_function, progress);
     }
 
     return success;
@@ -1208,16 +1837,318 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     return CopyFileInternal(source_path, destination_path, NULL, progress_function, false);
   }
 
-  bool PeekFile(const std::string & path, size_t size, std::string & data) {
-    //static const std::string EMPTY;
-    data.clear();
+  CopyDirectoryOptions::CopyDirectoryOptions() :
+    overwrite(true),
+    preserve_times(false),
+    preserve_mode(true),
+    preserve_hardlinks(false),
+    num_threads(0)
+  {
+  }
 
-    //validate if file exists
-    if (!ra::filesystem::FileExists(path.c_str()))
+  //a file system entry to create in the destination directory
+  struct CopyItem {
+    std::string source; //for hard links, the destination path of the first link
+    std::string destination;
+    FileInfo info;
+  };
+  typedef std::vector<CopyItem> CopyItemVector;
+
+  //copy the permission bits and the modification time of a file system entry according to the given options.
+  bool CopyAttributes(const CopyItem & item, const CopyDirectoryOptions & options) {
+    bool success = true;
+    if (options.preserve_mode) {
+#ifdef _WIN32
+      if (_chmod(item.destination.c_str(), item.info.mode & (_S_IREAD | _S_IWRITE)) != 0)
+        success = false;
+#else
+      if (chmod(item.destination.c_str(), (mode_t)(item.info.mode & 07777)) != 0)
+        success = false;
+#endif
+    }
+    if (options.preserve_times) {
+#ifdef _WIN32
+      struct __utimbuf64 times;
+      times.actime = (__time64_t)item.info.modified_time;
+      times.modtime = (__time64_t)item.info.modified_time;
+      if (_utime64(item.destination.c_str(), &times) != 0)
+        success = false;
+#else
+      struct timespec times[2];
+      times[0].tv_sec = 0;
+      times[0].tv_nsec = UTIME_OMIT; //keep the access time
+      times[1].tv_sec = (time_t)item.info.modified_time;
+      times[1].tv_nsec = (long)item.info.modified_time_nsec;
+      if (utimensat(AT_FDCWD, item.destination.c_str(), times, 0) != 0)
+        success = false;
+#endif
+    }
+    return success;
+  }
+
+  //shared state of the files copied by the threads of CopyDirectory()
+  struct ParallelCopy {
+    ParallelCopy(const CopyDirectoryOptions & options, IProgressReport * progress_functor) :
+      options(options),
+      progress_functor(progress_functor),
+      total_size(0),
+      copied_size(0),
+      num_errors(0),
+      progress(0.0)
+    {
+    }
+
+    void AddCopiedSize(uint64_t size) {
+      ra::threading::ScopedLock lock(mutex);
+      copied_size += size;
+      if (progress_functor && total_size > 0) {
+        double new_progress = double(copied_size) / double(total_size);
+        if (new_progress > 1.0)
+          new_progress = 1.0;
+        if (new_progress > progress) {
+          progress = new_progress;
+          progress_functor->OnProgressReport(progress);
+        }
+      }
+    }
+
+    void AddError() {
+      ra::threading::ScopedLock lock(mutex);
+      num_errors++;
+    }
+
+    const CopyDirectoryOptions & options;
+    IProgressReport * progress_functor;
+    ra::threading::Mutex mutex; //protects the members below
+    uint64_t total_size;
+    uint64_t copied_size;
+    size_t num_errors;
+    double progress;
+  };
+
+  //forward the progress of a single file copy to the progress of the whole directory copy
+  class CopyFileProgress : public virtual IProgressReport {
+  public:
+    CopyFileProgress(ParallelCopy * copy, uint64_t file_size) :
+      copy_(copy),
+      file_size_(file_size),
+      reported_size_(0)
+    {
+    }
+    virtual ~CopyFileProgress() {}
+
+    virtual void OnProgressReport(double progress) {
+      uint64_t size = (uint64_t)(progress * double(file_size_));
+      if (size > file_size_)
+        size = file_size_;
+      if (size > reported_size_) {
+        copy_->AddCopiedSize(size - reported_size_);
+        reported_size_ = size;
+      }
+    }
+
+    //report the remaining bytes of the file
+    void Complete() {
+      OnProgressReport(1.0);
+    }
+
+  private:
+    ParallelCopy * copy_;
+    uint64_t file_size_;
+    uint64_t reported_size_;
+  };
+
+  //copies a range of files for CopyDirectory()
+  class CopyFilesTask : public ra::threading::ITask {
+  public:
+    CopyFilesTask(ParallelCopy * copy, const CopyItemVector * files, size_t begin, size_t end) :
+      copy_(copy),
+      files_(files),
+      begin_(begin),
+      end_(end)
+    {
+    }
+
+    virtual void Run(ra::threading::ThreadPool & /*pool*/, size_t /*worker_index*/) {
+      //only large files reports their progress while they are copied
+      static const uint64_t LARGE_FILE_SIZE = 1024 * 1024;
+
+      for (size_t i = begin_; i < end_; i++) {
+        const CopyItem & item = (*files_)[i];
+        CopyFileProgress file_progress(copy_, item.info.size);
+
+        FileInfo existing;
+        if (!copy_->options.overwrite && GetFileInfo(item.destination.c_str(), existing)) {
+          file_progress.Complete();
+          continue;
+        }
+
+        IProgressReport * progress_functor = (item.info.size >= LARGE_FILE_SIZE ? &file_progress : NULL);
+        bool copied = CopyFileInternal(item.source, item.destination, progress_functor, NULL, false);
+        if (!copied || !CopyAttributes(item, copy_->options))
+          copy_->AddError();
+        file_progress.Complete();
+      }
+    }
+
+  private:
+    ParallelCopy * copy_;
+    const CopyItemVector * files_;
+    size_t begin_;
+    size_t end_;
+  };
+
+  bool CopyDirectory(const std::string & source_path, const std::string & destination_path, const CopyDirectoryOptions & options, IProgressReport * progress_functor) {
+    std::string source_root = source_path;
+    std::string destination_root = destination_path;
+    NormalizePath(source_root);
+    NormalizePath(destination_root);
+
+    CopyItem root;
+    root.source = source_root;
+    root.destination = destination_root;
+    if (!GetFileInfo(source_root.c_str(), root.info) || root.info.type != ENTRY_DIRECTORY)
+      return false;
+
+    //list the content of the source directory before creating anything in case the destination is inside the source directory
+    CopyItemVector directories;
+    CopyItemVector files;
+    CopyItemVector hardlinks;
+    CopyItemVector symlinks;
+    std::map<std::pair<uint64_t, uint64_t>, size_t> inodes; //maps the device and inode of a file to its index in files
+    bool success = true;
+
+    directories.push_back(root);
+
+    DirectoryIterator it;
+    if (!it.Open(source_root.c_str(), -1))
       return false;
+    DirectoryEntry entry;
+    while (it.Next(entry)) {
+      CopyItem item;
+      item.source = entry.path;
+      item.destination = destination_root + entry.path.substr(source_root.size());
+
+#ifndef _WIN32
+      if (entry.type == ENTRY_SYMLINK) {
+        symlinks.push_back(item);
+        continue;
+      }
+#endif
+
+      if (!GetFileInfo(item.source.c_str(), item.info)) {
+        success = false;
+        continue;
+      }
+
+      if (item.info.type == ENTRY_DIRECTORY) {
+        directories.push_back(item);
+      }
+      else if (item.info.type == ENTRY_FILE) {
+        if (options.preserve_hardlinks && item.info.link_count > 1 && item.info.inode != 0) {
+          std::pair<uint64_t, uint64_t> key(item.info.device, item.info.inode);
+          std::map<std::pair<uint64_t, uint64_t>, size_t>::const_iterator found = inodes.find(key);
+          if (found != inodes.end()) {
+            //link to the first copy of the file
+            item.source = files[found->second].destination;
+            hardlinks.push_back(item);
+            continue;
+          }
+          inodes[key] = files.size();
+        }
+        files.push_back(item);
+      }
+      //sockets, pipes and devices are not copied
+    }
+    it.Close();
+
+    //create the directory tree. Parent directories are listed before their content.
+    for (size_t i = 0; i < directories.size(); i++) {
+      if (!CreateDirectory(directories[i].destination.c_str()))
+        return false;
+    }
+
+    //copy the files in batches to reduce the overhead of small files
+    ParallelCopy copy(options, progress_functor);
+    for (size_t i = 0; i < files.size(); i++) {
+      copy.total_size += files[i].info.size;
+    }
+    PublishProgress(progress_functor, NULL, 0.0);
+    {
+      static const uint64_t BATCH_MAX_SIZE = 4 * 1024 * 1024;
+      static const size_t BATCH_MAX_COUNT = 64;
+
+      ra::threading::ThreadPool pool(options.num_threads);
+      size_t begin = 0;
+      uint64_t batch_size = 0;
+      for (size_t i = 0; i < files.size(); i++) {
+        batch_size += files[i].info.size;
+        size_t end = i + 1;
+        if (end == files.size() || end - begin >= BATCH_MAX_COUNT || batch_size >= BATCH_MAX_SIZE) {
+          pool.Submit(new CopyFilesTask(&copy, &files, begin, end));
+          begin = end;
+          batch_size = 0;
+        }
+      }
+      pool.Wait();
+    }
+    if (copy.num_errors > 0)
+      success = false;
+
+#ifndef _WIN32
+    //recreate the hard links once their first copy exists
+    for (size_t i = 0; i < hardlinks.size(); i++) {
+      const CopyItem & item = hardlinks[i];
+      FileInfo existing;
+      if (GetFileInfo(item.destination.c_str(), existing)) {
+        if (!options.overwrite)
+          continue;
+        unlink(item.destination.c_str());
+      }
+      if (link(item.source.c_str(), item.destination.c_str()) != 0 && !CopyFile(item.source, item.destination))
+        success = false;
+    }
+
+    //recreate the symbolic links
+    for (size_t i = 0; i < symlinks.size(); i++) {
+      const CopyItem & item = symlinks[i];
+      std::vector<char> target(PATH_MAX + 1, '\0');
+      ssize_t length = readlink(item.source.c_str(), &target[0], target.size() - 1);
+      if (length < 0) {
+        success = false;
+        continue;
+      }
+      target[length] = '\0';
+
+      struct stat64 existing;
+      if (lstat64(item.destination.c_str(), &existing) == 0) {
+        if (!options.overwrite)
+          continue;
+        unlink(item.destination.c_str());
+      }
+      if (symlink(&target[0], item.destination.c_str()) != 0)
+        success = false;
+    }
+#endif
+
+    //copy the attributes of directories once their content is created since creating a file changes the modification time of its directory.
+    //Subdirectories are processed before their parent in case the permissions of the parent prevents their modification.
+    for (size_t i = directories.size(); i > 0; i--) {
+      if (!CopyAttributes(directories[i - 1], options))
+        success = false;
+    }
+
+    if (success && copy.progress < 1.0) //if 100% progress not already sent
+      PublishProgress(progress_functor, NULL, 1.0);
+
+    return success;
+  }
+
+  //read the first bytes of a file which size is known.
+  bool ReadFileContent(const std::string & path, uint64_t file_size, size_t size, std::string & data) {
+    data.clear();
 
     //allocate a buffer which can hold the data of the peek size
-    uint64_t file_size = ra::filesystem::GetFileSize64(path.c_str());
     uint64_t max_read_size = (file_size < (uint64_t)size ? file_size : (uint64_t)size);
 
     //validates empty files 
@@ -1229,7 +2160,7 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
       return false;
 
     //allocate a buffer to hold the content
-    data.resize(max_read_size, 0);
+    data.resize((size_t)max_read_size, 0);
     char * buffer = &data[0];
     char * last = &data[data.size() - 1];
     bool is_buffer_size_ok = (data.size() == max_read_size);
@@ -1240,7 +2171,7 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     }
 
     //read the data
-    size_t read_size = fread(buffer, 1, max_read_size, f);
+    size_t read_size = fread(buffer, 1, (size_t)max_read_size, f);
     if (read_size != max_read_size) {
       fclose(f);
       return false;
@@ -1252,19 +2183,30 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     return success;
   }
 
-  bool ReadFile(const std::string & path, std::string & data) {
+  bool PeekFile(const std::string & path, size_t size, std::string & data) {
+    data.clear();
+
     //validate if file exists
-    if (!ra::filesystem::FileExists(path.c_str()))
+    FileInfo info;
+    if (!GetFileInfo(path.c_str(), info) || info.type != ENTRY_FILE)
       return false;
 
-    uint32_t file_size = ra::filesystem::GetFileSize(path.c_str());
+    return ReadFileContent(path, info.size, size, data);
+  }
 
-    //validates empty files 
-    if (file_size == 0)
-      return true;
+  bool ReadFile(const std::string & path, std::string & data) {
+    data.clear();
+
+    //validate if file exists
+    FileInfo info;
+    if (!GetFileInfo(path.c_str(), info) || info.type != ENTRY_FILE)
+      return false;
 
-    bool readed = PeekFile(path, file_size, data);
-    return readed;
+    //validates files that cannot fit in memory
+    if (info.size > (uint64_t)((size_t)-1))
+      return false;
+
+    return ReadFileContent(path, info.size, (size_t)info.size, data);
   }
 
   bool WriteFile(const std::string & path, const std::string & data) {
@@ -1280,54 +2222,499 @@ std::string GetTemporaryDirectoryFromEnvVar(const char * name) {
     return success;
   }
 
-  bool FileReplace(const std::string & path, const std::string & old_value, const std::string & new_value) {
-    std::string data;
-    if (!ReadFile(path, data))
+  //create a new temporary file in the same directory as the given file so that it can later replace the file with RenameFileReplace().
+  FILE * CreateTemporarySiblingFile(const std::string & path, std::string & temp_path) {
+    static const int MAX_ATTEMPTS = 100;
+    for (int i = 0; i < MAX_ATTEMPTS; i++) {
+      temp_path = path + "." + GetTemporaryFileName();
+      FILE * f = fopen(temp_path.c_str(), "wbx"); //fails if the file already exists
+      if (f)
+        return f;
+      if (errno != EEXIST)
+        break;
+    }
+    temp_path.clear();
+    return NULL;
+  }
+
+  //atomically replace new_path by old_path.
+  bool RenameFileReplace(const std::string & old_path, const std::string & new_path) {
+#ifdef _WIN32
+    return MoveFileExA(old_path.c_str(), new_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(old_path.c_str(), new_path.c_str()) == 0;
+#endif
+  }
+
+  //copy the permission bits of an existing file to another file.
+  void CopyFileMode(const std::string & source_path, const std::string & destination_path) {
+    FileInfo info;
+    if (!GetFileInfo(source_path.c_str(), info))
+      return;
+#ifdef _WIN32
+    _chmod(destination_path.c_str(), info.mode & (_S_IREAD | _S_IWRITE));
+#else
+    chmod(destination_path.c_str(), (mode_t)(info.mode & 07777));
+#endif
+  }
+
+  //flush the data of an opened file to the storage device.
+  bool SyncFile(FILE * f) {
+    if (fflush(f) != 0)
+      return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#elif defined(__APPLE__)
+    return fcntl(fileno(f), F_FULLFSYNC) == 0 || fsync(fileno(f)) == 0; //fsync() does not flush the drive cache on macOS
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+  }
+
+  //flush the entries of a directory (created, renamed or deleted files) to the storage device.
+  bool SyncDirectory(const std::string & path) {
+#ifdef _WIN32
+    return true; //not supported. Renames are flushed with MOVEFILE_WRITE_THROUGH.
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
       return false;
+    bool success = (fsync(fd) == 0);
+    close(fd);
+    return success;
+#endif
+  }
+
+  //get the directory that contains the given file.
+  std::string GetFileDirectory(const std::string & path) {
+    std::string parent = GetParentPath(path);
+    if (parent.empty()) {
+      if (!path.empty() && (path[0] == '/' || path[0] == '\\'))
+        return path.substr(0, 1); //file in the root directory
+      return ".";
+    }
+    return parent;
+  }
 
-    int num_finding = ra::strings::Replace(data, old_value, new_value);
+  //copy the first bytes of a file to an opened file.
+  bool CopyFilePrefix(const std::string & path, uint64_t size, FILE * fout) {
+    FILE * fin = fopen(path.c_str(), "rb");
+    if (!fin)
+      return false;
 
-    //does the file was modified?
-    if (num_finding) {
-      //yes, write modifications to the file
-      if (!WriteFile(path, data))
-        return false;
+    const size_t buffer_size = 100 * 1024; //100k memory buffer
+    uint8_t buffer[buffer_size];
+    while (size > 0) {
+      size_t read_size = (size < (uint64_t)buffer_size ? (size_t)size : buffer_size);
+      size_t size_read = fread(buffer, 1, read_size, fin);
+      if (size_read == 0 || fwrite(buffer, 1, size_read, fout) != size_read)
+        break;
+      size -= size_read;
     }
+    fclose(fin);
+    return (size == 0);
+  }
 
+  //get the path of the file that is the target of the given path after resolving symbolic links.
+  std::string GetRealFilePath(const std::string & path) {
+#ifdef _WIN32
+    return path;
+#else
+    char * real_path = realpath(path.c_str(), NULL);
+    if (!real_path)
+      return path;
+    std::string output = real_path;
+    free(real_path);
+    return output;
+#endif
+  }
+
+  //copy the owner and group of an existing file to another file.
+  //returns true if the destination file has the same owner and group as the source file.
+  bool CopyFileOwner(const std::string & source_path, const std::string & destination_path) {
+#ifdef _WIN32
     return true;
+#else
+    struct stat source_stat;
+    struct stat destination_stat;
+    if (stat(source_path.c_str(), &source_stat) != 0 || stat(destination_path.c_str(), &destination_stat) != 0)
+      return false;
+    if (source_stat.st_uid == destination_stat.st_uid && source_stat.st_gid == destination_stat.st_gid)
+      return true;
+    return chown(destination_path.c_str(), source_stat.st_uid, source_stat.st_gid) == 0;
+#endif
   }
 
-  bool ReadTextFile(const std::string & path, ra::strings::StringVector & lines, bool trim_newline_characters) {
-    lines.clear();
+  //overwrite the content of an existing file with the content of another file without replacing the file.
+  bool OverwriteFileContent(const std::string & source_path, const std::string & destination_path) {
+    uint64_t size = GetFileSize64(source_path.c_str());
+    FILE * fout = fopen(destination_path.c_str(), "wb");
+    if (!fout)
+      return false;
+    bool success = CopyFilePrefix(source_path, size, fout);
+    if (fclose(fout) != 0)
+      success = false;
+    return success;
+  }
 
-    static const int BUFFER_SIZE = 10240;
-    char buffer[BUFFER_SIZE];
+  bool FileReplace(const std::string & path, const std::string & old_value, const std::string & new_value) {
+    //process the target of symbolic links so that the links are kept
+    const std::string real_path = GetRealFilePath(path);
+    FileInfo info;
+    if (!GetFileInfo(real_path.c_str(), info))
+      return false;
 
-    FILE* f = fopen(path.c_str(), "r");
-    if (!f)
+    FILE * fin = fopen(real_path.c_str(), "rb");
+    if (!fin)
       return false;
 
-    while (fgets(buffer, BUFFER_SIZE, f) != NULL) {
-      if (trim_newline_characters) {
-        //remove last CRLF at the end of the string
-        ra::strings::RemoveEol(buffer);
+    if (old_value.empty()) {
+      fclose(fin);
+      return true; //nothing to replace
+    }
+
+    //The file is processed in chunks. The last bytes of each chunk that could be the beginning
+    //of an occurrence of old_value are kept for the next chunk.
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+    const size_t overlap_size = old_value.size() - 1;
+    std::string window;
+    uint64_t window_offset = 0; //offset in the file of the first byte of the window
+    FILE * fout = NULL; //the temporary file is only created when a first occurrence is found
+    std::string temp_path;
+    bool success = true;
+    bool eof = false;
+
+    while (success && !eof) {
+      //append the next chunk to the window
+      size_t previous_size = window.size();
+      window.resize(previous_size + CHUNK_SIZE);
+      size_t size_read = fread(&window[previous_size], 1, CHUNK_SIZE, fin);
+      window.resize(previous_size + size_read);
+      if (size_read == 0) {
+        eof = true;
+        if (ferror(fin)) {
+          success = false;
+          break;
+        }
+      }
+
+      size_t start = 0; //first byte of the window that is not written yet
+      size_t found = window.find(old_value, start);
+      while (success && found != std::string::npos) {
+        if (!fout) {
+          //first occurrence. Copy the content before the window to the temporary file.
+          fout = CreateTemporarySiblingFile(real_path, temp_path);
+          if (!fout || !CopyFilePrefix(real_path, window_offset, fout)) {
+            success = false;
+            break;
+          }
+        }
+
+        size_t length = found - start;
+        if ((length && fwrite(&window[start], 1, length, fout) != length) ||
+            (new_value.size() && fwrite(new_value.data(), 1, new_value.size(), fout) != new_value.size()))
+          success = false;
+
+        start = found + old_value.size();
+        found = window.find(old_value, start);
       }
 
-      std::string line = buffer;
-      lines.push_back(line);
+      //write the content of the window that cannot be part of an occurrence
+      size_t keep_offset = window.size();
+      if (!eof && window.size() > overlap_size)
+        keep_offset = window.size() - overlap_size;
+      else if (!eof)
+        keep_offset = 0;
+      if (keep_offset < start)
+        keep_offset = start;
+      size_t length = keep_offset - start;
+      if (success && fout && length && fwrite(&window[start], 1, length, fout) != length)
+        success = false;
+
+      window.erase(0, keep_offset);
+      window_offset += keep_offset;
     }
-    fclose(f);
+
+    fclose(fin);
+
+    if (!fout)
+      return success; //no occurrence found, the file is not modified
+
+    if (fclose(fout) != 0)
+      success = false;
+
+    if (!success) {
+      remove(temp_path.c_str());
+      return false;
+    }
+
+    //Replacing a file with a rename would split a hard linked file from its other names
+    //or change the owner of the file. Copy the new content over the original file instead.
+    if (info.link_count > 1 || !CopyFileOwner(real_path, temp_path)) {
+      success = OverwriteFileContent(temp_path, real_path);
+      remove(temp_path.c_str());
+      return success;
+    }
+
+    //keep the permissions of the original file
+    CopyFileMode(real_path, temp_path);
+
+    success = RenameFileReplace(temp_path, real_path);
+    if (!success)
+      remove(temp_path.c_str());
+
+    return success;
+  }
+
+  bool AtomicWriteFile(const std::string & path, const std::string & data) {
+    std::string temp_path;
+    FILE * f = CreateTemporarySiblingFile(path, temp_path);
+    if (!f)
+      return false;
+
+    bool success = (fwrite(data.data(), 1, data.size(), f) == data.size());
+    success = success && SyncFile(f);
+    if (fclose(f) != 0)
+      success = false;
+
+    //keep the permissions of the file that is replaced
+    if (success)
+      CopyFileMode(path, temp_path);
+
+    success = success && RenameFileReplace(temp_path, path);
+    if (!success) {
+      remove(temp_path.c_str());
+      return false;
+    }
+
+    //make the rename durable
+    return SyncDirectory(GetFileDirectory(path));
+  }
+
+  DurableWriteBatch::DurableWriteBatch() {
+  }
+
+  DurableWriteBatch::~DurableWriteBatch() {
+    Clear();
+  }
+
+  bool DurableWriteBatch::Add(const std::string & path, const std::string & data) {
+    std::string temp_path;
+    FILE * f = CreateTemporarySiblingFile(path, temp_path);
+    if (!f)
+      return false;
+
+    bool success = (fwrite(data.data(), 1, data.size(), f) == data.size());
+#ifdef _WIN32
+    success = success && SyncFile(f); //files cannot be flushed once closed
+#endif
+    if (fclose(f) != 0)
+      success = false;
+    if (!success) {
+      remove(temp_path.c_str());
+      return false;
+    }
+
+    CopyFileMode(path, temp_path);
+
+    Entry entry;
+    entry.path = path;
+    entry.temp_path = temp_path;
+    entries_.push_back(entry);
     return true;
   }
 
+  size_t DurableWriteBatch::GetCount() const {
+    return entries_.size();
+  }
+
+  void DurableWriteBatch::Clear() {
+    for (size_t i = 0; i < entries_.size(); i++) {
+      remove(entries_[i].temp_path.c_str());
+    }
+    entries_.clear();
+  }
+
+#ifdef __linux__
+  //flush all the file systems that contains the given files with one syncfs() call per file system.
+  bool SyncFileSystems(const ra::strings::StringVector & paths) {
+    std::vector<uint64_t> devices;
+    for (size_t i = 0; i < paths.size(); i++) {
+      FileInfo info;
+      if (!GetFileInfo(paths[i].c_str(), info))
+        return false;
+      if (std::find(devices.begin(), devices.end(), info.device) != devices.end())
+        continue; //file system already flushed
+
+      int fd = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+        return false;
+      bool success = (syncfs(fd) == 0);
+      close(fd);
+      if (!success)
+        return false;
+      devices.push_back(info.device);
+    }
+    return true;
+  }
+#endif
+
+  bool DurableWriteBatch::Commit() {
+    bool success = true;
+
+    //get the distinct directories of the files
+    ra::strings::StringVector directories;
+    for (size_t i = 0; i < entries_.size(); i++) {
+      std::string directory = GetFileDirectory(entries_[i].path);
+      if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+        directories.push_back(directory);
+    }
+
+    //flush the content of all temporary files
+#ifdef __linux__
+    ra::strings::StringVector temp_paths;
+    for (size_t i = 0; i < entries_.size(); i++) {
+      temp_paths.push_back(entries_[i].temp_path);
+    }
+    success = SyncFileSystems(temp_paths);
+#elif !defined(_WIN32)
+    for (size_t i = 0; i < entries_.size() && success; i++) {
+      FILE * f = fopen(entries_[i].temp_path.c_str(), "rb");
+      success = (f != NULL && SyncFile(f));
+      if (f)
+        fclose(f);
+    }
+#endif
+    if (!success) {
+      Clear();
+      return false;
+    }
+
+    //replace the files
+    for (size_t i = 0; i < entries_.size(); i++) {
+      if (!RenameFileReplace(entries_[i].temp_path, entries_[i].path)) {
+        remove(entries_[i].temp_path.c_str());
+        success = false;
+      }
+    }
+    entries_.clear();
+
+    //make the renames durable
+#ifdef __linux__
+    if (!SyncFileSystems(directories))
+      success = false;
+#else
+    for (size_t i = 0; i < directories.size(); i++) {
+      if (!SyncDirectory(directories[i]))
+        success = false;
+    }
+#endif
+
+    return success;
+  }
+
+  //replace all CRLF sequences by LF in place.
+  void NormalizeNewLines(std::string & content) {
+    if (content.empty())
+      return;
+
+    char * data = &content[0];
+    const char * end = data + content.size();
+    const char * read = (const char *)memchr(data, '\r', content.size());
+    if (read == NULL)
+      return; //nothing to normalize
+    char * write = data + (read - data);
+
+    //read always points to a CR character at the beginning of the loop
+    while (read < end) {
+      if (read + 1 < end && read[1] == '\n')
+        read++; //drop the CR of a CRLF sequence
+      else
+        *write++ = *read++; //keep isolated CR characters
+
+      //move the characters up to the next CR character
+      const char * next = (const char *)memchr(read, '\r', (size_t)(end - read));
+      if (next == NULL)
+        next = end;
+      size_t length = (size_t)(next - read);
+      memmove(write, read, length);
+      write += length;
+      read = next;
+    }
+
+    content.resize((size_t)(write - data));
+  }
+
+  bool ReadTextFile(const std::string & path, ra::strings::StringVector & lines, bool trim_newline_characters) {
+    lines.clear();
+
+    LineReader reader;
+    if (!reader.Open(path, trim_newline_characters))
+      return false;
+
+    const char * data = NULL;
+    size_t size = 0;
+    while (reader.Next(data, size)) {
+      lines.push_back(std::string(data, size));
+#ifdef _WIN32
+      if (!trim_newline_characters)
+        NormalizeNewLines(lines.back()); //CRLF line ending are converted to LF like files opened in text mode
+#endif
+    }
+    return !reader.HasError();
+  }
+
   bool ReadTextFile(const std::string & path, std::string & content) {
-    ra::strings::StringVector lines;
-    bool success = ReadTextFile(path.c_str(), lines, false);
-    if (!success)
+#ifdef _WIN32
+    return ReadTextFile(path, content, true);
+#else
+    return ReadTextFile(path, content, false);
+#endif
+  }
+
+  bool ReadTextFile(const std::string & path, std::string & content, bool normalize_newline_characters) {
+    content.clear();
+
+    FILE * f = fopen(path.c_str(), "rb");
+    if (!f)
+      return false;
+
+    //allocate the buffer once from the file size
+    FileInfo info;
+    uint64_t file_size = 0;
+    if (GetFileInfo(path.c_str(), info))
+      file_size = info.size;
+    if (file_size > (uint64_t)((size_t)-1)) {
+      fclose(f);
+      return false;
+    }
+    content.resize((size_t)file_size);
+
+    size_t read_size = 0;
+    if (file_size > 0)
+      read_size = fread(&content[0], 1, (size_t)file_size, f);
+
+    if (read_size < content.size()) {
+      content.resize(read_size); //file was truncated while reading
+    }
+    else {
+      //read the remaining content of files which size is unknown (ie /proc files) or which have grown
+      char buffer[4096];
+      size_t size_read = 0;
+      while ((size_read = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        content.append(buffer, size_read);
+      }
+    }
+
+    bool success = (ferror(f) == 0);
+    fclose(f);
+    if (!success) {
+      content.clear();
       return false;
+    }
 
-    //merge all lines (including newline characters)
-    content = ra::strings::Join(lines, "");
+    if (normalize_newline_characters)
+      NormalizeNewLines(content);
     return true;
   }
 
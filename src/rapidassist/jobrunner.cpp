@@ -0,0 +1,159 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/jobrunner.h"
+
+#ifndef _WIN32
+
+#include "rapidassist/processmanager.h"
+
+#include <unistd.h>
+#include <map>
+
+namespace ra { namespace process {
+
+  JobRunner::JobRunner() :
+    max_parallelism_(1),
+    listener_(NULL)
+  {
+    long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_processors > 0)
+      max_parallelism_ = (size_t)num_processors;
+  }
+
+  JobRunner::~JobRunner() {
+  }
+
+  void JobRunner::SetMaxParallelism(size_t max_parallelism) {
+    max_parallelism_ = (max_parallelism == 0 ? 1 : max_parallelism);
+  }
+
+  size_t JobRunner::GetMaxParallelism() const {
+    return max_parallelism_;
+  }
+
+  void JobRunner::SetListener(IJobListener * listener) {
+    listener_ = listener;
+  }
+
+  size_t JobRunner::Add(const Job & job) {
+    jobs_.push_back(job);
+    return jobs_.size() - 1;
+  }
+
+  size_t JobRunner::Add(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments) {
+    Job job;
+    job.exec_path = exec_path;
+    job.default_directory = default_directory;
+    job.arguments = arguments;
+    return Add(job);
+  }
+
+  size_t JobRunner::AddCommandLine(const std::string & command_line, const std::string & default_directory) {
+    Job job;
+    job.exec_path = "/bin/sh";
+    job.default_directory = default_directory;
+    job.arguments.push_back("-c");
+    job.arguments.push_back(command_line);
+    return Add(job);
+  }
+
+  size_t JobRunner::GetJobCount() const {
+    return jobs_.size();
+  }
+
+  bool JobRunner::Run() {
+    typedef std::map<size_t, ProcessHandle> JobHandleMap;
+
+    results_.clear();
+    results_.resize(jobs_.size());
+
+    ProcessManager manager;
+    JobHandleMap running;
+    size_t next = 0;
+    bool success = true;
+
+    while (next < jobs_.size() || !running.empty()) {
+      //start jobs until the maximum parallelism is reached
+      while (running.size() < max_parallelism_ && next < jobs_.size()) {
+        const Job & job = jobs_[next];
+        JobResult & result = results_[next];
+        result.index = next;
+        result.exit_code = -1;
+        result.term_signal = 0;
+        result.runtime = 0.0;
+        ProcessHandle handle = manager.Start(job.exec_path, job.default_directory, job.arguments);
+        result.pid = handle.GetProcessId();
+        if (!handle.IsValid()) {
+          success = false;
+          if (listener_)
+            listener_->OnJobExit(job, result);
+        }
+        else
+          running[next] = handle;
+        next++;
+      }
+
+      if (running.empty())
+        continue;
+
+      //wait for any job to terminate
+      if (manager.Poll(-1) == 0)
+        continue;
+
+      //collect the results of the terminated jobs
+      JobHandleMap::iterator it = running.begin();
+      while (it != running.end()) {
+        if (!it->second.IsCompleted()) {
+          it++;
+          continue;
+        }
+
+        const size_t index = it->first;
+        const ProcessResult & process_result = it->second.GetResult();
+        JobResult & result = results_[index];
+        result.exit_code = process_result.exit_code;
+        result.term_signal = process_result.term_signal;
+        result.runtime = process_result.runtime;
+        if (result.exit_code != 0)
+          success = false;
+        if (listener_)
+          listener_->OnJobExit(jobs_[index], result);
+
+        running.erase(it++);
+      }
+    }
+
+    jobs_.clear();
+    return success;
+  }
+
+  const JobResultList & JobRunner::GetResults() const {
+    return results_;
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
@@ -0,0 +1,171 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/linereader.h"
+
+#include <string.h> //for memchr(), memmove()
+
+namespace ra { namespace filesystem {
+
+  const size_t LineReader::DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+  LineReader::LineReader() :
+    file_(NULL),
+    trim_newline_characters_(true),
+    eof_(false),
+    error_(false),
+    begin_(0),
+    end_(0),
+    scan_(0),
+    line_count_(0)
+  {
+  }
+
+  LineReader::~LineReader() {
+    Close();
+  }
+
+  bool LineReader::Open(const std::string & path, bool trim_newline_characters) {
+    return Open(path, trim_newline_characters, DEFAULT_BUFFER_SIZE);
+  }
+
+  bool LineReader::Open(const std::string & path, bool trim_newline_characters, size_t buffer_size) {
+    Close();
+
+    if (buffer_size == 0)
+      buffer_size = DEFAULT_BUFFER_SIZE;
+
+    //the file is read in binary mode to find new-line characters with memchr()
+    file_ = fopen(path.c_str(), "rb");
+    if (!file_)
+      return false;
+
+    trim_newline_characters_ = trim_newline_characters;
+    buffer_.resize(buffer_size);
+    return true;
+  }
+
+  void LineReader::Close() {
+    if (file_)
+      fclose(file_);
+    file_ = NULL;
+    eof_ = false;
+    error_ = false;
+    begin_ = 0;
+    end_ = 0;
+    scan_ = 0;
+    line_count_ = 0;
+    std::vector<char>().swap(buffer_); //release memory
+  }
+
+  bool LineReader::IsOpen() const {
+    return file_ != NULL;
+  }
+
+  bool LineReader::Next(const char *& data, size_t & size) {
+    if (!file_)
+      return false;
+
+    while (true) {
+      char * base = &buffer_[0];
+
+      //search for the end of the line in the characters not scanned yet
+      const char * newline = (const char *)memchr(base + scan_, '\n', end_ - scan_);
+      size_t line_end = 0;
+      if (newline) {
+        line_end = (size_t)(newline - base) + 1;
+      }
+      else if (eof_) {
+        if (begin_ == end_)
+          return false; //no more lines
+        line_end = end_; //last line without new-line character
+      }
+      else {
+        scan_ = end_;
+        if (!Fill())
+          return false;
+        continue;
+      }
+
+      data = base + begin_;
+      size = line_end - begin_;
+      if (trim_newline_characters_) {
+        if (size > 0 && data[size - 1] == '\n')
+          size--;
+        if (size > 0 && data[size - 1] == '\r')
+          size--;
+      }
+
+      begin_ = line_end;
+      scan_ = line_end;
+      line_count_++;
+      return true;
+    }
+  }
+
+  bool LineReader::Next(std::string & line) {
+    const char * data = NULL;
+    size_t size = 0;
+    if (!Next(data, size))
+      return false;
+    line.assign(data, size);
+    return true;
+  }
+
+  uint64_t LineReader::GetLineCount() const {
+    return line_count_;
+  }
+
+  bool LineReader::HasError() const {
+    return error_;
+  }
+
+  //read the next block of the file after the current partial line.
+  bool LineReader::Fill() {
+    //move the current partial line at the beginning of the buffer
+    if (begin_ > 0) {
+      memmove(&buffer_[0], &buffer_[begin_], end_ - begin_);
+      end_ -= begin_;
+      scan_ -= begin_;
+      begin_ = 0;
+    }
+
+    //grow the buffer if the current line is longer than the buffer
+    if (end_ == buffer_.size())
+      buffer_.resize(buffer_.size() * 2);
+
+    size_t size_read = fread(&buffer_[end_], 1, buffer_.size() - end_, file_);
+    end_ += size_read;
+    if (size_read == 0) {
+      eof_ = true;
+      if (ferror(file_)) {
+        error_ = true;
+        return false;
+      }
+    }
+    return true;
+  }
+
+} //namespace filesystem
+} //namespace ra
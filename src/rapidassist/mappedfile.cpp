@@ -0,0 +1,187 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/mappedfile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "rapidassist/undef_windows_macros.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h> //for mmap(), madvise()
+#include <fcntl.h>    //for open()
+#include <unistd.h>   //for close(), sysconf()
+#endif
+
+namespace ra { namespace filesystem {
+
+  MappedFile::MappedFile() :
+    data_(NULL),
+    size_(0),
+    is_open_(false)
+  {
+  }
+
+  MappedFile::~MappedFile() {
+    Close();
+  }
+
+  bool MappedFile::Open(const std::string & path) {
+    return Open(path, ACCESS_SEQUENTIAL);
+  }
+
+  bool MappedFile::Open(const std::string & path, AccessPattern pattern) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+      (pattern == ACCESS_SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : (pattern == ACCESS_RANDOM ? FILE_FLAG_RANDOM_ACCESS : FILE_ATTRIBUTE_NORMAL)), NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+      CloseHandle(file);
+      return false;
+    }
+    uint64_t size = (uint64_t)file_size.QuadPart;
+    if (size > (uint64_t)((size_t)-1)) {
+      CloseHandle(file);
+      return false; //file does not fit in the address space
+    }
+
+    //empty files cannot be mapped
+    if (size == 0) {
+      CloseHandle(file);
+      is_open_ = true;
+      return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+      CloseHandle(file);
+      return false;
+    }
+    void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    //the view keeps a reference to the mapping and the file
+    CloseHandle(mapping);
+    CloseHandle(file);
+    if (view == NULL)
+      return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+      return false;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode)) {
+      close(fd);
+      return false;
+    }
+    uint64_t size = (uint64_t)sb.st_size;
+    if (size > (uint64_t)((size_t)-1)) {
+      close(fd);
+      return false; //file does not fit in the address space
+    }
+
+    //empty files cannot be mapped
+    if (size == 0) {
+      close(fd);
+      is_open_ = true;
+      return true;
+    }
+
+    void * view = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    //the mapping keeps a reference to the file
+    close(fd);
+    if (view == MAP_FAILED)
+      return false;
+
+    switch (pattern) {
+    case ACCESS_SEQUENTIAL:
+      madvise(view, (size_t)size, MADV_SEQUENTIAL);
+      madvise(view, (size_t)size, MADV_WILLNEED);
+      break;
+    case ACCESS_RANDOM:
+      madvise(view, (size_t)size, MADV_RANDOM);
+      break;
+    default:
+      break;
+    };
+#endif
+
+    data_ = (uint8_t *)view;
+    size_ = size;
+    is_open_ = true;
+    return true;
+  }
+
+  void MappedFile::Close() {
+    if (data_ != NULL) {
+#ifdef _WIN32
+      UnmapViewOfFile(data_);
+#else
+      munmap(data_, (size_t)size_);
+#endif
+    }
+    data_ = NULL;
+    size_ = 0;
+    is_open_ = false;
+  }
+
+  bool MappedFile::IsOpen() const {
+    return is_open_;
+  }
+
+  const uint8_t * MappedFile::GetData() const {
+    return data_;
+  }
+
+  uint64_t MappedFile::GetSize() const {
+    return size_;
+  }
+
+  bool MappedFile::WillNeed(uint64_t offset, uint64_t length) {
+    if (data_ == NULL || offset >= size_)
+      return false;
+    if (length > size_ - offset)
+      length = size_ - offset;
+
+#ifdef _WIN32
+    //PrefetchVirtualMemory() is not available on all supported versions of Windows
+    return true;
+#else
+    //madvise() requires an address aligned on a page boundary
+    static const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t aligned_offset = offset - (offset % page_size);
+    length += offset - aligned_offset;
+    return (madvise(data_ + aligned_offset, (size_t)length, MADV_WILLNEED) == 0);
+#endif
+  }
+
+} //namespace filesystem
+} //namespace ra
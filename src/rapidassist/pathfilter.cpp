@@ -0,0 +1,375 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/pathfilter.h"
+#include "rapidassist/filesystem.h"
+
+#include <string.h> //for strcmp()
+
+namespace ra { namespace filesystem {
+
+  static const char * ANY_DIRECTORIES = "**";
+
+  //match a character against a character class such as [a-z] or [!0-9].
+  //returns false if the class is not terminated by ']'.
+  bool MatchCharacterClass(const char * pattern, char c, const char ** next, bool * matched) {
+    const char * p = pattern + 1; //skip '['
+    bool negated = false;
+    if (*p == '!' || *p == '^') {
+      negated = true;
+      p++;
+    }
+
+    bool found = false;
+    bool first = true;
+    while (*p != '\0' && (*p != ']' || first)) {
+      first = false;
+      char low = *p;
+      if (low == '\\' && p[1] != '\0')
+        low = *(++p);
+      char high = low;
+      if (p[1] == '-' && p[2] != ']' && p[2] != '\0') {
+        high = p[2];
+        if (high == '\\' && p[3] != '\0') {
+          high = p[3];
+          p++;
+        }
+        p += 2;
+      }
+      if (c >= low && c <= high)
+        found = true;
+      p++;
+    }
+    if (*p != ']')
+      return false;
+
+    *next = p + 1;
+    *matched = (found != negated);
+    return true;
+  }
+
+  //match a single path element against a single pattern element.
+  bool MatchName(const char * pattern, const char * name) {
+    const char * star_pattern = NULL;
+    const char * star_name = NULL;
+    while (*name != '\0') {
+      if (*pattern == '*') {
+        //remember the position for backtracking
+        while (*pattern == '*')
+          pattern++;
+        star_pattern = pattern;
+        star_name = name;
+        continue;
+      }
+
+      bool matched = false;
+      const char * next = pattern + 1;
+      if (*pattern == '?') {
+        matched = true;
+      }
+      else if (*pattern == '[' && MatchCharacterClass(pattern, *name, &next, &matched)) {
+        //matched is set
+      }
+      else if (*pattern == '\\' && pattern[1] != '\0') {
+        matched = (pattern[1] == *name);
+        next = pattern + 2;
+      }
+      else if (*pattern != '\0') {
+        matched = (*pattern == *name);
+      }
+
+      if (matched) {
+        pattern = next;
+        name++;
+      }
+      else if (star_pattern != NULL) {
+        //let the last '*' match one more character
+        pattern = star_pattern;
+        name = ++star_name;
+      }
+      else
+        return false;
+    }
+
+    while (*pattern == '*')
+      pattern++;
+    return (*pattern == '\0');
+  }
+
+  //split a relative path into elements. Empty elements are ignored.
+  void SplitRelativePath(const std::string & path, ra::strings::StringVector & names) {
+    names.clear();
+    std::string name;
+    for (size_t i = 0; i < path.size(); i++) {
+      char c = path[i];
+#ifdef _WIN32
+      bool is_separator = (c == '/' || c == '\\');
+#else
+      bool is_separator = (c == '/');
+#endif
+      if (is_separator) {
+        if (!name.empty())
+          names.push_back(name);
+        name.clear();
+      }
+      else
+        name.push_back(c);
+    }
+    if (!name.empty())
+      names.push_back(name);
+  }
+
+  GlobPattern::GlobPattern() :
+    negated_(false),
+    directory_only_(false)
+  {
+  }
+
+  GlobPattern::~GlobPattern() {
+  }
+
+  bool GlobPattern::Compile(const std::string & pattern) {
+    pattern_ = pattern;
+    segments_.clear();
+    negated_ = false;
+    directory_only_ = false;
+
+    std::string value = pattern;
+
+    //remove end of line characters and trailing spaces (unless escaped)
+    while (!value.empty() && (value[value.size() - 1] == '\n' || value[value.size() - 1] == '\r'))
+      value.erase(value.size() - 1);
+    while (!value.empty() && value[value.size() - 1] == ' ' && !(value.size() >= 2 && value[value.size() - 2] == '\\'))
+      value.erase(value.size() - 1);
+
+    //blank lines and comments
+    if (value.empty() || value[0] == '#')
+      return false;
+
+    if (value[0] == '!') {
+      negated_ = true;
+      value.erase(0, 1);
+    }
+    else if (value.size() >= 2 && value[0] == '\\' && (value[1] == '!' || value[1] == '#')) {
+      value.erase(0, 1);
+    }
+
+    if (!value.empty() && value[value.size() - 1] == '/') {
+      directory_only_ = true;
+      value.erase(value.size() - 1);
+    }
+
+    //a separator at the beginning or in the middle of the pattern makes it relative to the root directory
+    bool anchored = (value.find('/') != std::string::npos);
+
+    ra::strings::StringVector segments = ra::strings::Split(value, '/');
+    for (size_t i = 0; i < segments.size(); i++) {
+      const std::string & segment = segments[i];
+      if (segment.empty())
+        continue;
+      //consecutive '**' are equivalent to a single one
+      if (segment == ANY_DIRECTORIES && !segments_.empty() && segments_.back() == ANY_DIRECTORIES)
+        continue;
+      segments_.push_back(segment);
+    }
+    if (segments_.empty())
+      return false;
+
+    //a filename pattern matches at any depth
+    if (!anchored && segments_[0] != ANY_DIRECTORIES)
+      segments_.insert(segments_.begin(), ANY_DIRECTORIES);
+
+    return true;
+  }
+
+  const std::string & GlobPattern::GetPattern() const {
+    return pattern_;
+  }
+
+  bool GlobPattern::IsNegated() const {
+    return negated_;
+  }
+
+  bool GlobPattern::IsDirectoryOnly() const {
+    return directory_only_;
+  }
+
+  bool GlobPattern::Match(const std::string & path, bool is_directory) const {
+    ra::strings::StringVector names;
+    SplitRelativePath(path, names);
+    return Match(names, is_directory);
+  }
+
+  bool GlobPattern::Match(const ra::strings::StringVector & names, bool is_directory) const {
+    if (segments_.empty() || names.empty())
+      return false;
+    if (directory_only_ && !is_directory)
+      return false;
+
+    //fast path for filename patterns: only the last element can match
+    if (segments_.size() == 2 && segments_[0] == ANY_DIRECTORIES)
+      return MatchName(segments_[1].c_str(), names.back().c_str());
+
+    return MatchNames(0, names, 0);
+  }
+
+  bool GlobPattern::MatchNames(size_t segment_index, const ra::strings::StringVector & names, size_t name_index) const {
+    while (segment_index < segments_.size()) {
+      const std::string & segment = segments_[segment_index];
+      if (segment == ANY_DIRECTORIES) {
+        //a trailing '**' matches everything inside a directory but not the directory itself
+        if (segment_index + 1 == segments_.size())
+          return (name_index < names.size() && segment_index > 0) || (segment_index == 0);
+
+        //try matching zero or more directories
+        for (size_t i = name_index; i < names.size(); i++) {
+          if (MatchNames(segment_index + 1, names, i))
+            return true;
+        }
+        return false;
+      }
+
+      if (name_index >= names.size())
+        return false;
+      if (!MatchName(segment.c_str(), names[name_index].c_str()))
+        return false;
+      segment_index++;
+      name_index++;
+    }
+
+    return (name_index == names.size());
+  }
+
+  PathFilter::PathFilter() {
+  }
+
+  PathFilter::~PathFilter() {
+  }
+
+  void PathFilter::Clear() {
+    includes_.clear();
+    excludes_.clear();
+  }
+
+  bool PathFilter::AddIncludePattern(const std::string & pattern) {
+    GlobPattern glob;
+    if (!glob.Compile(pattern))
+      return false;
+    includes_.push_back(glob);
+    return true;
+  }
+
+  bool PathFilter::AddExcludePattern(const std::string & pattern) {
+    GlobPattern glob;
+    if (!glob.Compile(pattern))
+      return false;
+    excludes_.push_back(glob);
+    return true;
+  }
+
+  bool PathFilter::LoadIgnoreFile(const std::string & path) {
+    ra::strings::StringVector lines;
+    if (!ReadTextFile(path, lines, true))
+      return false;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+      AddExcludePattern(lines[i]); //blank lines and comments are ignored
+    }
+    return true;
+  }
+
+  size_t PathFilter::GetIncludeCount() const {
+    return includes_.size();
+  }
+
+  size_t PathFilter::GetExcludeCount() const {
+    return excludes_.size();
+  }
+
+  bool PathFilter::Evaluate(const GlobPatternList & patterns, const ra::strings::StringVector & names, bool is_directory, bool default_value) {
+    //the last matching pattern wins
+    for (size_t i = patterns.size(); i > 0; i--) {
+      const GlobPattern & pattern = patterns[i - 1];
+      if (pattern.Match(names, is_directory))
+        return !pattern.IsNegated();
+    }
+    return default_value;
+  }
+
+  bool PathFilter::IsExcluded(const std::string & path, bool is_directory) const {
+    ra::strings::StringVector names;
+    SplitRelativePath(path, names);
+    if (names.empty())
+      return false;
+
+    //check each parent directory
+    ra::strings::StringVector parents;
+    for (size_t i = 0; i + 1 < names.size(); i++) {
+      parents.push_back(names[i]);
+      if (IsExcluded(parents, true))
+        return true;
+    }
+    return IsExcluded(names, is_directory);
+  }
+
+  bool PathFilter::IsExcluded(const ra::strings::StringVector & names, bool is_directory) const {
+    return Evaluate(excludes_, names, is_directory, false);
+  }
+
+  bool PathFilter::IsIncluded(const ra::strings::StringVector & names, bool is_directory) const {
+    if (includes_.empty())
+      return true;
+    return Evaluate(includes_, names, is_directory, false);
+  }
+
+  bool FindFiles(ra::strings::StringVector & files, const char * path, int depth, const PathFilter & filter) {
+    DirectoryIterator iterator;
+    if (!iterator.Open(path, depth))
+      return false;
+
+    //the relative path of the current entry, updated as the iterator goes up and down the tree
+    ra::strings::StringVector names;
+
+    DirectoryEntry entry;
+    while (iterator.Next(entry)) {
+      names.resize(entry.depth + 1);
+      names[entry.depth] = entry.name;
+
+      const bool is_directory = (entry.type == ENTRY_DIRECTORY);
+      if (filter.IsExcluded(names, is_directory)) {
+        //do not open excluded directories
+        if (is_directory)
+          iterator.SkipSubtree();
+        continue;
+      }
+
+      if (filter.IsIncluded(names, is_directory))
+        files.push_back(entry.path);
+    }
+
+    return true;
+  }
+
+} //namespace filesystem
+} //namespace ra
@@ -0,0 +1,290 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/pathtree.h"
+
+#include <algorithm> //for std::sort()
+#include <string.h>  //for strlen(), strcmp()
+
+namespace ra { namespace filesystem {
+
+  static const uint32_t NO_PARENT = 0xFFFFFFFF;
+  static const uint8_t MAX_STORED_DEPTH = 0xFF;
+
+  const size_t PathTree::INVALID_INDEX;
+
+  PathTree::PathTree() {
+  }
+
+  PathTree::~PathTree() {
+  }
+
+  void PathTree::Clear() {
+    nodes_.clear();
+    names_.clear();
+    root_.clear();
+    prefix_.clear();
+  }
+
+  void PathTree::SetRootPath(const std::string & path) {
+    root_ = path;
+    NormalizePath(root_);
+
+    //entries of the root directory are prefixed by the root path and a separator, like FindFiles()
+    prefix_.clear();
+    if (!path.empty()) {
+      prefix_ = root_;
+      prefix_.append(GetPathSeparatorStr());
+    }
+  }
+
+  const std::string & PathTree::GetRootPath() const {
+    return root_;
+  }
+
+  size_t PathTree::GetCount() const {
+    return nodes_.size();
+  }
+
+  size_t PathTree::Add(size_t parent, const char * name, DirectoryEntryType type) {
+    if (name == NULL)
+      return INVALID_INDEX;
+    if (parent != INVALID_INDEX && parent >= nodes_.size())
+      return INVALID_INDEX;
+    if (nodes_.size() >= (size_t)NO_PARENT)
+      return INVALID_INDEX; //too many entries
+
+    size_t length = strlen(name);
+    if (length > 0xFFFF)
+      return INVALID_INDEX;
+
+    Node node;
+    node.name_offset = names_.size();
+    node.name_length = (uint16_t)length;
+    node.type = (uint8_t)type;
+    if (parent == INVALID_INDEX) {
+      node.parent = NO_PARENT;
+      node.depth = 0;
+    }
+    else {
+      const Node & parent_node = nodes_[parent];
+      node.parent = (uint32_t)parent;
+      node.depth = (parent_node.depth == MAX_STORED_DEPTH ? MAX_STORED_DEPTH : parent_node.depth + 1);
+    }
+
+    names_.append(name, length);
+    names_.push_back('\0');
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+  }
+
+  size_t PathTree::GetParent(size_t index) const {
+    if (index >= nodes_.size())
+      return INVALID_INDEX;
+    const Node & node = nodes_[index];
+    if (node.parent == NO_PARENT)
+      return INVALID_INDEX;
+    return node.parent;
+  }
+
+  const char * PathTree::GetName(size_t index) const {
+    if (index >= nodes_.size())
+      return NULL;
+    return names_.c_str() + nodes_[index].name_offset;
+  }
+
+  DirectoryEntryType PathTree::GetType(size_t index) const {
+    if (index >= nodes_.size())
+      return ENTRY_UNKNOWN;
+    return (DirectoryEntryType)nodes_[index].type;
+  }
+
+  int PathTree::GetDepth(size_t index) const {
+    if (index >= nodes_.size())
+      return -1;
+    const Node & node = nodes_[index];
+    if (node.depth < MAX_STORED_DEPTH)
+      return node.depth;
+
+    //count the parents of deep entries
+    int depth = 0;
+    size_t parent = GetParent(index);
+    while (parent != INVALID_INDEX) {
+      depth++;
+      parent = GetParent(parent);
+    }
+    return depth;
+  }
+
+  void PathTree::GetPath(size_t index, std::string & path) const {
+    path.clear();
+    if (index >= nodes_.size())
+      return;
+
+    //compute the length of the path to allocate the string once
+    const char separator = GetPathSeparator();
+    size_t length = prefix_.size();
+    size_t current = index;
+    while (current != INVALID_INDEX) {
+      length += nodes_[current].name_length;
+      current = GetParent(current);
+      if (current != INVALID_INDEX)
+        length++; //separator
+    }
+
+    //fill the path from the end
+    path.resize(length);
+    size_t position = length;
+    current = index;
+    while (current != INVALID_INDEX) {
+      const Node & node = nodes_[current];
+      position -= node.name_length;
+      if (node.name_length > 0)
+        memcpy(&path[position], names_.c_str() + node.name_offset, node.name_length);
+      current = GetParent(current);
+      if (current != INVALID_INDEX)
+        path[--position] = separator;
+    }
+    if (!prefix_.empty())
+      memcpy(&path[0], prefix_.c_str(), prefix_.size());
+  }
+
+  std::string PathTree::GetPath(size_t index) const {
+    std::string path;
+    GetPath(index, path);
+    return path;
+  }
+
+  //orders nodes by parent, then by name
+  struct NodeOrder {
+    NodeOrder(const std::vector<uint32_t> & parents, const char * names, const std::vector<size_t> & offsets) :
+      parents_(parents), names_(names), offsets_(offsets)
+    {
+    }
+    bool operator()(size_t a, size_t b) const {
+      //entries of the root directory first
+      uint32_t parent_a = parents_[a] + 1;
+      uint32_t parent_b = parents_[b] + 1;
+      if (parent_a != parent_b)
+        return parent_a < parent_b;
+      return strcmp(names_ + offsets_[a], names_ + offsets_[b]) < 0;
+    }
+    const std::vector<uint32_t> & parents_;
+    const char * names_;
+    const std::vector<size_t> & offsets_;
+  };
+
+  void PathTree::GetSortedIndices(std::vector<size_t> & indices) const {
+    indices.clear();
+    const size_t count = nodes_.size();
+    if (count == 0)
+      return;
+
+    //group siblings together and sort them by name
+    std::vector<uint32_t> parents(count);
+    std::vector<size_t> offsets(count);
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+      parents[i] = nodes_[i].parent;
+      offsets[i] = nodes_[i].name_offset;
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), NodeOrder(parents, names_.c_str(), offsets));
+
+    //find the range of children of each node. Slot 0 is for the root directory.
+    std::vector<size_t> first_child(count + 1, 0);
+    std::vector<size_t> last_child(count + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+      size_t slot = (size_t)(parents[order[i]] + 1);
+      if (last_child[slot] == 0)
+        first_child[slot] = i;
+      last_child[slot] = i + 1;
+    }
+
+    //depth-first traversal
+    indices.reserve(count);
+    std::vector<std::pair<size_t, size_t> > stack; //ranges of siblings in order
+    stack.push_back(std::pair<size_t, size_t>(first_child[0], last_child[0]));
+    while (!stack.empty()) {
+      std::pair<size_t, size_t> & range = stack.back();
+      if (range.first == range.second) {
+        stack.pop_back();
+        continue;
+      }
+      size_t index = order[range.first];
+      range.first++;
+      indices.push_back(index);
+
+      size_t slot = index + 1;
+      if (last_child[slot] != 0)
+        stack.push_back(std::pair<size_t, size_t>(first_child[slot], last_child[slot]));
+    }
+  }
+
+  void PathTree::GetPaths(ra::strings::StringVector & files) const {
+    files.clear();
+    files.resize(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); i++) {
+      GetPath(i, files[i]);
+    }
+  }
+
+  size_t PathTree::GetMemoryUsage() const {
+    return sizeof(PathTree) + nodes_.capacity() * sizeof(Node) + names_.capacity() + root_.capacity() + prefix_.capacity();
+  }
+
+  bool PathTree::FindFiles(const char * path, int depth) {
+    Clear();
+    if (path == NULL)
+      return false;
+
+    DirectoryIterator iterator;
+    if (!iterator.Open(path, depth))
+      return false;
+    SetRootPath(path);
+
+    //the iterator returns each directory before its content.
+    //the parent of an entry is always the last directory of the previous depth.
+    std::vector<size_t> directories; //index of the last directory at each depth
+    DirectoryEntry entry;
+    while (iterator.Next(entry)) {
+      size_t parent = INVALID_INDEX;
+      if (entry.depth > 0)
+        parent = directories[entry.depth - 1];
+
+      size_t index = Add(parent, entry.name.c_str(), entry.type);
+      if (index == INVALID_INDEX)
+        return false;
+
+      if (entry.type == ENTRY_DIRECTORY) {
+        directories.resize(entry.depth + 1);
+        directories[entry.depth] = index;
+      }
+    }
+
+    return true;
+  }
+
+} //namespace filesystem
+} //namespace ra
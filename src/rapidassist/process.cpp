@@ -48,9 +48,32 @@
 #   include <spawn.h>
 #   include <sys/wait.h>
 #   include <errno.h>
+#   include <string.h>
+#   include <fcntl.h>
+#   include <sys/resource.h>  // for setrlimit()
 extern char **environ;
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+#   include <poll.h>         // for poll()
+#endif
+#if defined(__linux__)
+#   include <sys/syscall.h>  // for SYS_pidfd_open, SYS_getdents64
+#   include <dirent.h>       // for DT_DIR
+#   include <stdio.h>        // for snprintf()
+#   include <stdint.h>
+#   include <sched.h>        // for sched_setaffinity()
+
+/// <summary>Directory entry returned by the getdents64() system call.</summary>
+struct linux_dirent64 {
+  uint64_t        d_ino;
+  int64_t         d_off;
+  unsigned short  d_reclen;
+  unsigned char   d_type;
+  char            d_name[1];
+};
+#endif
+
 #if defined(__APPLE__)
 #include <mach-o/dyld.h>  // for _NSGetExecutablePath()
 #include <libproc.h>      // for proc_listpids()
@@ -292,41 +315,127 @@ namespace ra { namespace process {
   ///=========================================================================================
 
   /// <summary>
-  /// Get the process state of the given process id.
+  /// Read the content of the '/proc/[pid]/stat' file of the given process id.
   /// </summary>
+  /// <param name="proc_fd">A directory file descriptor of '/proc'. Set to -1 to use absolute paths.</param>
   /// <param name="pid">The process id of the process.</param>
-  /// <param name="state">The process state of the given process id.</param>
+  /// <param name="buffer">The output buffer. The content is NULL terminated.</param>
+  /// <param name="size">The size of the output buffer in bytes.</param>
+  /// <returns>Returns the number of bytes read. Returns 0 on error.</returns>
+  size_t ReadProcessStatFile(int proc_fd, const processid_t & pid, char * buffer, size_t size) {
+    char path[64];
+    int fd = -1;
+    if (proc_fd >= 0) {
+      snprintf(path, sizeof(path), "%d/stat", (int)pid);
+      fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    }
+    else {
+      snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+      fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0)
+      return 0;
+
+    //the file is generated by the kernel in a single read
+    ssize_t length = 0;
+    do {
+      length = read(fd, buffer, size - 1);
+    } while (length < 0 && errno == EINTR);
+    close(fd);
+    if (length <= 0)
+      return 0;
+    buffer[length] = '\0';
+    return (size_t)length;
+  }
+
+  /// <summary>
+  /// Find the fields that follows the process name in the content of a '/proc/[pid]/stat' file.
+  /// The process name is enclosed in parentheses and may contain spaces or parentheses.
+  /// </summary>
+  /// <param name="buffer">The NULL terminated content of the stat file.</param>
+  /// <param name="name">The process name.</param>
+  /// <returns>Returns a pointer to the process state field. Returns NULL on error.</returns>
+  const char * ParseProcessStatName(const char * buffer, std::string * name) {
+    const char * name_start = strchr(buffer, '(');
+    const char * name_end = strrchr(buffer, ')');
+    if (name_start == NULL || name_end == NULL || name_end < name_start)
+      return NULL;
+    if (name_end[1] != ' ' || name_end[2] == '\0')
+      return NULL;
+    if (name)
+      name->assign(name_start + 1, name_end);
+    return name_end + 2;
+  }
+
+  /// <summary>
+  /// Enumerate the process ids of the system by reading the entries of '/proc' with getdents64().
+  /// The process ids are parsed from the directory entry names, without building paths.
+  /// </summary>
+  /// <param name="proc_fd">A directory file descriptor of '/proc'.</param>
+  /// <param name="buffer">A buffer for reading directory entries.</param>
+  /// <param name="size">The size of the buffer in bytes.</param>
+  /// <param name="pids">The output list of process ids.</param>
   /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
-  bool GetProcessState(const processid_t & pid, char & state) {
-    std::string stat_path = std::string("/proc/") + ra::strings::ToString(pid) + "/stat";
-    bool exists = ra::filesystem::FileExists(stat_path.c_str());
-    if (!exists)
-      return false;
+  bool ReadProcessIds(int proc_fd, char * buffer, size_t size, ProcessIdList & pids) {
+    pids.clear();
 
-    FILE * f = fopen(stat_path.c_str(), "r");
-    if (!f)
+    //rewind to enumerate all entries again when a file descriptor is reused
+    if (lseek(proc_fd, 0, SEEK_SET) != 0)
       return false;
 
-    //read first 1024 bytes
-    static const int BUFFER_SIZE = 1024;
-    char buffer[BUFFER_SIZE];
-    char * tmp = fgets(buffer, BUFFER_SIZE, f);
-    buffer[BUFFER_SIZE - 1] = '\0';
-    fclose(f);
-
-    //split each token into a list
-    ra::strings::StringVector tokens;
-    ra::strings::Split(tokens, buffer, ' ');
+    while (true) {
+      long length = syscall(SYS_getdents64, proc_fd, buffer, size);
+      if (length < 0 && errno == EINTR)
+        continue;
+      if (length < 0)
+        return false;
+      if (length == 0)
+        break; //end of directory
+
+      long offset = 0;
+      while (offset < length) {
+        const struct linux_dirent64 * entry = (const struct linux_dirent64 *)(buffer + offset);
+        offset += entry->d_reclen;
+
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+          continue;
+
+        //process directories are made of digits only
+        const char * name = entry->d_name;
+        if (*name == '\0')
+          continue;
+        processid_t pid = 0;
+        bool numeric = true;
+        for (; *name != '\0' && numeric; name++) {
+          if (*name < '0' || *name > '9')
+            numeric = false;
+          else
+            pid = pid * 10 + (*name - '0');
+        }
+        if (numeric)
+          pids.push_back(pid);
+      }
+    }
 
-    //assert the Minimum number of tokens
-    if (tokens.size() < 3)
-      return false; //not enough tokens
+    return true;
+  }
 
-    const std::string & pid_s = tokens[0];
-    const std::string & name_s = tokens[1];
-    const std::string & state_s = tokens[2];
+  /// <summary>
+  /// Get the process state of the given process id.
+  /// </summary>
+  /// <param name="proc_fd">A directory file descriptor of '/proc'. Set to -1 to use absolute paths.</param>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="state">The process state of the given process id.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessState(int proc_fd, const processid_t & pid, char & state) {
+    char buffer[1024];
+    if (ReadProcessStatFile(proc_fd, pid, buffer, sizeof(buffer)) == 0)
+      return false;
 
-    if (state_s.size() != 1)
+    const char * fields = ParseProcessStatName(buffer, NULL);
+    if (fields == NULL)
+      return false;
+    if (fields[0] == '\0' || (fields[1] != ' ' && fields[1] != '\0'))
       return false; //not a state
 
     //read the process state expecting one of the following characters:
@@ -337,12 +446,22 @@ namespace ra { namespace process {
     // W paging (not valid since the 2.6.xx kernel)
     // X dead (should never be seen)
     // Z Defunct ("zombie") process, terminated but not reaped by its parent.
-    // I ?????
-    state = state_s[0];
+    // I Idle kernel thread.
+    state = fields[0];
 
     return true;
   }
 
+  /// <summary>
+  /// Get the process state of the given process id.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <param name="state">The process state of the given process id.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool GetProcessState(const processid_t & pid, char & state) {
+    return GetProcessState(-1, pid, state);
+  }
+
   /// <summary>
   /// Define if a process is running or not.
   /// A zombie process is not considered running.
@@ -371,6 +490,381 @@ namespace ra { namespace process {
     return zombie;
   }
 
+  /// <summary>
+  /// Wait for the given process termination using a process file descriptor (pidfd).
+  /// The process is not reaped which allows GetExitCode() to be called after the function returns.
+  /// Process file descriptors are available since kernel 5.3.
+  /// </summary>
+  /// <param name="pid">The process id to wait for.</param>
+  /// <returns>Returns true if the process has terminated. Returns false if pidfd is not supported or on error.</returns>
+  bool WaitExitPidfd(const processid_t & pid) {
+#ifdef SYS_pidfd_open
+    int pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (pidfd < 0)
+      return false; //not supported by the kernel or invalid process id
+
+    //a pidfd becomes readable when the process terminates
+    struct pollfd pfd;
+    pfd.fd = pidfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int poll_result = 0;
+    do {
+      poll_result = poll(&pfd, 1, -1);
+    } while (poll_result < 0 && errno == EINTR);
+
+    close(pidfd);
+
+    bool success = (poll_result == 1);
+    return success;
+#else
+    return false;
+#endif
+  }
+
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+  /// <summary>
+  /// Wait for the given child process termination without reaping the process.
+  /// The process exit code is kept which allows GetExitCode() to be called after the function returns.
+  /// </summary>
+  /// <param name="pid">The process id to wait for.</param>
+  /// <returns>Returns true if the process has terminated. Returns false if the process is not a child of the current process or on error.</returns>
+  bool WaitExitNoReap(const processid_t & pid) {
+    siginfo_t info;
+    memset(&info, 0, sizeof(info));
+    int wait_result = 0;
+    do {
+      wait_result = waitid(P_PID, (id_t)pid, &info, WEXITED | WNOWAIT);
+    } while (wait_result < 0 && errno == EINTR);
+
+    bool success = (wait_result == 0);
+    return success;
+  }
+
+  /// <summary>
+  /// Verify if the given options require the new process to be started with ForkExec().
+  /// The priority, affinity and resource limits of a process cannot be set with posix_spawn().
+  /// </summary>
+  /// <param name="options">The options for the new process.</param>
+  /// <returns>Returns true if the options require ForkExec(). Returns false otherwise.</returns>
+  bool IsForkExecRequired(const SpawnOptions & options) {
+    bool required = (options.nice_increment != 0 ||
+                     options.io_priority_class != IO_PRIORITY_CLASS_INHERIT ||
+                     !options.cpu_affinity.empty() ||
+                     !options.resource_limits.empty());
+    return required;
+  }
+
+  /// <summary>
+  /// Apply the priority, affinity and resource limits of the given options to the current process.
+  /// This function is called from a forked child process and must only call async-signal-safe functions.
+  /// </summary>
+  /// <param name="options">The options for the new process.</param>
+  /// <param name="cpu_set">The cpu affinity of the new process, if any.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+#if defined(__linux__)
+  bool ApplySpawnOptions(const SpawnOptions & options, const cpu_set_t & cpu_set) {
+#else
+  bool ApplySpawnOptions(const SpawnOptions & options) {
+#endif
+    if (options.nice_increment != 0) {
+      errno = 0;
+      if (nice(options.nice_increment) == -1 && errno != 0)
+        return false;
+    }
+
+    if (options.io_priority_class != IO_PRIORITY_CLASS_INHERIT) {
+#if defined(__linux__) && defined(SYS_ioprio_set)
+      static const int IOPRIO_WHO_PROCESS = 1;
+      static const int IOPRIO_CLASS_SHIFT = 13;
+      int ioprio = ((int)options.io_priority_class << IOPRIO_CLASS_SHIFT) | options.io_priority_level;
+      if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, ioprio) != 0)
+        return false;
+#else
+      errno = ENOSYS;
+      return false;
+#endif
+    }
+
+    if (!options.cpu_affinity.empty()) {
+#if defined(__linux__)
+      if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+        return false;
+#else
+      errno = ENOSYS;
+      return false;
+#endif
+    }
+
+    for (size_t i = 0; i < options.resource_limits.size(); i++) {
+      const ResourceLimit & limit = options.resource_limits[i];
+      struct rlimit rl;
+      rl.rlim_cur = (rlim_t)limit.soft_limit;
+      rl.rlim_max = (rlim_t)limit.hard_limit;
+      if (setrlimit(limit.resource, &rl) != 0)
+        return false;
+    }
+
+    return true;
+  }
+
+  /// <summary>
+  /// Start the given process by forking the current process.
+  /// The child process changes its own current directory before executing the new program.
+  /// This does not modify the current directory of the current process and is safe to call from multiple threads.
+  /// </summary>
+  /// <param name="exec_path">The path to the executable to start.</param>
+  /// <param name="default_directory">The directory to run the command from.</param>
+  /// <param name="argv">The NULL terminated list of arguments for the new process.</param>
+  /// <param name="options">The options for the new process.</param>
+  /// <returns>Returns the process id when successful. Returns INVALID_PROCESS_ID otherwise.</returns>
+  processid_t ForkExec(const char * exec_path, const char * default_directory, char * const argv[], const SpawnOptions & options) {
+    //a pipe is used to report exec errors from the child process.
+    //the pipe is automatically closed when exec succeeds.
+    int fds[2];
+#if defined(__linux__)
+    if (pipe2(fds, O_CLOEXEC) != 0)
+      return INVALID_PROCESS_ID;
+#else
+    if (pipe(fds) != 0)
+      return INVALID_PROCESS_ID;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+#if defined(__linux__)
+    //prepare the cpu affinity before forking
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (size_t i = 0; i < options.cpu_affinity.size(); i++) {
+      const int & cpu = options.cpu_affinity[i];
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        close(fds[0]);
+        close(fds[1]);
+        return INVALID_PROCESS_ID;
+      }
+      CPU_SET(cpu, &cpu_set);
+    }
+#endif
+
+    pid_t child_pid = fork();
+    if (child_pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return INVALID_PROCESS_ID;
+    }
+
+    if (child_pid == 0) {
+      //child process. Only async-signal-safe functions can be called from here.
+      close(fds[0]);
+      bool ready = true;
+      if (ready && options.new_process_group)
+        ready = (setpgid(0, 0) == 0);
+#if defined(__linux__)
+      if (ready)
+        ready = ApplySpawnOptions(options, cpu_set);
+#else
+      if (ready)
+        ready = ApplySpawnOptions(options);
+#endif
+      if (ready && options.stdin_fd >= 0)
+        ready = (dup2(options.stdin_fd, STDIN_FILENO) >= 0);
+      if (ready && options.stdout_fd >= 0)
+        ready = (dup2(options.stdout_fd, STDOUT_FILENO) >= 0);
+      if (ready && options.stderr_fd >= 0)
+        ready = (dup2(options.stderr_fd, STDERR_FILENO) >= 0);
+      if (ready && chdir(default_directory) == 0)
+        execve(exec_path, argv, environ);
+      int error = errno;
+      ssize_t write_size = write(fds[1], &error, sizeof(error));
+      (void)write_size;
+      _exit(127);
+    }
+
+    //parent process. Also set the process group from the parent to prevent a race
+    //with a caller that signals the group before the child process has executed.
+    if (options.new_process_group)
+      setpgid(child_pid, child_pid);
+
+    //wait for the child process to exec or to report an error.
+    close(fds[1]);
+    int error = 0;
+    ssize_t read_size = 0;
+    do {
+      read_size = read(fds[0], &error, sizeof(error));
+    } while (read_size < 0 && errno == EINTR);
+    close(fds[0]);
+
+    if (read_size > 0) {
+      //exec failed. Remove the zombie process.
+      int status = 0;
+      waitpid(child_pid, &status, 0);
+      return INVALID_PROCESS_ID;
+    }
+
+    return child_pid;
+  }
+
+  /// <summary>
+  /// Create a pipe which file descriptors are closed when a new program is executed.
+  /// </summary>
+  /// <param name="fds">The read and write file descriptors of the pipe.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool CreatePipe(int fds[2]) {
+#if defined(__linux__)
+    bool success = (pipe2(fds, O_CLOEXEC) == 0);
+    return success;
+#else
+    if (pipe(fds) != 0)
+      return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+  }
+
+  /// <summary>
+  /// Defines the result of WaitAnyProcess().
+  /// </summary>
+  enum WaitResult {
+    WAIT_SUCCESS,
+    WAIT_TIMEOUT,
+    WAIT_FAILED,
+  };
+
+  /// <summary>
+  /// Convert a wait status returned by waitpid() to an exit code.
+  /// </summary>
+  /// <param name="status">The wait status of a terminated process.</param>
+  /// <returns>Returns the exit code of the process. Returns -1 if the process was terminated by a signal.</returns>
+  inline int ToExitCode(int status) {
+    if (WIFEXITED(status))
+      return WEXITSTATUS(status);
+    return -1;
+  }
+
+  /// <summary>
+  /// Verify if the given process has terminated without blocking.
+  /// Child processes are reaped.
+  /// </summary>
+  /// <param name="pid">The process id to verify.</param>
+  /// <param name="reaped">True if the process was a child process and was reaped.</param>
+  /// <param name="status">The wait status of the process if the process was reaped.</param>
+  /// <returns>Returns true if the process has terminated. Returns false otherwise.</returns>
+  bool IsTerminated(const processid_t & pid, bool & reaped, int & status) {
+    reaped = false;
+    pid_t result_pid = 0;
+    do {
+      result_pid = waitpid(pid, &status, WNOHANG);
+    } while (result_pid < 0 && errno == EINTR);
+    if (result_pid == pid) {
+      reaped = true;
+      return true;
+    }
+    if (result_pid == 0)
+      return false; //child process still running
+
+    //not a child of the current process
+    bool terminated = !IsRunning(pid);
+    return terminated;
+  }
+
+  /// <summary>
+  /// Wait for the termination of any of the given processes for a maximum amount of time.
+  /// On linux, the processes are waited for with a single call to poll() on process file descriptors.
+  /// </summary>
+  /// <param name="pids">The list of process ids to wait for.</param>
+  /// <param name="timeout_ms">The maximum time to wait in milliseconds. Use 0 to return immediately. Use -1 to wait indefinitely.</param>
+  /// <param name="pid">The process id of the terminated process.</param>
+  /// <param name="reaped">True if the terminated process was a child process and was reaped.</param>
+  /// <param name="status">The wait status of the terminated process if the process was reaped.</param>
+  /// <returns>Returns WAIT_SUCCESS if a process has terminated, WAIT_TIMEOUT if the timeout has expired or WAIT_FAILED on error.</returns>
+  WaitResult WaitAnyProcess(const ProcessIdList & pids, int timeout_ms, processid_t & pid, bool & reaped, int & status) {
+    //the minimum delay between two checks for processes without a pidfd
+    static const int FALLBACK_POLL_INTERVAL_MS = 10;
+
+    if (pids.empty())
+      return WAIT_FAILED;
+
+    uint64_t time_start = ra::timing::GetMillisecondsCounterU64();
+
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    //a process file descriptor becomes readable when the process terminates
+    std::vector<struct pollfd> fds;
+    bool all_pidfd = true;
+    for (size_t i = 0; i < pids.size(); i++) {
+      struct pollfd pfd;
+      pfd.fd = (int)syscall(SYS_pidfd_open, pids[i], 0);
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (pfd.fd < 0)
+        all_pidfd = false;
+      else
+        fds.push_back(pfd);
+    }
+#endif
+
+    WaitResult result = WAIT_TIMEOUT;
+    while (result == WAIT_TIMEOUT) {
+      for (size_t i = 0; i < pids.size() && result == WAIT_TIMEOUT; i++) {
+        if (IsTerminated(pids[i], reaped, status)) {
+          pid = pids[i];
+          result = WAIT_SUCCESS;
+        }
+      }
+      if (result == WAIT_SUCCESS)
+        break;
+
+      //compute remaining time
+      int remaining_ms = -1;
+      if (timeout_ms >= 0) {
+        uint64_t elapsed_ms = ra::timing::GetMillisecondsCounterU64() - time_start;
+        if (elapsed_ms >= (uint64_t)timeout_ms)
+          break;
+        remaining_ms = timeout_ms - (int)elapsed_ms;
+      }
+
+#if defined(__linux__) && defined(SYS_pidfd_open)
+      if (all_pidfd) {
+        int poll_result = poll(&fds[0], fds.size(), remaining_ms);
+        if (poll_result < 0 && errno != EINTR)
+          result = WAIT_FAILED;
+        continue;
+      }
+#endif
+
+      int sleep_ms = FALLBACK_POLL_INTERVAL_MS;
+      if (remaining_ms >= 0 && remaining_ms < sleep_ms)
+        sleep_ms = remaining_ms;
+      ra::timing::Millisleep(sleep_ms);
+    }
+
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    for (size_t i = 0; i < fds.size(); i++) {
+      close(fds[i].fd);
+    }
+#endif
+
+    return result;
+  }
+
+  /// <summary>
+  /// Wait for the termination of the given process for a maximum amount of time.
+  /// </summary>
+  /// <param name="pid">The process id to wait for.</param>
+  /// <param name="timeout_ms">The maximum time to wait in milliseconds. Use -1 to wait indefinitely.</param>
+  /// <returns>Returns WAIT_SUCCESS if the process has terminated, WAIT_TIMEOUT if the timeout has expired or WAIT_FAILED on error.</returns>
+  WaitResult WaitProcess(const processid_t & pid, int timeout_ms) {
+    ProcessIdList pids(1, pid);
+    processid_t terminated_pid = INVALID_PROCESS_ID;
+    bool reaped = false;
+    int status = 0;
+    WaitResult result = WaitAnyProcess(pids, timeout_ms, terminated_pid, reaped, status);
+    return result;
+  }
+
 #endif
 
   std::string ToString(const ProcessIdList & processes) {
@@ -480,35 +974,27 @@ namespace ra { namespace process {
       processes.push_back(pid);
     }
 #elif defined(__linux__)
-    //list processes from the filesystem
-    ra::strings::StringVector files;
-    bool found = ra::filesystem::FindFiles(files, "/proc", 0);
-    if (!found)
+    //list processes from the directory entries of /proc
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0)
       return processes; //failed
-    for (size_t i = 0; i < files.size(); i++) {
-      const std::string & file = files[i];
-
-      //filter out files
-      bool is_directory = ra::filesystem::DirectoryExists(file.c_str());
-      if (!is_directory)
-        continue;
-
-      //filter out directories that are not numeric.
-      const std::string name = ra::filesystem::GetFilename(file.c_str());
-      bool numeric = ra::strings::IsNumeric(name.c_str());
-      if (!numeric)
-        continue;
+    static const size_t BUFFER_SIZE = 32 * 1024;
+    std::vector<char> buffer(BUFFER_SIZE);
+    ProcessIdList pids;
+    bool found = ReadProcessIds(proc_fd, &buffer[0], buffer.size(), pids);
+    if (!found) {
+      close(proc_fd);
+      return processes; //failed
+    }
 
-      //that's a process id. Parse it
-      processid_t pid = INVALID_PROCESS_ID;
-      bool parsed_ok = ra::strings::Parse(name.c_str(), pid);
-      if (!parsed_ok)
-        continue;
+    processes.reserve(pids.size());
+    for (size_t i = 0; i < pids.size(); i++) {
+      const processid_t & pid = pids[i];
 
       //filter out process id that are not running
       //(i.e. zombie processes)
       char state = '\0';
-      if (!GetProcessState(pid, state))
+      if (!GetProcessState(proc_fd, pid, state))
         continue;
       bool running = IsRunningState(state);
       if (!running)
@@ -516,6 +1002,7 @@ namespace ra { namespace process {
 
       processes.push_back(pid);
     }
+    close(proc_fd);
 #elif defined(__APPLE__)
     //https://stackoverflow.com/questions/6045878/observe-a-process-of-unknown-pid-no-ui/6046282#6046282
     //https://stackoverflow.com/questions/49506579/how-to-find-the-pid-of-any-process-in-mac-osx-c
@@ -616,43 +1103,352 @@ namespace ra { namespace process {
   }
 #else
   processid_t StartProcess(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments) {
-    //temporary change the current directory for the child process
-    std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    SpawnOptions options;
+    processid_t pid = StartProcess(exec_path, default_directory, arguments, options);
+    return pid;
+  }
+
+  processid_t StartProcess(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, const SpawnOptions & options) {
     if (!ra::filesystem::DirectoryExists(default_directory.c_str()))
       return INVALID_PROCESS_ID;
-    int chdir_result = chdir(default_directory.c_str());
 
     //prepare argv
     //the first element of argv must be the executable path itself.
-    //the last element of argv must be am empty argument
-    static const int MAX_ARGUMENTS = 10240;
-    char * argv[MAX_ARGUMENTS] = { 0 };
+    //the last element of argv must be a NULL pointer.
+    std::vector<char *> argv(arguments.size() + 2, (char*)NULL);
     argv[0] = (char*)exec_path.c_str();
-    for (size_t i = 0; i < arguments.size() && i < (MAX_ARGUMENTS - 2); i++) {
+    for (size_t i = 0; i < arguments.size(); i++) {
       char * arg_value = (char*)arguments[i].c_str();
       argv[i + 1] = arg_value;
     }
 
-    //Print arguments.
-    //printf("posix_spawn():\n");
-    //fflush(NULL);
-    //int i=0;
-    //while(argv[i])
-    //{
-    //  printf("arg[%d]=%s\n", i, argv[i]);
-    //  i++;
-    //}
+    //posix_spawn() cannot set the priority, affinity or resource limits of the child process
+    if (IsForkExecRequired(options)) {
+      pid_t child_pid = ForkExec(exec_path.c_str(), default_directory.c_str(), &argv[0], options);
+      return child_pid;
+    }
 
     pid_t child_pid = INVALID_PROCESS_ID;
-    int status = posix_spawn(&child_pid, exec_path.c_str(), NULL, NULL, argv, environ);
+#ifdef RAPIDASSIST_HAVE_POSIX_SPAWN_ADDCHDIR
+    //change the current directory of the child process only.
+    posix_spawn_file_actions_t file_actions;
+    if (posix_spawn_file_actions_init(&file_actions) != 0)
+      return INVALID_PROCESS_ID;
+    int status = 0;
+    if (status == 0 && options.stdin_fd >= 0)
+      status = posix_spawn_file_actions_adddup2(&file_actions, options.stdin_fd, STDIN_FILENO);
+    if (status == 0 && options.stdout_fd >= 0)
+      status = posix_spawn_file_actions_adddup2(&file_actions, options.stdout_fd, STDOUT_FILENO);
+    if (status == 0 && options.stderr_fd >= 0)
+      status = posix_spawn_file_actions_adddup2(&file_actions, options.stderr_fd, STDERR_FILENO);
+    if (status == 0)
+      status = posix_spawn_file_actions_addchdir_np(&file_actions, default_directory.c_str());
+
+    //place the child process in its own process group
+    posix_spawnattr_t attr;
+    if (posix_spawnattr_init(&attr) != 0) {
+      posix_spawn_file_actions_destroy(&file_actions);
+      return INVALID_PROCESS_ID;
+    }
+    if (status == 0 && options.new_process_group)
+      status = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    if (status == 0 && options.new_process_group)
+      status = posix_spawnattr_setpgroup(&attr, 0);
+
+    if (status == 0)
+      status = posix_spawn(&child_pid, exec_path.c_str(), &file_actions, &attr, &argv[0], environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&file_actions);
     if (status != 0)
       child_pid = INVALID_PROCESS_ID;
-
-    //restore current directory back to the previous location
-    chdir_result = chdir(curr_dir.c_str());
+#else
+    child_pid = ForkExec(exec_path.c_str(), default_directory.c_str(), &argv[0], options);
+#endif
 
     return child_pid;
   }
+
+  bool ExecuteAndCapture(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, IOutputHandler * handler, int & exit_code) {
+    exit_code = -1;
+
+    //create a pipe for stdout and another for stderr
+    int stdout_fds[2];
+    int stderr_fds[2];
+    if (!CreatePipe(stdout_fds))
+      return false;
+    if (!CreatePipe(stderr_fds)) {
+      close(stdout_fds[0]);
+      close(stdout_fds[1]);
+      return false;
+    }
+
+    //launch the process with the write end of the pipes as stdout and stderr
+    SpawnOptions options;
+    options.stdout_fd = stdout_fds[1];
+    options.stderr_fd = stderr_fds[1];
+    processid_t pid = StartProcess(exec_path, default_directory, arguments, options);
+
+    //the write end of the pipes belongs to the child process
+    close(stdout_fds[1]);
+    close(stderr_fds[1]);
+
+    if (pid == INVALID_PROCESS_ID) {
+      close(stdout_fds[0]);
+      close(stderr_fds[0]);
+      return false;
+    }
+
+    //read both pipes until the child process closes them
+    fcntl(stdout_fds[0], F_SETFL, fcntl(stdout_fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(stderr_fds[0], F_SETFL, fcntl(stderr_fds[0], F_GETFL) | O_NONBLOCK);
+    struct pollfd fds[2];
+    fds[0].fd = stdout_fds[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = stderr_fds[0];
+    fds[1].events = POLLIN;
+    static const int stream_ids[2] = { STDOUT_FILENO, STDERR_FILENO };
+
+    static const size_t BUFFER_SIZE = 64 * 1024;
+    std::vector<char> buffer(BUFFER_SIZE);
+    int num_open = 2;
+    while (num_open > 0) {
+      fds[0].revents = 0;
+      fds[1].revents = 0;
+      int poll_result = poll(fds, 2, -1);
+      if (poll_result < 0) {
+        if (errno == EINTR)
+          continue;
+        break;
+      }
+
+      for (int i = 0; i < 2; i++) {
+        if (fds[i].fd < 0 || fds[i].revents == 0)
+          continue;
+
+        //drain the pipe
+        bool closed = false;
+        while (true) {
+          ssize_t read_size = read(fds[i].fd, &buffer[0], buffer.size());
+          if (read_size > 0) {
+            if (handler)
+              handler->OnOutput(stream_ids[i], &buffer[0], (size_t)read_size);
+            continue;
+          }
+          if (read_size < 0 && errno == EINTR)
+            continue;
+          if (read_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break; //no more data for now
+          closed = true; //end of file or error
+          break;
+        }
+
+        if (closed) {
+          close(fds[i].fd);
+          fds[i].fd = -1; //ignored by poll()
+          num_open--;
+        }
+      }
+    }
+
+    if (fds[0].fd >= 0)
+      close(fds[0].fd);
+    if (fds[1].fd >= 0)
+      close(fds[1].fd);
+
+    //wait for the process to exit and read its exit code
+    int status = 0;
+    pid_t result_pid = 0;
+    do {
+      result_pid = waitpid(pid, &status, 0);
+    } while (result_pid < 0 && errno == EINTR);
+    if (result_pid != pid)
+      return false;
+
+    if (WIFEXITED(status))
+      exit_code = WEXITSTATUS(status);
+    return true;
+  }
+
+  /// <summary>
+  /// Accumulates the output of a process into strings.
+  /// </summary>
+  class StringOutputHandler : public IOutputHandler {
+  public:
+    StringOutputHandler(std::string & std_out, std::string & std_err) :
+      std_out_(std_out),
+      std_err_(std_err)
+    {
+    }
+    virtual void OnOutput(int stream_id, const char * buffer, size_t size) {
+      if (stream_id == STDOUT_FILENO)
+        std_out_.append(buffer, size);
+      else
+        std_err_.append(buffer, size);
+    }
+  private:
+    std::string & std_out_;
+    std::string & std_err_;
+  };
+
+  bool ExecuteAndCapture(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments, std::string & std_out, std::string & std_err, int & exit_code) {
+    std_out.clear();
+    std_err.clear();
+    StringOutputHandler handler(std_out, std_err);
+    bool success = ExecuteAndCapture(exec_path, default_directory, arguments, &handler, exit_code);
+    return success;
+  }
+  bool WaitExit(const processid_t & pid, int & exit_code, int timeout_ms) {
+    ProcessIdList pids(1, pid);
+    processid_t terminated_pid = INVALID_PROCESS_ID;
+    bool reaped = false;
+    int status = 0;
+    WaitResult result = WaitAnyProcess(pids, timeout_ms, terminated_pid, reaped, status);
+    if (result != WAIT_SUCCESS || !reaped)
+      return false;
+    exit_code = ToExitCode(status);
+    return true;
+  }
+
+  bool WaitAny(const ProcessIdList & pids, int timeout_ms, processid_t & pid, int & exit_code) {
+    bool reaped = false;
+    int status = 0;
+    WaitResult result = WaitAnyProcess(pids, timeout_ms, pid, reaped, status);
+    if (result != WAIT_SUCCESS)
+      return false;
+    exit_code = (reaped ? ToExitCode(status) : -1);
+    return true;
+  }
+
+  bool Terminate(const processid_t & pid, int timeout_ms) {
+    //ask the process to exit gracefully
+    int kill_error = ::kill(pid, SIGTERM);
+    if (kill_error != 0)
+      return false;
+    if (WaitProcess(pid, timeout_ms) == WAIT_SUCCESS)
+      return true;
+
+    //the process did not exit in time
+    ::kill(pid, SIGKILL);
+    bool success = (WaitProcess(pid, -1) == WAIT_SUCCESS);
+    return success;
+  }
+
+  /// <summary>
+  /// Define if a process group has members that are still running.
+  /// On linux, zombie members, which are terminated but not reaped by their parent, are not considered running.
+  /// </summary>
+  /// <param name="pgid">The process group id.</param>
+  /// <returns>Returns true if the process group has running members. Returns false otherwise.</returns>
+  bool HasRunningGroupMembers(const processid_t & pgid) {
+    if (::kill(-pgid, 0) != 0)
+      return false;
+
+#if defined(__linux__)
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0)
+      return true;
+    static const size_t BUFFER_SIZE = 32 * 1024;
+    std::vector<char> buffer(BUFFER_SIZE);
+    ProcessIdList pids;
+    if (!ReadProcessIds(proc_fd, &buffer[0], buffer.size(), pids)) {
+      close(proc_fd);
+      return true;
+    }
+
+    bool running = false;
+    for (size_t i = 0; i < pids.size() && !running; i++) {
+      char stat[1024];
+      if (ReadProcessStatFile(proc_fd, pids[i], stat, sizeof(stat)) == 0)
+        continue;
+      const char * fields = ParseProcessStatName(stat, NULL);
+      if (fields == NULL)
+        continue;
+
+      //the fields following the name are the state, the parent process id and the process group id
+      char state = '\0';
+      int ppid = 0;
+      int pgrp = 0;
+      if (sscanf(fields, "%c %d %d", &state, &ppid, &pgrp) != 3)
+        continue;
+      if (pgrp == (int)pgid && IsRunningState(state))
+        running = true;
+    }
+    close(proc_fd);
+    return running;
+#else
+    return true;
+#endif
+  }
+
+  bool TerminateGroup(const processid_t & pgid, int timeout_ms) {
+    //the minimum delay between two checks for the remaining processes of the group
+    static const int GROUP_POLL_INTERVAL_MS = 10;
+    //the maximum delay for the killed processes to leave the group
+    static const int KILL_TIMEOUT_MS = 1000;
+
+    if (pgid <= 0)
+      return false;
+
+    //ask all processes of the group to exit gracefully
+    int kill_error = ::kill(-pgid, SIGTERM);
+    if (kill_error != 0)
+      return false;
+
+    uint64_t time_start = ra::timing::GetMillisecondsCounterU64();
+
+    //wait for the group leader first. A zombie leader is still a member of the group.
+    bool leader_terminated = (WaitProcess(pgid, timeout_ms) == WAIT_SUCCESS);
+
+    //wait for the other processes of the group
+    if (leader_terminated) {
+      while (HasRunningGroupMembers(pgid)) {
+        uint64_t elapsed_ms = ra::timing::GetMillisecondsCounterU64() - time_start;
+        if (timeout_ms >= 0 && elapsed_ms >= (uint64_t)timeout_ms)
+          break;
+        ra::timing::Millisleep(GROUP_POLL_INTERVAL_MS);
+      }
+    }
+
+    //is the whole group terminated?
+    if (leader_terminated && !HasRunningGroupMembers(pgid))
+      return true;
+
+    //kill the processes that did not exit in time
+    ::kill(-pgid, SIGKILL);
+    if (!leader_terminated && WaitProcess(pgid, -1) != WAIT_SUCCESS)
+      return false;
+
+    //the killed processes leave the group asynchronously
+    uint64_t kill_start = ra::timing::GetMillisecondsCounterU64();
+    while (HasRunningGroupMembers(pgid)) {
+      uint64_t elapsed_ms = ra::timing::GetMillisecondsCounterU64() - kill_start;
+      if (elapsed_ms >= (uint64_t)KILL_TIMEOUT_MS)
+        return false;
+      ra::timing::Millisleep(GROUP_POLL_INTERVAL_MS);
+    }
+
+    return true;
+  }
+
+  bool KillGroup(const processid_t & pgid) {
+    if (pgid <= 0)
+      return false;
+
+    int kill_error = ::kill(-pgid, SIGKILL);
+    bool success = (kill_error == 0);
+
+    if (success) {
+      //reap the group leader if it is a child of the current process
+      int status = 0;
+      pid_t result_pid = 0;
+      do {
+        result_pid = waitpid(pgid, &status, 0);
+      } while (result_pid < 0 && errno == EINTR);
+    }
+
+    return success;
+  }
+
 #endif
 
   bool OpenDocument(const std::string & path) {
@@ -786,17 +1582,10 @@ namespace ra { namespace process {
     bool terminated = Terminate(pid, 60000);
     return terminated;
 #elif defined(__linux__) || defined(__APPLE__)
-    //ask the process to exit gracefully
-    int kill_error = ::kill(pid, SIGTERM);
-    bool success = (kill_error == 0);
-
-    if (success) {
-      // call waitpid() on Linux to prevent having zombie processes.
-      int status = 0;
-      processid_t result_pid = waitpid(pid, &status, 0);
-    }
-
-    return success;
+    //ask the process to exit gracefully allowing a maximum of 60 seconds to close.
+    //the process is also reaped to prevent having zombie processes.
+    bool terminated = Terminate(pid, 60000);
+    return terminated;
 #endif
   }
 
@@ -869,6 +1658,18 @@ namespace ra { namespace process {
       return false;
     }
 
+#if defined(__linux__)
+    //wait for the process termination event.
+    //this implementation does not consume the process exit code.
+    if (WaitExitPidfd(pid))
+      return true;
+#endif
+
+    //wait for the child process termination without reaping it.
+    if (WaitExitNoReap(pid))
+      return true;
+
+    //the process is not a child of the current process.
     //wait for the process state to change
     //this implementation is slow but does not rely on waitpid()
     //to detect the end of the process
@@ -0,0 +1,375 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/processmanager.h"
+#include "rapidassist/timing.h"
+
+#ifndef _WIN32
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h> //for memset()
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h> //for wait4()
+
+#include <poll.h>         // for poll()
+
+#if defined(__linux__)
+#include <sys/syscall.h>  // for SYS_pidfd_open
+#endif
+
+namespace ra { namespace process {
+
+  /// <summary>
+  /// Open a process file descriptor for the given process id.
+  /// </summary>
+  /// <param name="pid">The process id of the process.</param>
+  /// <returns>Returns a valid file descriptor when successful. Returns -1 if pidfd is not supported or on error.</returns>
+  int OpenProcessFd(const processid_t & pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    int pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+    return pidfd;
+#else
+    return -1;
+#endif
+  }
+
+  inline double ToSeconds(const struct timeval & tv) {
+    return double(tv.tv_sec) + double(tv.tv_usec) / 1000000.0;
+  }
+
+  struct ProcessState {
+    size_t references;
+    processid_t pid;
+    const ProcessManager * manager; //the manager reaping the process. Set to NULL once the process is reaped.
+    bool completed;
+    ProcessResult result;
+  };
+
+  ProcessState * CreateProcessState(const processid_t & pid, const ProcessManager * manager) {
+    ProcessState * state = new ProcessState();
+    state->references = 1;
+    state->pid = pid;
+    state->manager = manager;
+    state->completed = false;
+    memset(&state->result, 0, sizeof(state->result));
+    state->result.pid = pid;
+    state->result.exit_code = -1;
+    return state;
+  }
+
+  inline void AddReference(ProcessState * state) {
+    state->references++;
+  }
+
+  inline void ReleaseReference(ProcessState * state) {
+    state->references--;
+    if (state->references == 0)
+      delete state;
+  }
+
+  ProcessHandle::ProcessHandle() :
+    state_(NULL)
+  {
+  }
+
+  ProcessHandle::ProcessHandle(ProcessState * state) :
+    state_(state)
+  {
+    if (state_)
+      AddReference(state_);
+  }
+
+  ProcessHandle::ProcessHandle(const ProcessHandle & other) :
+    state_(other.state_)
+  {
+    if (state_)
+      AddReference(state_);
+  }
+
+  ProcessHandle & ProcessHandle::operator=(const ProcessHandle & other) {
+    if (other.state_)
+      AddReference(other.state_);
+    if (state_)
+      ReleaseReference(state_);
+    state_ = other.state_;
+    return *this;
+  }
+
+  ProcessHandle::~ProcessHandle() {
+    if (state_)
+      ReleaseReference(state_);
+  }
+
+  bool ProcessHandle::IsValid() const {
+    return state_ != NULL;
+  }
+
+  processid_t ProcessHandle::GetProcessId() const {
+    if (!state_)
+      return INVALID_PROCESS_ID;
+    return state_->pid;
+  }
+
+  bool ProcessHandle::IsCompleted() const {
+    return state_ != NULL && state_->completed;
+  }
+
+  const ProcessResult & ProcessHandle::GetResult() const {
+    static const ProcessResult INVALID_RESULT = { INVALID_PROCESS_ID, -1, 0, 0.0, 0.0, 0.0, 0 };
+    if (!state_)
+      return INVALID_RESULT;
+    return state_->result;
+  }
+
+  ProcessManager::ProcessManager() :
+    num_without_pidfd_(0),
+    listener_(NULL)
+  {
+  }
+
+  ProcessManager::~ProcessManager() {
+    for (size_t i = 0; i < running_.size(); i++) {
+      if (fds_[i].fd >= 0)
+        close(fds_[i].fd);
+      running_[i].state->manager = NULL;
+      ReleaseReference(running_[i].state);
+    }
+    running_.clear();
+    fds_.clear();
+  }
+
+  void ProcessManager::SetListener(IProcessListener * listener) {
+    listener_ = listener;
+  }
+
+  ProcessHandle ProcessManager::Start(const std::string & exec_path, const std::string & default_directory, const ra::strings::StringVector & arguments) {
+    processid_t pid = StartProcess(exec_path, default_directory, arguments);
+    if (pid == INVALID_PROCESS_ID)
+      return ProcessHandle();
+
+    return Add(pid);
+  }
+
+  ProcessHandle ProcessManager::Add(const processid_t & pid) {
+    if (pid == INVALID_PROCESS_ID)
+      return ProcessHandle();
+
+    //is this process already managed?
+    for (size_t i = 0; i < running_.size(); i++) {
+      if (running_[i].state->pid == pid)
+        return ProcessHandle(running_[i].state);
+    }
+
+    ProcessEntry entry;
+    entry.state = CreateProcessState(pid, this);
+    entry.start_time = ra::timing::GetMicrosecondsCounterU64();
+
+    struct pollfd pfd;
+    pfd.fd = OpenProcessFd(pid);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (pfd.fd < 0)
+      num_without_pidfd_++;
+
+    running_.push_back(entry);
+    fds_.push_back(pfd);
+
+    return ProcessHandle(entry.state);
+  }
+
+  size_t ProcessManager::GetRunningCount() const {
+    return running_.size();
+  }
+
+  ProcessIdList ProcessManager::GetRunningProcesses() const {
+    ProcessIdList processes;
+    processes.reserve(running_.size());
+    for (size_t i = 0; i < running_.size(); i++) {
+      processes.push_back(running_[i].state->pid);
+    }
+    return processes;
+  }
+
+  void ProcessManager::Remove(size_t index) {
+    if (fds_[index].fd >= 0)
+      close(fds_[index].fd);
+    else
+      num_without_pidfd_--;
+
+    const size_t last = running_.size() - 1;
+    if (index != last) {
+      running_[index] = running_[last];
+      fds_[index] = fds_[last];
+    }
+    running_.pop_back();
+    fds_.pop_back();
+  }
+
+  bool ProcessManager::TryReap(size_t index) {
+    const ProcessEntry entry = running_[index];
+    const processid_t pid = entry.state->pid;
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    pid_t result_pid = 0;
+    do {
+      result_pid = wait4(pid, &status, WNOHANG, &usage);
+    } while (result_pid < 0 && errno == EINTR);
+
+    if (result_pid == 0)
+      return false; //still running
+
+    ProcessResult & result = entry.state->result;
+    result.pid = pid;
+    result.exit_code = -1;
+    result.term_signal = 0;
+    result.runtime = double(ra::timing::GetMicrosecondsCounterU64() - entry.start_time) / 1000000.0;
+    result.user_time = 0.0;
+    result.system_time = 0.0;
+    result.max_rss = 0;
+
+    if (result_pid == pid) {
+      if (WIFEXITED(status))
+        result.exit_code = WEXITSTATUS(status);
+      else if (WIFSIGNALED(status))
+        result.term_signal = WTERMSIG(status);
+      result.user_time = ToSeconds(usage.ru_utime);
+      result.system_time = ToSeconds(usage.ru_stime);
+      result.max_rss = usage.ru_maxrss;
+    }
+    //else: the process was already reaped by someone else (ECHILD). The exit code is lost.
+
+    Remove(index);
+    entry.state->completed = true;
+    entry.state->manager = NULL;
+
+    if (listener_)
+      listener_->OnProcessExit(result);
+
+    ReleaseReference(entry.state);
+    return true;
+  }
+
+  size_t ProcessManager::Reap(bool check_all) {
+    size_t count = 0;
+
+    //iterate backward: Remove() moves the last entry, which was already visited, in place of the reaped one.
+    //Entries added by the listener are appended at the end and are not visited.
+    for (size_t i = running_.size(); i > 0; i--) {
+      const size_t index = i - 1;
+      if (index >= running_.size())
+        continue; //the listener has reaped other processes
+
+      const struct pollfd & pfd = fds_[index];
+      if (!check_all && pfd.fd >= 0 && pfd.revents == 0)
+        continue; //not signaled by poll()
+
+      if (TryReap(index))
+        count++;
+    }
+
+    return count;
+  }
+
+  size_t ProcessManager::Poll(int timeout_ms) {
+    //the minimum delay between two checks for processes without a pidfd
+    static const int FALLBACK_POLL_INTERVAL_MS = 10;
+
+    if (running_.empty())
+      return 0;
+
+    uint64_t time_start = ra::timing::GetMillisecondsCounterU64();
+    size_t count = 0;
+
+    while (count == 0 && !running_.empty()) {
+      //compute remaining time
+      int remaining_ms = -1;
+      if (timeout_ms >= 0) {
+        uint64_t elapsed_ms = ra::timing::GetMillisecondsCounterU64() - time_start;
+        remaining_ms = (elapsed_ms >= (uint64_t)timeout_ms ? 0 : timeout_ms - (int)elapsed_ms);
+      }
+
+      int wait_ms = remaining_ms;
+      if (num_without_pidfd_ > 0 && (wait_ms < 0 || wait_ms > FALLBACK_POLL_INTERVAL_MS))
+        wait_ms = FALLBACK_POLL_INTERVAL_MS;
+
+      bool check_all = false;
+      if (num_without_pidfd_ < fds_.size()) {
+        //wait on all process file descriptors at once. Entries without a pidfd are ignored by poll().
+        int poll_result = poll(&fds_[0], (nfds_t)fds_.size(), wait_ms);
+        if (poll_result < 0) {
+          for (size_t i = 0; i < fds_.size(); i++) {
+            fds_[i].revents = 0;
+          }
+          if (errno != EINTR) {
+            ra::timing::Millisleep(FALLBACK_POLL_INTERVAL_MS);
+            check_all = true;
+          }
+        }
+      }
+      else if (wait_ms > 0)
+        ra::timing::Millisleep(wait_ms);
+
+      count += Reap(check_all);
+
+      if (remaining_ms == 0)
+        break;
+    }
+
+    return count;
+  }
+
+  bool ProcessManager::Wait(const ProcessHandle & handle, ProcessResult & result) {
+    const ProcessState * state = handle.state_;
+    if (state == NULL)
+      return false;
+
+    while (!state->completed) {
+      //is this process still managed?
+      if (state->manager != this)
+        return false;
+
+      Poll(-1);
+    }
+
+    result = state->result;
+    return true;
+  }
+
+  bool ProcessManager::WaitAll() {
+    while (!running_.empty()) {
+      Poll(-1);
+    }
+    return true;
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
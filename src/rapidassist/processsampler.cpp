@@ -0,0 +1,320 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/processsampler.h"
+
+#ifdef __linux__
+
+#include "rapidassist/timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ra { namespace process {
+
+  //declared in process.cpp
+  extern const char * ParseProcessStatName(const char * buffer, std::string * name);
+  //declared in processsnapshot.cpp
+  extern bool ParseProcessStatFields(const char * fields, unsigned long long * values, size_t count);
+
+  /// <summary>
+  /// Open a file of the '/proc/[pid]' directory.
+  /// </summary>
+  /// <param name="pid">The process id.</param>
+  /// <param name="name">The name of the file.</param>
+  /// <returns>Returns a valid file descriptor if the function is successful. Returns -1 otherwise.</returns>
+  int OpenProcessFile(const processid_t & pid, const char * name) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/%s", (int)pid, name);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    return fd;
+  }
+
+  /// <summary>
+  /// Read the whole content of a /proc file from its beginning.
+  /// The kernel generates the content again on each read at offset 0.
+  /// </summary>
+  /// <param name="fd">The file descriptor of the file.</param>
+  /// <param name="buffer">The output buffer. The content is NULL terminated.</param>
+  /// <param name="size">The size of the output buffer in bytes.</param>
+  /// <returns>Returns the number of bytes read. Returns 0 on error.</returns>
+  size_t PreadProcessFile(int fd, char * buffer, size_t size) {
+    ssize_t length = 0;
+    do {
+      length = pread(fd, buffer, size - 1, 0);
+    } while (length < 0 && errno == EINTR);
+    if (length <= 0)
+      return 0;
+    buffer[length] = '\0';
+    return (size_t)length;
+  }
+
+  /// <summary>
+  /// Parse the value of a 'key: value' line from the content of a /proc file.
+  /// </summary>
+  /// <param name="buffer">The NULL terminated content of the file.</param>
+  /// <param name="key">The key to search for, including the ':' character.</param>
+  /// <param name="value">The output value.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ParseProcessFileValue(const char * buffer, const char * key, uint64_t & value) {
+    const size_t key_length = strlen(key);
+    const char * line = buffer;
+    while (line != NULL && *line != '\0') {
+      if (strncmp(line, key, key_length) == 0) {
+        value = (uint64_t)strtoull(line + key_length, NULL, 10);
+        return true;
+      }
+      line = strchr(line, '\n');
+      if (line)
+        line++;
+    }
+    return false;
+  }
+
+  ProcessSampler::ProcessSampler(size_t capacity) :
+    clock_ticks_(sysconf(_SC_CLK_TCK)),
+    page_size_(sysconf(_SC_PAGESIZE)),
+    first_(0),
+    count_(0)
+  {
+    if (clock_ticks_ <= 0)
+      clock_ticks_ = 100;
+    if (page_size_ <= 0)
+      page_size_ = 4096;
+    if (capacity == 0)
+      capacity = 1;
+    samples_.resize(capacity);
+    static const size_t BUFFER_SIZE = 4096;
+    buffer_.resize(BUFFER_SIZE);
+  }
+
+  ProcessSampler::~ProcessSampler() {
+    for (size_t i = 0; i < processes_.size(); i++) {
+      Close(processes_[i]);
+    }
+  }
+
+  bool ProcessSampler::Add(const processid_t & pid) {
+    if (pid == INVALID_PROCESS_ID)
+      return false;
+    for (size_t i = 0; i < processes_.size(); i++) {
+      if (processes_[i].pid == pid)
+        return false; //already sampled
+    }
+
+    SampledProcess process;
+    process.pid = pid;
+    process.stat_fd = OpenProcessFile(pid, "stat");
+    process.status_fd = OpenProcessFile(pid, "status");
+    //the io file requires ptrace access to the process. It is optional.
+    process.io_fd = OpenProcessFile(pid, "io");
+    if (process.stat_fd < 0 || process.status_fd < 0) {
+      Close(process);
+      return false;
+    }
+
+    processes_.push_back(process);
+    return true;
+  }
+
+  bool ProcessSampler::Remove(const processid_t & pid) {
+    for (size_t i = 0; i < processes_.size(); i++) {
+      if (processes_[i].pid == pid) {
+        Close(processes_[i]);
+        processes_.erase(processes_.begin() + i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t ProcessSampler::GetProcessCount() const {
+    return processes_.size();
+  }
+
+  size_t ProcessSampler::Sample() {
+    size_t num_samples = 0;
+    const double timestamp = ra::timing::GetMicrosecondsTimer();
+
+    size_t i = 0;
+    while (i < processes_.size()) {
+      SampledProcess & process = processes_[i];
+
+      ProcessSample sample;
+      sample.timestamp = timestamp;
+      bool terminated = false;
+      bool success = Read(process, sample, terminated);
+      if (success) {
+        Push(sample);
+        num_samples++;
+      }
+
+      if (!success || terminated) {
+        Close(process);
+        processes_.erase(processes_.begin() + i);
+      }
+      else
+        i++;
+    }
+
+    return num_samples;
+  }
+
+  void ProcessSampler::Run(uint32_t interval_ms) {
+    while (true) {
+      Sample();
+      if (processes_.empty())
+        return;
+      ra::timing::Millisleep(interval_ms);
+    }
+  }
+
+  size_t ProcessSampler::GetCapacity() const {
+    return samples_.size();
+  }
+
+  size_t ProcessSampler::GetSampleCount() const {
+    return count_;
+  }
+
+  void ProcessSampler::GetSamples(ProcessSampleList & samples) const {
+    samples.clear();
+    samples.reserve(count_);
+    for (size_t i = 0; i < count_; i++) {
+      size_t index = (first_ + i) % samples_.size();
+      samples.push_back(samples_[index]);
+    }
+  }
+
+  void ProcessSampler::Clear() {
+    first_ = 0;
+    count_ = 0;
+  }
+
+  bool ProcessSampler::Dump(const std::string & path) const {
+    FILE * f = fopen(path.c_str(), "w");
+    if (!f)
+      return false;
+
+    fputs("pid,timestamp,user_time,system_time,rss,voluntary_ctxt_switches,nonvoluntary_ctxt_switches,read_chars,write_chars,read_bytes,write_bytes\n", f);
+    for (size_t i = 0; i < count_; i++) {
+      const ProcessSample & s = samples_[(first_ + i) % samples_.size()];
+      fprintf(f, "%d,%.6f,%.3f,%.3f,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+        (int)s.pid,
+        s.timestamp,
+        s.user_time,
+        s.system_time,
+        (unsigned long long)s.rss,
+        (unsigned long long)s.voluntary_ctxt_switches,
+        (unsigned long long)s.nonvoluntary_ctxt_switches,
+        (unsigned long long)s.read_chars,
+        (unsigned long long)s.write_chars,
+        (unsigned long long)s.read_bytes,
+        (unsigned long long)s.write_bytes);
+    }
+
+    bool success = (ferror(f) == 0);
+    if (fclose(f) != 0)
+      success = false;
+    return success;
+  }
+
+  bool ProcessSampler::Read(const SampledProcess & process, ProcessSample & sample, bool & terminated) {
+    char * buffer = &buffer_[0];
+    const size_t size = buffer_.size();
+
+    sample.pid = process.pid;
+
+    //the process is reaped when its files cannot be read anymore
+    if (PreadProcessFile(process.stat_fd, buffer, size) == 0)
+      return false;
+    const char * fields = ParseProcessStatName(buffer, NULL);
+    if (fields == NULL)
+      return false;
+
+    //fields 4 (ppid) to 24 (rss). See proc(5).
+    static const size_t NUM_FIELDS = 21;
+    unsigned long long values[NUM_FIELDS];
+    if (!ParseProcessStatFields(fields, values, NUM_FIELDS))
+      return false;
+    const char state = fields[0];
+    terminated = (state == 'Z' || state == 'X');
+    sample.user_time = (double)values[10] / (double)clock_ticks_;
+    sample.system_time = (double)values[11] / (double)clock_ticks_;
+    sample.rss = (uint64_t)values[20] * (uint64_t)page_size_;
+
+    sample.voluntary_ctxt_switches = 0;
+    sample.nonvoluntary_ctxt_switches = 0;
+    if (PreadProcessFile(process.status_fd, buffer, size) > 0) {
+      ParseProcessFileValue(buffer, "voluntary_ctxt_switches:", sample.voluntary_ctxt_switches);
+      ParseProcessFileValue(buffer, "nonvoluntary_ctxt_switches:", sample.nonvoluntary_ctxt_switches);
+    }
+
+    sample.read_chars = 0;
+    sample.write_chars = 0;
+    sample.read_bytes = 0;
+    sample.write_bytes = 0;
+    if (process.io_fd >= 0 && PreadProcessFile(process.io_fd, buffer, size) > 0) {
+      ParseProcessFileValue(buffer, "rchar:", sample.read_chars);
+      ParseProcessFileValue(buffer, "wchar:", sample.write_chars);
+      ParseProcessFileValue(buffer, "read_bytes:", sample.read_bytes);
+      ParseProcessFileValue(buffer, "write_bytes:", sample.write_bytes);
+    }
+
+    return true;
+  }
+
+  void ProcessSampler::Push(const ProcessSample & sample) {
+    const size_t capacity = samples_.size();
+    if (count_ < capacity) {
+      samples_[(first_ + count_) % capacity] = sample;
+      count_++;
+    }
+    else {
+      //overwrite the oldest sample
+      samples_[first_] = sample;
+      first_ = (first_ + 1) % capacity;
+    }
+  }
+
+  void ProcessSampler::Close(SampledProcess & process) {
+    if (process.stat_fd >= 0)
+      close(process.stat_fd);
+    if (process.status_fd >= 0)
+      close(process.status_fd);
+    if (process.io_fd >= 0)
+      close(process.io_fd);
+    process.stat_fd = -1;
+    process.status_fd = -1;
+    process.io_fd = -1;
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //__linux__
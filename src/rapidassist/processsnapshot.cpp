@@ -0,0 +1,158 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/processsnapshot.h"
+
+#ifdef __linux__
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace ra { namespace process {
+
+  //declared in process.cpp
+  extern size_t ReadProcessStatFile(int proc_fd, const processid_t & pid, char * buffer, size_t size);
+  extern const char * ParseProcessStatName(const char * buffer, std::string * name);
+  extern bool ReadProcessIds(int proc_fd, char * buffer, size_t size, ProcessIdList & pids);
+
+  /// <summary>
+  /// Parse the fields of a '/proc/[pid]/stat' file that follows the process name.
+  /// </summary>
+  /// <param name="fields">The content of the stat file starting at the process state field.</param>
+  /// <param name="values">The output field values. The process state field is not included.</param>
+  /// <param name="count">The number of fields to parse.</param>
+  /// <returns>Returns true if the function is successful. Returns false otherwise.</returns>
+  bool ParseProcessStatFields(const char * fields, unsigned long long * values, size_t count) {
+    //skip the state field
+    const char * cursor = strchr(fields, ' ');
+    for (size_t i = 0; i < count; i++) {
+      if (cursor == NULL || *cursor != ' ')
+        return false;
+      char * end = NULL;
+      values[i] = (unsigned long long)strtoll(cursor + 1, &end, 10);
+      if (end == cursor + 1)
+        return false;
+      cursor = end;
+    }
+    return true;
+  }
+
+  bool ProcessInfoLess(const ProcessInfo & a, const ProcessInfo & b) {
+    return a.pid < b.pid;
+  }
+
+  ProcessSnapshot::ProcessSnapshot() :
+    proc_fd_(-1),
+    clock_ticks_(sysconf(_SC_CLK_TCK)),
+    page_size_(sysconf(_SC_PAGESIZE))
+  {
+    if (clock_ticks_ <= 0)
+      clock_ticks_ = 100;
+    if (page_size_ <= 0)
+      page_size_ = 4096;
+  }
+
+  ProcessSnapshot::~ProcessSnapshot() {
+    if (proc_fd_ >= 0)
+      close(proc_fd_);
+  }
+
+  bool ProcessSnapshot::Update() {
+    if (proc_fd_ < 0) {
+      proc_fd_ = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      if (proc_fd_ < 0)
+        return false;
+      static const size_t BUFFER_SIZE = 32 * 1024;
+      dirent_buffer_.resize(BUFFER_SIZE);
+    }
+
+    if (!ReadProcessIds(proc_fd_, &dirent_buffer_[0], dirent_buffer_.size(), pids_))
+      return false;
+
+    //reuse the ProcessInfo instances of the previous snapshot
+    size_t count = 0;
+    processes_.resize(pids_.size());
+
+    char buffer[1024];
+    for (size_t i = 0; i < pids_.size(); i++) {
+      const processid_t & pid = pids_[i];
+
+      //the process may have terminated since the directory was read
+      if (ReadProcessStatFile(proc_fd_, pid, buffer, sizeof(buffer)) == 0)
+        continue;
+
+      ProcessInfo & info = processes_[count];
+      const char * fields = ParseProcessStatName(buffer, &info.name);
+      if (fields == NULL)
+        continue;
+
+      //fields 4 (ppid) to 24 (rss). See proc(5).
+      static const size_t NUM_FIELDS = 21;
+      unsigned long long values[NUM_FIELDS];
+      if (!ParseProcessStatFields(fields, values, NUM_FIELDS))
+        continue;
+
+      info.pid = pid;
+      info.state = fields[0];
+      info.ppid = (processid_t)values[0];
+      info.user_time = (double)values[10] / (double)clock_ticks_;
+      info.system_time = (double)values[11] / (double)clock_ticks_;
+      info.num_threads = (long)values[16];
+      info.rss = (uint64_t)values[20] * (uint64_t)page_size_;
+      count++;
+    }
+    processes_.resize(count);
+
+    //entries of /proc are usually listed in ascending order
+    bool sorted = true;
+    for (size_t i = 1; i < processes_.size() && sorted; i++) {
+      if (processes_[i - 1].pid > processes_[i].pid)
+        sorted = false;
+    }
+    if (!sorted)
+      std::sort(processes_.begin(), processes_.end(), ProcessInfoLess);
+
+    return true;
+  }
+
+  const ProcessInfoList & ProcessSnapshot::GetProcesses() const {
+    return processes_;
+  }
+
+  const ProcessInfo * ProcessSnapshot::Find(const processid_t & pid) const {
+    ProcessInfo value;
+    value.pid = pid;
+    ProcessInfoList::const_iterator it = std::lower_bound(processes_.begin(), processes_.end(), value, ProcessInfoLess);
+    if (it == processes_.end() || it->pid != pid)
+      return NULL;
+    return &(*it);
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //__linux__
@@ -189,10 +189,12 @@ namespace ra { namespace testing {
     if (!ra::filesystem::FileExists(path))
       return ra::strings::StringVector();
 
+    ra::strings::StringVector lines;
+
+#ifdef _WIN32
     const std::string log_filename = ra::filesystem::GetTemporaryFileName();
 
     std::string command_line;
-#ifdef _WIN32
     command_line.append("cmd /c \"");
     command_line.append("\"");
     command_line.append(path);
@@ -203,27 +205,9 @@ namespace ra { namespace testing {
     command_line.append("\"");
     command_line.append(log_filename);
     command_line.append("\"");
-#elif defined(__linux__) || defined(__APPLE__)
-    command_line.append("\"");
-    command_line.append(path);
-    command_line.append("\"");
-    command_line.append(" --gtest_list_tests");
-    command_line.append(" 2>NUL");
-    command_line.append(" 1>");
-    command_line.append("\"");
-    command_line.append(log_filename);
-    command_line.append("\"");
-#endif //_WIN32
 
     //exec
     int return_code = system(command_line.c_str());
-#ifdef _WIN32
-    int exit_code = system(command_line.c_str());
-#elif defined(__linux__) || defined(__APPLE__)
-    //Run the new process and log the output
-    int system_result = system(command_line.c_str());
-    int exit_code = WEXITSTATUS( system_result );
-#endif //_WIN32
     if (return_code != 0)
     {
       printf("Failed running command: %s\n", command_line.c_str());
@@ -234,30 +218,47 @@ namespace ra { namespace testing {
       return ra::strings::StringVector();
 
     //load test case list from log filename
-    ra::strings::StringVector test_list;
-    static const std::string disabled_test_case_header = "  DISABLED_";
-    static const std::string disabled_test_suite_header = "DISABLED_";
-    std::string test_suite_name;
-    std::string test_case_name;
-    FILE * f = fopen(log_filename.c_str(), "r");
-    if (!f)
+    bool success = ra::filesystem::ReadTextFile(log_filename, lines);
+
+    //delete log file
+    ra::filesystem::DeleteFile(log_filename.c_str()); //cleanup
+
+    if (!success)
+      return ra::strings::StringVector();
+#elif defined(__linux__) || defined(__APPLE__)
+    //Run the new process and capture the output
+    ra::strings::StringVector arguments;
+    arguments.push_back("--gtest_list_tests");
+    std::string std_out;
+    std::string std_err;
+    int exit_code = 0;
+    bool executed = ra::process::ExecuteAndCapture(path, ra::filesystem::GetCurrentDirectory(), arguments, std_out, std_err, exit_code);
+    if (!executed || exit_code != 0)
     {
-      ra::filesystem::DeleteFile(log_filename.c_str()); //cleanup
+      printf("Failed running command: \"%s\" --gtest_list_tests\n", path);
       return ra::strings::StringVector();
     }
 
-    ra::strings::StringVector lines;
-    bool success = ra::filesystem::ReadTextFile(log_filename, lines);
-    if (!success)
+    //split the output into lines
+    ra::strings::Split(lines, std_out, '\n');
+    for(size_t i=0; i<lines.size(); i++)
     {
-      ra::filesystem::DeleteFile(log_filename.c_str()); //cleanup
-      return ra::strings::StringVector();
+      ra::strings::RemoveEol(lines[i]);
     }
-    
+#endif //_WIN32
+
+    //load test case list from the output lines
+    ra::strings::StringVector test_list;
+    static const std::string disabled_test_case_header = "  DISABLED_";
+    static const std::string disabled_test_suite_header = "DISABLED_";
+    std::string test_suite_name;
     for(size_t i=0; i<lines.size(); i++)
     {
       const std::string line = lines[i];
-      if (line.substr(0, disabled_test_case_header.size()) == disabled_test_case_header) {
+      if (line.empty()) {
+        //do nothing
+      }
+      else if (line.substr(0, disabled_test_case_header.size()) == disabled_test_case_header) {
         //do nothing
       }
       else if (line.substr(0, 2) == "  ") {
@@ -279,11 +280,6 @@ namespace ra { namespace testing {
       }
     }
 
-    fclose(f);
-
-    //delete log file
-    ra::filesystem::DeleteFile(log_filename.c_str()); //cleanup
-
     return test_list;
   }
 #endif //RAPIDASSIST_HAVE_GTEST
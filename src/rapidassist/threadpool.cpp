@@ -0,0 +1,408 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/threadpool.h"
+
+#include <deque>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include "rapidassist/undef_windows_macros.h"
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h> //for sched_getaffinity()
+#endif
+
+namespace ra { namespace threading {
+
+  ///=========================================================================================
+  ///                                 Portable primitives
+  ///=========================================================================================
+
+  struct Mutex::Impl {
+#ifdef _WIN32
+    CRITICAL_SECTION handle;
+#else
+    pthread_mutex_t handle;
+#endif
+  };
+
+  Mutex::Mutex() : impl_(new Impl()) {
+#ifdef _WIN32
+    InitializeCriticalSection(&impl_->handle);
+#else
+    pthread_mutex_init(&impl_->handle, NULL);
+#endif
+  }
+
+  Mutex::~Mutex() {
+#ifdef _WIN32
+    DeleteCriticalSection(&impl_->handle);
+#else
+    pthread_mutex_destroy(&impl_->handle);
+#endif
+    delete impl_;
+  }
+
+  void Mutex::Lock() {
+#ifdef _WIN32
+    EnterCriticalSection(&impl_->handle);
+#else
+    pthread_mutex_lock(&impl_->handle);
+#endif
+  }
+
+  void Mutex::Unlock() {
+#ifdef _WIN32
+    LeaveCriticalSection(&impl_->handle);
+#else
+    pthread_mutex_unlock(&impl_->handle);
+#endif
+  }
+
+  struct ConditionVariable::Impl {
+#ifdef _WIN32
+    CONDITION_VARIABLE handle;
+#else
+    pthread_cond_t handle;
+#endif
+  };
+
+  ConditionVariable::ConditionVariable() : impl_(new Impl()) {
+#ifdef _WIN32
+    InitializeConditionVariable(&impl_->handle);
+#else
+    pthread_cond_init(&impl_->handle, NULL);
+#endif
+  }
+
+  ConditionVariable::~ConditionVariable() {
+#ifndef _WIN32
+    pthread_cond_destroy(&impl_->handle);
+#endif
+    delete impl_;
+  }
+
+  void ConditionVariable::Wait(Mutex & mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&impl_->handle, &mutex.impl_->handle, INFINITE);
+#else
+    pthread_cond_wait(&impl_->handle, &mutex.impl_->handle);
+#endif
+  }
+
+  void ConditionVariable::NotifyOne() {
+#ifdef _WIN32
+    WakeConditionVariable(&impl_->handle);
+#else
+    pthread_cond_signal(&impl_->handle);
+#endif
+  }
+
+  void ConditionVariable::NotifyAll() {
+#ifdef _WIN32
+    WakeAllConditionVariable(&impl_->handle);
+#else
+    pthread_cond_broadcast(&impl_->handle);
+#endif
+  }
+
+  size_t GetProcessorCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t count = (size_t)info.dwNumberOfProcessors;
+#else
+    size_t count = 0;
+#ifdef __linux__
+    //only count the processors the current process is allowed to run on
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+      count = (size_t)CPU_COUNT(&set);
+#endif
+    if (count == 0) {
+      long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+      if (num_processors > 0)
+        count = (size_t)num_processors;
+    }
+#endif
+    if (count == 0)
+      count = 1;
+    return count;
+  }
+
+  ///=========================================================================================
+  ///                                 Atomic counters
+  ///=========================================================================================
+
+  inline long AtomicIncrement(volatile long * value) {
+#ifdef _WIN32
+    return InterlockedIncrement(value);
+#else
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+#endif
+  }
+
+  inline long AtomicDecrement(volatile long * value) {
+#ifdef _WIN32
+    return InterlockedDecrement(value);
+#else
+    return __atomic_sub_fetch(value, 1, __ATOMIC_SEQ_CST);
+#endif
+  }
+
+  inline long AtomicLoad(volatile long * value) {
+#ifdef _WIN32
+    return InterlockedCompareExchange(value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+  }
+
+  ///=========================================================================================
+  ///                                 ThreadPool
+  ///=========================================================================================
+
+  struct ThreadPool::WorkerContext {
+    ThreadPool * pool;
+    size_t index;
+    Mutex mutex; //protects tasks
+    std::deque<ITask *> tasks;
+    bool started; //true if the thread of the worker is running
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+  };
+
+  struct ThreadPool::Impl {
+    std::vector<WorkerContext *> workers;
+    size_t num_started; //number of worker threads running
+
+    //The counters are updated without locking the pool mutex. The mutex is only locked
+    //to sleep on or signal the condition variables.
+    volatile long queued;   //number of tasks in the worker queues
+    volatile long pending;  //number of tasks submitted and not completed
+    volatile long sleeping; //number of workers waiting for new tasks
+    volatile long next_worker;
+
+    Mutex mutex; //protects stop and the condition variables
+    ConditionVariable work_available;
+    ConditionVariable all_done;
+    bool stop;
+  };
+
+  /// <summary>Entry point of the worker threads.</summary>
+  class WorkerThread {
+  public:
+#ifdef _WIN32
+    static DWORD WINAPI Main(LPVOID arg) {
+      ThreadPool::WorkerContext * context = (ThreadPool::WorkerContext *)arg;
+      context->pool->WorkerLoop(context->index);
+      return 0;
+    }
+#else
+    static void * Main(void * arg) {
+      ThreadPool::WorkerContext * context = (ThreadPool::WorkerContext *)arg;
+      context->pool->WorkerLoop(context->index);
+      return NULL;
+    }
+#endif
+  };
+
+  ThreadPool::ThreadPool(size_t num_threads) :
+    impl_(new Impl())
+  {
+    if (num_threads == 0)
+      num_threads = GetProcessorCount();
+
+    impl_->num_started = 0;
+    impl_->queued = 0;
+    impl_->pending = 0;
+    impl_->sleeping = 0;
+    impl_->next_worker = 0;
+    impl_->stop = false;
+
+    for (size_t i = 0; i < num_threads; i++) {
+      WorkerContext * context = new WorkerContext();
+      context->pool = this;
+      context->index = i;
+      context->started = false;
+      impl_->workers.push_back(context);
+    }
+
+    //start the threads once all workers are created since a worker can steal from any other worker.
+    //The thread creation may fail when the process or cgroup limit of threads is reached. The tasks
+    //queued to a worker without a thread are stolen by the other workers.
+    for (size_t i = 0; i < impl_->workers.size(); i++) {
+      WorkerContext * context = impl_->workers[i];
+#ifdef _WIN32
+      context->thread = CreateThread(NULL, 0, WorkerThread::Main, context, 0, NULL);
+      context->started = (context->thread != NULL);
+#else
+      context->started = (pthread_create(&context->thread, NULL, WorkerThread::Main, context) == 0);
+#endif
+      if (context->started)
+        impl_->num_started++;
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    Wait();
+
+    {
+      ScopedLock lock(impl_->mutex);
+      impl_->stop = true;
+      impl_->work_available.NotifyAll();
+    }
+
+    for (size_t i = 0; i < impl_->workers.size(); i++) {
+      WorkerContext * context = impl_->workers[i];
+      if (!context->started)
+        continue;
+#ifdef _WIN32
+      WaitForSingleObject(context->thread, INFINITE);
+      CloseHandle(context->thread);
+#else
+      pthread_join(context->thread, NULL);
+#endif
+    }
+
+    //a worker can access the queue of any other worker until it exits
+    for (size_t i = 0; i < impl_->workers.size(); i++) {
+      delete impl_->workers[i];
+    }
+    delete impl_;
+  }
+
+  size_t ThreadPool::GetThreadCount() const {
+    return impl_->workers.size();
+  }
+
+  void ThreadPool::Submit(ITask * task) {
+    //distribute external tasks among workers
+    size_t worker_index = (size_t)(unsigned long)AtomicIncrement(&impl_->next_worker);
+    Submit(task, worker_index);
+  }
+
+  void ThreadPool::Submit(ITask * task, size_t worker_index) {
+    if (task == NULL)
+      return;
+    worker_index %= impl_->workers.size();
+
+    if (impl_->num_started == 0) {
+      //no worker thread could be started. Execute the task in the calling thread.
+      task->Run(*this, worker_index);
+      delete task;
+      return;
+    }
+
+    //the task is counted as pending before it can be executed by a worker
+    AtomicIncrement(&impl_->pending);
+
+    WorkerContext * worker = impl_->workers[worker_index];
+    {
+      ScopedLock worker_lock(worker->mutex);
+      worker->tasks.push_back(task);
+    }
+    AtomicIncrement(&impl_->queued);
+
+    //A sleeping worker registers itself before checking the queued counter with the pool mutex locked.
+    //Either the worker sees the new task or this thread sees the sleeping worker.
+    if (AtomicLoad(&impl_->sleeping) > 0) {
+      ScopedLock lock(impl_->mutex);
+      impl_->work_available.NotifyOne();
+    }
+  }
+
+  void ThreadPool::Wait() {
+    ScopedLock lock(impl_->mutex);
+    while (AtomicLoad(&impl_->pending) > 0) {
+      impl_->all_done.Wait(impl_->mutex);
+    }
+  }
+
+  ITask * ThreadPool::PopTask(size_t worker_index) {
+    const size_t num_workers = impl_->workers.size();
+
+    //execute the most recent task of the own queue first.
+    //then, steal the oldest task of another worker.
+    for (size_t i = 0; i < num_workers; i++) {
+      WorkerContext * worker = impl_->workers[(worker_index + i) % num_workers];
+      ScopedLock worker_lock(worker->mutex);
+      if (worker->tasks.empty())
+        continue;
+
+      ITask * task = NULL;
+      if (i == 0) {
+        task = worker->tasks.back();
+        worker->tasks.pop_back();
+      }
+      else {
+        task = worker->tasks.front();
+        worker->tasks.pop_front();
+      }
+
+      AtomicDecrement(&impl_->queued);
+      return task;
+    }
+
+    return NULL;
+  }
+
+  void ThreadPool::WorkerLoop(size_t worker_index) {
+    while (true) {
+      ITask * task = PopTask(worker_index);
+      if (task) {
+        task->Run(*this, worker_index);
+        delete task;
+
+        if (AtomicDecrement(&impl_->pending) == 0) {
+          ScopedLock lock(impl_->mutex);
+          impl_->all_done.NotifyAll();
+        }
+        continue;
+      }
+
+      //wait for new tasks
+      ScopedLock lock(impl_->mutex);
+      AtomicIncrement(&impl_->sleeping);
+      while (AtomicLoad(&impl_->queued) == 0 && !impl_->stop) {
+        impl_->work_available.Wait(impl_->mutex);
+      }
+      AtomicDecrement(&impl_->sleeping);
+      if (impl_->stop && AtomicLoad(&impl_->queued) == 0)
+        return;
+    }
+  }
+
+} //namespace threading
+} //namespace ra
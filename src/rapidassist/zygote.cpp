@@ -0,0 +1,417 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "rapidassist/zygote.h"
+
+#ifndef _WIN32
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace ra { namespace process {
+
+  //declared in process.cpp
+  extern bool CreatePipe(int fds[2]);
+
+  /// <summary>The command line argument that identifies a zygote process.</summary>
+  static const char * ZYGOTE_ARGUMENT = "--RapidAssistZygote";
+
+  /// <summary>The types of messages exchanged between a Zygote instance and the zygote process.</summary>
+  enum ZygoteMessageType {
+    ZYGOTE_MESSAGE_SPAWN   = 1, //payload: directory and arguments, each terminated by a NULL character.
+    ZYGOTE_MESSAGE_SPAWNED = 2, //payload: int32 process id. Set to -1 on failure.
+    ZYGOTE_MESSAGE_EXITED  = 3, //payload: int32 process id, int32 wait status.
+  };
+
+  struct ZygoteMessageHeader {
+    uint32_t type;
+    uint32_t size;
+  };
+
+  bool WriteAll(int fd, const void * buffer, size_t size) {
+    const char * data = (const char *)buffer;
+    while (size > 0) {
+      ssize_t write_size = send(fd, data, size, MSG_NOSIGNAL);
+      if (write_size < 0 && errno == EINTR)
+        continue;
+      if (write_size <= 0)
+        return false;
+      data += write_size;
+      size -= (size_t)write_size;
+    }
+    return true;
+  }
+
+  bool ReadAll(int fd, void * buffer, size_t size) {
+    char * data = (char *)buffer;
+    while (size > 0) {
+      ssize_t read_size = read(fd, data, size);
+      if (read_size < 0 && errno == EINTR)
+        continue;
+      if (read_size <= 0)
+        return false;
+      data += read_size;
+      size -= (size_t)read_size;
+    }
+    return true;
+  }
+
+  bool WriteZygoteMessage(int fd, uint32_t type, const std::string & payload) {
+    ZygoteMessageHeader header;
+    header.type = type;
+    header.size = (uint32_t)payload.size();
+    if (!WriteAll(fd, &header, sizeof(header)))
+      return false;
+    if (!payload.empty() && !WriteAll(fd, payload.data(), payload.size()))
+      return false;
+    return true;
+  }
+
+  bool ReadZygoteMessage(int fd, uint32_t & type, std::string & payload) {
+    ZygoteMessageHeader header;
+    if (!ReadAll(fd, &header, sizeof(header)))
+      return false;
+    type = header.type;
+    payload.assign(header.size, '\0');
+    if (header.size > 0 && !ReadAll(fd, &payload[0], payload.size()))
+      return false;
+    return true;
+  }
+
+  ///=========================================================================================
+  ///                                 Zygote process
+  ///=========================================================================================
+
+  static int zygote_sigchld_pipe[2] = { -1, -1 };
+
+  void ZygoteSigChldHandler(int /*sig*/) {
+    int errno_copy = errno;
+    char c = 0;
+    ssize_t write_size = write(zygote_sigchld_pipe[1], &c, 1);
+    (void)write_size;
+    errno = errno_copy;
+  }
+
+  void ReapZygoteChildren(int sock) {
+    int status = 0;
+    pid_t pid = 0;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+      int32_t values[2];
+      values[0] = (int32_t)pid;
+      values[1] = (int32_t)status;
+      std::string payload((const char *)values, sizeof(values));
+      if (!WriteZygoteMessage(sock, ZYGOTE_MESSAGE_EXITED, payload))
+        exit(0); //the client has disconnected
+    }
+  }
+
+  bool RunZygote(int & argc, char ** & argv) {
+    bool is_zygote = false;
+    for (int i = 1; i < argc && !is_zygote; i++) {
+      if (argv[i] != NULL && strcmp(argv[i], ZYGOTE_ARGUMENT) == 0)
+        is_zygote = true;
+    }
+    if (!is_zygote)
+      return false;
+
+    //the standard input is the socket connected to the Zygote instance
+    const int sock = STDIN_FILENO;
+
+    //use a pipe to be notified of SIGCHLD signals in the poll() loop
+    if (!CreatePipe(zygote_sigchld_pipe))
+      exit(1);
+    fcntl(zygote_sigchld_pipe[0], F_SETFL, fcntl(zygote_sigchld_pipe[0], F_GETFL) | O_NONBLOCK);
+    fcntl(zygote_sigchld_pipe[1], F_SETFL, fcntl(zygote_sigchld_pipe[1], F_GETFL) | O_NONBLOCK);
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = ZygoteSigChldHandler;
+    act.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&act.sa_mask);
+    sigaction(SIGCHLD, &act, NULL);
+
+    while (true) {
+      struct pollfd fds[2];
+      fds[0].fd = sock;
+      fds[0].events = POLLIN;
+      fds[0].revents = 0;
+      fds[1].fd = zygote_sigchld_pipe[0];
+      fds[1].events = POLLIN;
+      fds[1].revents = 0;
+      int poll_result = poll(fds, 2, -1);
+      if (poll_result < 0) {
+        if (errno == EINTR)
+          continue;
+        exit(1);
+      }
+
+      //report terminated children
+      if (fds[1].revents != 0) {
+        char buffer[256];
+        while (read(zygote_sigchld_pipe[0], buffer, sizeof(buffer)) > 0) {
+        }
+        ReapZygoteChildren(sock);
+      }
+
+      if (fds[0].revents == 0)
+        continue;
+
+      uint32_t type = 0;
+      std::string payload;
+      if (!ReadZygoteMessage(sock, type, payload))
+        exit(0); //the client has disconnected
+      if (type != ZYGOTE_MESSAGE_SPAWN)
+        continue;
+
+      //flush output buffers to prevent the children from writing them again
+      fflush(NULL);
+
+      pid_t pid = fork();
+      if (pid == 0) {
+        //child process
+        signal(SIGCHLD, SIG_DFL);
+        close(zygote_sigchld_pipe[0]);
+        close(zygote_sigchld_pipe[1]);
+
+        //disconnect from the client
+        int devnull = open("/dev/null", O_RDONLY);
+        if (devnull < 0 || dup2(devnull, STDIN_FILENO) < 0)
+          _exit(127);
+        if (devnull != STDIN_FILENO)
+          close(devnull);
+
+        //the payload contains the directory followed by the arguments
+        ra::strings::StringVector values;
+        size_t offset = 0;
+        while (offset < payload.size()) {
+          size_t length = strlen(&payload[offset]);
+          values.push_back(std::string(&payload[offset], length));
+          offset += length + 1;
+        }
+        if (values.empty() || chdir(values[0].c_str()) != 0)
+          _exit(127);
+
+        //replace argc and argv. The storage must outlive this function.
+        static ra::strings::StringVector arguments;
+        static std::vector<char *> new_argv;
+        arguments.assign(values.begin() + 1, values.end());
+        new_argv.clear();
+        new_argv.push_back(argv[0]);
+        for (size_t i = 0; i < arguments.size(); i++) {
+          new_argv.push_back((char *)arguments[i].c_str());
+        }
+        new_argv.push_back(NULL);
+        argc = (int)(new_argv.size() - 1);
+        argv = &new_argv[0];
+        return true;
+      }
+
+      //zygote process
+      int32_t child_pid = (pid > 0 ? (int32_t)pid : -1);
+      std::string reply((const char *)&child_pid, sizeof(child_pid));
+      if (!WriteZygoteMessage(sock, ZYGOTE_MESSAGE_SPAWNED, reply))
+        exit(0); //the client has disconnected
+    }
+
+    return false;
+  }
+
+  ///=========================================================================================
+  ///                                 Zygote class
+  ///=========================================================================================
+
+  Zygote::Zygote() :
+    socket_(-1),
+    zygote_pid_(INVALID_PROCESS_ID)
+  {
+  }
+
+  Zygote::~Zygote() {
+    Stop();
+  }
+
+  bool Zygote::Start(const std::string & exec_path, const std::string & default_directory) {
+    if (IsStarted())
+      return false;
+
+    int fds[2];
+#if defined(__linux__)
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+      return false;
+#else
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+      return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+#if defined(__APPLE__)
+    int no_sigpipe = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+    //launch the zygote with the socket as its standard input
+    SpawnOptions options;
+    options.stdin_fd = fds[1];
+    ra::strings::StringVector arguments;
+    arguments.push_back(ZYGOTE_ARGUMENT);
+    processid_t pid = StartProcess(exec_path, default_directory, arguments, options);
+    close(fds[1]);
+    if (pid == INVALID_PROCESS_ID) {
+      close(fds[0]);
+      return false;
+    }
+
+    socket_ = fds[0];
+    zygote_pid_ = pid;
+    return true;
+  }
+
+  bool Zygote::Stop() {
+    if (!IsStarted())
+      return false;
+
+    //the zygote exits when the socket is closed
+    close(socket_);
+    socket_ = -1;
+
+    int status = 0;
+    pid_t result_pid = 0;
+    do {
+      result_pid = waitpid(zygote_pid_, &status, 0);
+    } while (result_pid < 0 && errno == EINTR);
+    zygote_pid_ = INVALID_PROCESS_ID;
+
+    running_.clear();
+    exit_statuses_.clear();
+
+    return true;
+  }
+
+  bool Zygote::IsStarted() const {
+    return (socket_ >= 0);
+  }
+
+  processid_t Zygote::GetZygoteProcessId() const {
+    return zygote_pid_;
+  }
+
+  processid_t Zygote::Spawn(const std::string & default_directory, const ra::strings::StringVector & arguments) {
+    if (!IsStarted())
+      return INVALID_PROCESS_ID;
+
+    //the payload contains the directory followed by the arguments
+    std::string payload;
+    payload.append(default_directory);
+    payload.append(1, '\0');
+    for (size_t i = 0; i < arguments.size(); i++) {
+      payload.append(arguments[i]);
+      payload.append(1, '\0');
+    }
+    if (!SendMessage(ZYGOTE_MESSAGE_SPAWN, payload))
+      return INVALID_PROCESS_ID;
+
+    //wait for the reply
+    while (true) {
+      uint32_t type = 0;
+      if (!ReadMessage(type, payload))
+        return INVALID_PROCESS_ID;
+
+      if (type == ZYGOTE_MESSAGE_EXITED) {
+        ProcessExitMessage(payload);
+      }
+      else if (type == ZYGOTE_MESSAGE_SPAWNED && payload.size() == sizeof(int32_t)) {
+        int32_t child_pid = -1;
+        memcpy(&child_pid, payload.data(), sizeof(child_pid));
+        if (child_pid <= 0)
+          return INVALID_PROCESS_ID;
+        processid_t pid = (processid_t)child_pid;
+        running_.insert(pid);
+        exit_statuses_.erase(pid);
+        return pid;
+      }
+    }
+  }
+
+  bool Zygote::WaitExit(const processid_t & pid, int & exit_code) {
+    while (true) {
+      ProcessStatusMap::iterator it = exit_statuses_.find(pid);
+      if (it != exit_statuses_.end()) {
+        int status = it->second;
+        exit_statuses_.erase(it);
+        exit_code = -1;
+        if (WIFEXITED(status))
+          exit_code = WEXITSTATUS(status);
+        return true;
+      }
+
+      //is this process a child of the zygote?
+      if (running_.find(pid) == running_.end())
+        return false;
+
+      uint32_t type = 0;
+      std::string payload;
+      if (!ReadMessage(type, payload))
+        return false;
+      if (type == ZYGOTE_MESSAGE_EXITED)
+        ProcessExitMessage(payload);
+    }
+  }
+
+  bool Zygote::SendMessage(uint32_t type, const std::string & payload) {
+    bool success = WriteZygoteMessage(socket_, type, payload);
+    return success;
+  }
+
+  bool Zygote::ReadMessage(uint32_t & type, std::string & payload) {
+    bool success = ReadZygoteMessage(socket_, type, payload);
+    return success;
+  }
+
+  bool Zygote::ProcessExitMessage(const std::string & payload) {
+    if (payload.size() != 2 * sizeof(int32_t))
+      return false;
+    int32_t values[2];
+    memcpy(values, payload.data(), sizeof(values));
+    processid_t pid = (processid_t)values[0];
+    running_.erase(pid);
+    exit_statuses_[pid] = (int)values[1];
+    return true;
+  }
+
+} //namespace process
+} //namespace ra
+
+#endif //_WIN32
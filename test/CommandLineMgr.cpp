@@ -303,6 +303,11 @@ namespace ra { namespace test
     return exit_code;
   }
   //--------------------------------------------------------------------------------------------------
+  int ImmediateExitCode(int exit_code)
+  {
+    return exit_code;
+  }
+  //--------------------------------------------------------------------------------------------------
 
 } //namespace test
 } //namespace ra
@@ -50,6 +50,7 @@ namespace ra { namespace test
 
   void SleepTime(int sleep_time_ms);
   int ExitCode(int exit_code);
+  int ImmediateExitCode(int exit_code);
 
 } //namespace test
 } //namespace ra
@@ -0,0 +1,183 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestAsyncFile.h"
+#include "rapidassist/asyncfile.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/strings.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/timing.h"
+
+#include <vector>
+
+namespace ra { namespace filesystem { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestAsyncFile::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestAsyncFile::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestAsyncFile, testHandle) {
+    AsyncHandle invalid;
+    ASSERT_FALSE(invalid.IsValid());
+    ASSERT_FALSE(invalid.IsCompleted());
+    ASSERT_FALSE(invalid.Wait());
+    ASSERT_FALSE(invalid.IsSuccess());
+    ASSERT_TRUE(invalid.GetData().empty());
+
+    std::string path = ra::testing::GetTestQualifiedName() + ".txt";
+    ASSERT_TRUE(ra::filesystem::WriteFile(path, "content"));
+
+    //handles can outlive their queue and be copied
+    AsyncHandle copy;
+    {
+      AsyncFileQueue queue;
+      AsyncHandle handle = queue.ReadFileAsync(path);
+      ASSERT_TRUE(handle.IsValid());
+      copy = handle;
+    }
+    ASSERT_TRUE(copy.IsCompleted());
+    ASSERT_TRUE(copy.Wait());
+    ASSERT_TRUE(copy.IsSuccess());
+    ASSERT_EQ(std::string("content"), copy.GetData());
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestReadWriteCopy(bool allow_io_uring) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName();
+    ra::filesystem::DeleteDirectory(directory.c_str());
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(directory.c_str()));
+
+    AsyncFileQueue queue(8, allow_io_uring);
+    printf("Using io_uring: %s\n", (queue.IsUsingIoUring() ? "true" : "false"));
+
+    //write more files than the queue depth
+    static const size_t NUM_FILES = 100;
+    std::vector<AsyncHandle> handles;
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      std::string path = directory + separator + "file" + ra::strings::ToString(i) + ".txt";
+      std::string data = "content of file " + ra::strings::ToString(i);
+      if (i == 0)
+        data.clear(); //empty file
+      if (i == 1)
+        data.assign(3 * 1024 * 1024 + 1, 'a'); //large file
+      handles.push_back(queue.WriteFileAsync(path, data));
+    }
+    queue.WaitAll();
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      ASSERT_TRUE(handles[i].IsCompleted());
+      ASSERT_TRUE(handles[i].IsSuccess()) << "file" << i;
+    }
+    ASSERT_EQ(3 * 1024 * 1024 + 1, ra::filesystem::GetFileSize((directory + separator + "file1.txt").c_str()));
+
+    //read the files back
+    handles.clear();
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      handles.push_back(queue.ReadFileAsync(directory + separator + "file" + ra::strings::ToString(i) + ".txt"));
+    }
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      ASSERT_TRUE(handles[i].Wait()) << "file" << i;
+      if (i == 0)
+        ASSERT_TRUE(handles[i].GetData().empty());
+      else if (i == 1)
+        ASSERT_EQ(std::string(3 * 1024 * 1024 + 1, 'a'), handles[i].GetData());
+      else
+        ASSERT_EQ("content of file " + ra::strings::ToString(i), handles[i].GetData());
+    }
+
+    //copy a file
+    AsyncHandle copy = queue.CopyFileAsync(directory + separator + "file1.txt", directory + separator + "copy.txt");
+    ASSERT_TRUE(copy.Wait());
+    ASSERT_TRUE(ra::testing::IsFileEquals((directory + separator + "file1.txt").c_str(), (directory + separator + "copy.txt").c_str()));
+
+    //test errors
+    AsyncHandle missing = queue.ReadFileAsync(directory + separator + "missing.txt");
+    ASSERT_FALSE(missing.Wait());
+    ASSERT_FALSE(missing.IsSuccess());
+    ASSERT_TRUE(missing.GetData().empty());
+    ASSERT_FALSE(queue.ReadFileAsync(directory).Wait()); //not a file
+    ASSERT_FALSE(queue.WriteFileAsync(directory + separator + "missing" + separator + "file.txt", "data").Wait());
+    ASSERT_FALSE(queue.CopyFileAsync(directory + separator + "missing.txt", directory + separator + "copy.txt").Wait());
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(directory.c_str()));
+  }
+  TEST_F(TestAsyncFile, testReadWriteCopy) {
+    TestReadWriteCopy(true);
+  }
+  TEST_F(TestAsyncFile, testReadWriteCopyThreadPool) {
+    TestReadWriteCopy(false);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestAsyncFile, testBenchmark) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName();
+    ra::filesystem::DeleteDirectory(directory.c_str());
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(directory.c_str()));
+
+    //create many small fixture files
+    static const size_t NUM_FILES = 1000;
+    ra::strings::StringVector paths;
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      paths.push_back(directory + separator + "fixture" + ra::strings::ToString(i) + ".dat");
+      ASSERT_TRUE(ra::testing::CreateFile(paths.back().c_str(), 4096));
+    }
+
+    double start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      std::string data;
+      ASSERT_TRUE(ra::filesystem::ReadFile(paths[i], data));
+    }
+    double blocking_time = ra::timing::GetMicrosecondsTimer() - start;
+
+    for (int mode = 0; mode < 2; mode++) {
+      bool allow_io_uring = (mode == 0);
+      start = ra::timing::GetMicrosecondsTimer();
+      AsyncFileQueue queue(256, allow_io_uring);
+      std::vector<AsyncHandle> handles;
+      handles.reserve(NUM_FILES);
+      for (size_t i = 0; i < NUM_FILES; i++) {
+        handles.push_back(queue.ReadFileAsync(paths[i]));
+      }
+      for (size_t i = 0; i < NUM_FILES; i++) {
+        ASSERT_TRUE(handles[i].Wait());
+        ASSERT_EQ(4096, handles[i].GetData().size());
+      }
+      double async_time = ra::timing::GetMicrosecondsTimer() - start;
+
+      printf("Read %u files. ReadFile(): %.3f seconds, ReadFileAsync() with %s: %.3f seconds.\n",
+        (unsigned int)NUM_FILES, blocking_time, (queue.IsUsingIoUring() ? "io_uring" : "thread pool"), async_time);
+    }
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(directory.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace filesystem
+} //namespace ra
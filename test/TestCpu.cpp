@@ -0,0 +1,154 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestCpu.h"
+#include "rapidassist/cpu.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+#ifdef __linux__
+#include <sched.h> //for sched_getcpu()
+#endif
+
+namespace ra { namespace cpu { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestCpu::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestCpu::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifdef __linux__
+  TEST_F(TestCpu, testParseCpuList) {
+    CpuList cpus;
+    ASSERT_TRUE(ParseCpuList("0", cpus));
+    ASSERT_EQ(1, cpus.size());
+    ASSERT_EQ(0, cpus[0]);
+
+    ASSERT_TRUE(ParseCpuList("0-3,8,10-11", cpus));
+    ASSERT_EQ(7, cpus.size());
+    ASSERT_EQ(0, cpus[0]);
+    ASSERT_EQ(3, cpus[3]);
+    ASSERT_EQ(8, cpus[4]);
+    ASSERT_EQ(11, cpus[6]);
+
+    //unsorted and duplicated values
+    ASSERT_TRUE(ParseCpuList("4,1-2,2", cpus));
+    ASSERT_EQ(3, cpus.size());
+    ASSERT_EQ(1, cpus[0]);
+    ASSERT_EQ(4, cpus[2]);
+
+    ASSERT_TRUE(ParseCpuList("", cpus));
+    ASSERT_TRUE(cpus.empty());
+
+    ASSERT_FALSE(ParseCpuList("abc", cpus));
+    ASSERT_FALSE(ParseCpuList("3-1", cpus));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCpu, testGetCpuTopology) {
+    CpuInfoList cpus;
+    ASSERT_TRUE(GetCpuTopology(cpus));
+    ASSERT_FALSE(cpus.empty());
+
+    CpuList online;
+    ASSERT_TRUE(GetOnlineCpus(online));
+    ASSERT_FALSE(online.empty());
+
+    size_t num_online = 0;
+    for (size_t i = 0; i < cpus.size(); i++) {
+      const CpuInfo & info = cpus[i];
+      if (i > 0) {
+        ASSERT_LT(cpus[i - 1].cpu, info.cpu);
+      }
+      if (!info.online)
+        continue;
+      num_online++;
+
+      //an online cpu is its own sibling
+      ASSERT_GE(info.core_id, 0);
+      ASSERT_GE(info.package_id, 0);
+      ASSERT_NE(info.thread_siblings.end(), std::find(info.thread_siblings.begin(), info.thread_siblings.end(), info.cpu));
+    }
+    ASSERT_EQ(online.size(), num_online);
+
+    for (size_t i = 0; i < cpus.size(); i++) {
+      printf("cpu%d: online=%d, package=%d, core=%d, siblings=%d\n", cpus[i].cpu, (int)cpus[i].online, cpus[i].package_id, cpus[i].core_id, (int)cpus[i].thread_siblings.size());
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCpu, testCurrentThreadAffinity) {
+    CpuList original;
+    ASSERT_TRUE(GetCurrentThreadAffinity(original));
+    ASSERT_FALSE(original.empty());
+
+    //pin the current thread to a single cpu
+    const int cpu = original[original.size() - 1];
+    CpuList cpus(1, cpu);
+    ASSERT_TRUE(SetCurrentThreadAffinity(cpus));
+    CpuList actual;
+    ASSERT_TRUE(GetCurrentThreadAffinity(actual));
+    ASSERT_EQ(cpus, actual);
+    ASSERT_EQ(cpu, sched_getcpu());
+
+    //restore
+    ASSERT_TRUE(SetCurrentThreadAffinity(original));
+    ASSERT_TRUE(GetCurrentThreadAffinity(actual));
+    ASSERT_EQ(original, actual);
+
+    //invalid lists
+    ASSERT_FALSE(SetCurrentThreadAffinity(CpuList()));
+    ASSERT_FALSE(SetCurrentThreadAffinity(CpuList(1, -1)));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestCpu, testProcessAffinity) {
+    const std::string exec_path = "/bin/sleep";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("5");
+    ra::process::processid_t pid = ra::process::StartProcess(exec_path, curr_dir, arguments);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    CpuList original;
+    ASSERT_TRUE(GetProcessAffinity(pid, original));
+    ASSERT_FALSE(original.empty());
+
+    CpuList cpus(1, original[0]);
+    ASSERT_TRUE(SetProcessAffinity(pid, cpus));
+    CpuList actual;
+    ASSERT_TRUE(GetProcessAffinity(pid, actual));
+    ASSERT_EQ(cpus, actual);
+
+    ASSERT_TRUE(ra::process::Kill(pid));
+
+    ASSERT_FALSE(SetProcessAffinity(ra::process::INVALID_PROCESS_ID, cpus));
+    ASSERT_FALSE(GetProcessAffinity(ra::process::INVALID_PROCESS_ID, actual));
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //__linux__
+} //namespace test
+} //namespace cpu
+} //namespace ra
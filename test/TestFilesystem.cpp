@@ -29,6 +29,10 @@
 #include "rapidassist/environment.h"
 #include "rapidassist/process.h"
 #include "rapidassist/random.h"
+#include "rapidassist/threadpool.h"
+
+#include <algorithm> //for std::sort()
+#include <sys/stat.h> //for S_IFMT
 
 #ifdef __linux__
 #include <linux/fs.h>
@@ -36,6 +40,7 @@
 
 #ifndef _WIN32
 #include <sys/ioctl.h> //for ioctl()
+#include <unistd.h> //for symlink()
 #endif
 
 namespace ra { namespace filesystem { namespace test
@@ -51,6 +56,24 @@ namespace ra { namespace filesystem { namespace test
     return count;
   }
 
+  bool CreateDirectoryTree(const std::string & path, int depth, int num_directories, int num_files) {
+    if (!ra::filesystem::CreateDirectory(path.c_str()))
+      return false;
+    for (int i = 0; i < num_files; i++) {
+      std::string file_path = path + ra::filesystem::GetPathSeparatorStr() + "file" + ra::strings::ToString(i) + ".txt";
+      if (!ra::testing::CreateFile(file_path.c_str(), 0))
+        return false;
+    }
+    if (depth > 0) {
+      for (int i = 0; i < num_directories; i++) {
+        std::string dir_path = path + ra::filesystem::GetPathSeparatorStr() + "dir" + ra::strings::ToString(i);
+        if (!CreateDirectoryTree(dir_path, depth - 1, num_directories, num_files))
+          return false;
+      }
+    }
+    return true;
+  }
+
   bool CreateCarsDirectory(const std::string & base_path) {
     // base_path
     // |-cars
@@ -356,6 +379,163 @@ namespace ra { namespace filesystem { namespace test
     }
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testGetFileInfo) {
+    FileInfo info;
+
+    //test NULL and missing files
+    ASSERT_FALSE(filesystem::GetFileInfo(NULL, info));
+    ASSERT_FALSE(filesystem::GetFileInfo("", info));
+    ASSERT_FALSE(filesystem::GetFileInfo("/this/file/does/not/exist", info));
+
+    //test file
+    {
+      std::string filename = ra::testing::GetTestQualifiedName();
+      ASSERT_TRUE(ra::testing::CreateFile(filename.c_str(), 5000));
+
+      ASSERT_TRUE(filesystem::GetFileInfo(filename.c_str(), info));
+      ASSERT_EQ(ENTRY_FILE, info.type);
+      ASSERT_EQ(5000, info.size);
+      ASSERT_EQ(filesystem::GetFileModifiedDate(filename), info.modified_time);
+      ASSERT_LT(info.modified_time_nsec, (uint32_t)1000000000);
+      ASSERT_EQ(S_IFREG, info.mode & S_IFMT);
+      ASSERT_EQ((uint32_t)1, info.link_count);
+#ifndef _WIN32
+      ASSERT_GT(info.blocks, (uint64_t)0);
+      ASSERT_GT(info.inode, (uint64_t)0);
+
+      //the device and inode use the same encoding as stat()
+      struct stat file_stat;
+      ASSERT_EQ(0, stat(filename.c_str(), &file_stat));
+      ASSERT_EQ((uint64_t)file_stat.st_dev, info.device);
+      ASSERT_EQ((uint64_t)file_stat.st_ino, info.inode);
+
+      //hard links share the same device and inode
+      std::string link_path = filename + ".hardlink";
+      ASSERT_EQ(0, link(filename.c_str(), link_path.c_str()));
+      FileInfo link_info;
+      ASSERT_TRUE(filesystem::GetFileInfo(link_path.c_str(), link_info));
+      ASSERT_EQ((uint32_t)2, link_info.link_count);
+      ASSERT_EQ(info.device, link_info.device);
+      ASSERT_EQ(info.inode, link_info.inode);
+      ra::filesystem::DeleteFile(link_path.c_str());
+#endif
+
+      //cleanup
+      ra::filesystem::DeleteFile(filename.c_str());
+    }
+
+    //test directory
+    {
+      std::string directory = ra::testing::GetTestQualifiedName() + ".dir";
+      ASSERT_TRUE(filesystem::CreateDirectory(directory.c_str()));
+
+      ASSERT_TRUE(filesystem::GetFileInfo(directory.c_str(), info));
+      ASSERT_EQ(ENTRY_DIRECTORY, info.type);
+      ASSERT_EQ(S_IFDIR, info.mode & S_IFMT);
+
+      //cleanup
+      ra::filesystem::DeleteDirectory(directory.c_str());
+    }
+
+#ifndef _WIN32
+    //symbolic links are followed
+    {
+      std::string filename = ra::testing::GetTestQualifiedName();
+      std::string link_path = filename + ".link";
+      ASSERT_TRUE(ra::testing::CreateFile(filename.c_str(), 100));
+      ASSERT_EQ(0, symlink(filename.c_str(), link_path.c_str()));
+
+      ASSERT_TRUE(filesystem::GetFileInfo(link_path.c_str(), info));
+      ASSERT_EQ(ENTRY_FILE, info.type);
+      ASSERT_EQ(100, info.size);
+
+      //cleanup
+      ra::filesystem::DeleteFile(link_path.c_str());
+      ra::filesystem::DeleteFile(filename.c_str());
+    }
+#endif
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testGetFileInfos) {
+    //create files
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateDirectoryTree(basePath, 1, 4, 50));
+    ra::strings::StringVector paths;
+    ASSERT_TRUE(filesystem::FindFiles(paths, basePath.c_str()));
+    ASSERT_EQ(254, paths.size());
+
+    //add missing files
+    paths.insert(paths.begin() + 10, basePath + "/missing1");
+    paths.push_back(basePath + "/missing2");
+
+    static const size_t THREAD_COUNTS[] = { 0, 1, 3, 8 };
+    for (size_t i = 0; i < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); i++) {
+      std::vector<FileInfo> infos;
+      size_t count = filesystem::GetFileInfos(paths, infos, THREAD_COUNTS[i]);
+      ASSERT_EQ(254, count);
+      ASSERT_EQ(paths.size(), infos.size());
+
+      for (size_t j = 0; j < paths.size(); j++) {
+        FileInfo expected;
+        if (filesystem::GetFileInfo(paths[j].c_str(), expected)) {
+          ASSERT_EQ(expected.type, infos[j].type) << paths[j];
+          ASSERT_EQ(expected.size, infos[j].size) << paths[j];
+          ASSERT_EQ(expected.modified_time, infos[j].modified_time) << paths[j];
+        }
+        else {
+          ASSERT_EQ(ENTRY_UNKNOWN, infos[j].type) << paths[j];
+          ASSERT_EQ(0, infos[j].size) << paths[j];
+        }
+      }
+    }
+
+    //test empty list
+    {
+      ra::strings::StringVector empty;
+      std::vector<FileInfo> infos(3);
+      ASSERT_EQ(0, filesystem::GetFileInfos(empty, infos));
+      ASSERT_EQ(0, infos.size());
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testGetFileInfosBenchmark) {
+    //create files
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateDirectoryTree(basePath, 2, 10, 20));
+    ra::strings::StringVector paths;
+    ASSERT_TRUE(filesystem::FindFiles(paths, basePath.c_str()));
+
+    //sequential loop
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    size_t sequential_count = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+      if (filesystem::GetFileSize64(paths[i].c_str()) > 0 || filesystem::GetFileModifiedDate(paths[i]) > 0)
+        sequential_count++;
+    }
+    double time_end = ra::timing::GetMicrosecondsTimer();
+    printf("GetFileSize64() and GetFileModifiedDate() loop on %d paths took %.3f ms\n", (int)paths.size(), (time_end - time_start) * 1000.0);
+    ASSERT_EQ(paths.size(), sequential_count);
+
+    static const size_t THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+    for (size_t i = 0; i < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); i++) {
+      const size_t num_threads = THREAD_COUNTS[i];
+
+      std::vector<FileInfo> infos;
+      time_start = ra::timing::GetMicrosecondsTimer();
+      size_t count = filesystem::GetFileInfos(paths, infos, num_threads);
+      time_end = ra::timing::GetMicrosecondsTimer();
+      ASSERT_EQ(paths.size(), count);
+
+      printf("GetFileInfos() with %d threads on %d paths took %.3f ms\n", (int)num_threads, (int)paths.size(), (time_end - time_start) * 1000.0);
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestFilesystem, testFileExists) {
     //test NULL
     {
@@ -573,6 +753,280 @@ namespace ra { namespace filesystem { namespace test
     ra::filesystem::DeleteDirectory(basePath.c_str());
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testFindFilesParallel) {
+    //test NULL
+    {
+      ra::strings::StringVector files;
+      bool success = filesystem::FindFilesParallel(files, NULL, -1, 2, false);
+      ASSERT_FALSE(success);
+    }
+
+    //test missing directory
+    {
+      ra::strings::StringVector files;
+      bool success = filesystem::FindFilesParallel(files, "/this/directory/does/not/exist", -1, 2, false);
+      ASSERT_FALSE(success);
+    }
+
+    //create cars directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    {
+      bool carsOK = CreateCarsDirectory(basePath);
+      ASSERT_TRUE(carsOK);
+    }
+
+    //assert the same files are found as FindFiles() for all depths and thread counts
+    static const size_t THREAD_COUNTS[] = { 0, 1, 2, 4, 8 };
+    for (int depth = -1; depth <= 3; depth++) {
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(filesystem::FindFiles(expected, basePath.c_str(), depth));
+      std::sort(expected.begin(), expected.end());
+
+      for (size_t i = 0; i < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); i++) {
+        ra::strings::StringVector files;
+        bool success = filesystem::FindFilesParallel(files, basePath.c_str(), depth, THREAD_COUNTS[i], true);
+        ASSERT_TRUE(success);
+        ASSERT_EQ(expected, files) << "depth=" << depth << " num_threads=" << THREAD_COUNTS[i];
+      }
+    }
+
+    //test unsorted results
+    {
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(filesystem::FindFiles(expected, basePath.c_str()));
+      std::sort(expected.begin(), expected.end());
+
+      ra::strings::StringVector files;
+      bool success = filesystem::FindFilesParallel(files, basePath.c_str());
+      ASSERT_TRUE(success);
+      std::sort(files.begin(), files.end());
+      ASSERT_EQ(expected, files);
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testFindFilesParallelBenchmark) {
+    //create a large directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateDirectoryTree(basePath, 3, 8, 4));
+
+    //warm up the file system cache
+    ra::strings::StringVector expected;
+    ASSERT_TRUE(filesystem::FindFiles(expected, basePath.c_str()));
+
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    ra::strings::StringVector files;
+    ASSERT_TRUE(filesystem::FindFiles(files, basePath.c_str()));
+    double time_end = ra::timing::GetMicrosecondsTimer();
+    printf("FindFiles() found %d files in %.3f ms\n", (int)files.size(), (time_end - time_start) * 1000.0);
+
+    //double the number of threads up to the number of processors, and beyond since directory walks are bound by I/O
+    const size_t num_processors = ra::threading::GetProcessorCount();
+    const size_t max_threads = 4 * num_processors;
+    std::vector<size_t> thread_counts;
+    for (size_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+      if (num_threads > num_processors && thread_counts.back() < num_processors)
+        thread_counts.push_back(num_processors);
+      thread_counts.push_back(num_threads);
+    }
+    if (thread_counts.back() < num_processors)
+      thread_counts.push_back(num_processors);
+    thread_counts.push_back(max_threads);
+
+    for (size_t i = 0; i < thread_counts.size(); i++) {
+      const size_t num_threads = thread_counts[i];
+
+      files.clear();
+      time_start = ra::timing::GetMicrosecondsTimer();
+      ASSERT_TRUE(filesystem::FindFilesParallel(files, basePath.c_str(), -1, num_threads, false));
+      time_end = ra::timing::GetMicrosecondsTimer();
+      ASSERT_EQ(expected.size(), files.size());
+
+      printf("FindFilesParallel() with %d threads found %d files in %.3f ms\n", (int)num_threads, (int)files.size(), (time_end - time_start) * 1000.0);
+    }
+    printf("Number of processors: %d\n", (int)num_processors);
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  class DirectoryEntryCollector : public IDirectoryVisitor {
+  public:
+    DirectoryEntryCollector() : stop_after_(0), skipped_name_(NULL) {}
+    virtual VisitAction OnDirectoryEntry(const DirectoryEntry & entry) {
+      entries_.push_back(entry);
+      if (stop_after_ > 0 && entries_.size() == stop_after_)
+        return VISIT_STOP;
+      if (skipped_name_ && entry.name == skipped_name_)
+        return VISIT_SKIP_SUBTREE;
+      return VISIT_CONTINUE;
+    }
+    std::vector<DirectoryEntry> entries_;
+    size_t stop_after_;
+    const char * skipped_name_;
+  };
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testDirectoryIterator) {
+    //test NULL and missing directories
+    {
+      DirectoryIterator iterator;
+      ASSERT_FALSE(iterator.Open(NULL, -1));
+      ASSERT_FALSE(iterator.Open("/this/directory/does/not/exist", -1));
+
+      DirectoryEntry entry;
+      ASSERT_FALSE(iterator.Next(entry));
+    }
+
+    //create cars directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    {
+      bool carsOK = CreateCarsDirectory(basePath);
+      ASSERT_TRUE(carsOK);
+    }
+
+    //assert the same entries are returned in the same order as FindFiles()
+    for (int depth = -1; depth <= 2; depth++) {
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(filesystem::FindFiles(expected, basePath.c_str(), depth));
+
+      ra::strings::StringVector files;
+      DirectoryIterator iterator;
+      ASSERT_TRUE(iterator.Open(basePath.c_str(), depth));
+      DirectoryEntry entry;
+      while (iterator.Next(entry)) {
+        files.push_back(entry.path);
+      }
+      ASSERT_EQ(expected, files) << "depth=" << depth;
+    }
+
+    //assert entry properties
+    {
+      DirectoryIterator iterator;
+      ASSERT_TRUE(iterator.Open(basePath.c_str(), -1));
+      DirectoryEntry entry;
+      size_t count = 0;
+      while (iterator.Next(entry)) {
+        count++;
+        ASSERT_EQ(entry.name, ra::filesystem::GetFilename(entry.path.c_str()));
+        if (entry.name == "cars") {
+          ASSERT_EQ(ENTRY_DIRECTORY, entry.type);
+          ASSERT_EQ(0, entry.depth);
+        }
+        else if (entry.name == "Toyota" || entry.name == "Mazda") {
+          ASSERT_EQ(ENTRY_DIRECTORY, entry.type);
+          ASSERT_EQ(1, entry.depth);
+        }
+        else if (entry.name == "Camry.txt") {
+          ASSERT_EQ(ENTRY_FILE, entry.type);
+          ASSERT_EQ(2, entry.depth);
+        }
+      }
+      ASSERT_EQ(12, count);
+    }
+
+    //test SkipSubtree()
+    {
+      DirectoryIterator iterator;
+      ASSERT_TRUE(iterator.Open(basePath.c_str(), -1));
+      DirectoryEntry entry;
+      size_t count = 0;
+      while (iterator.Next(entry)) {
+        ASSERT_EQ(std::string::npos, entry.path.find(std::string("Volkswagen") + ra::filesystem::GetPathSeparatorStr()));
+        if (entry.name == "Volkswagen")
+          iterator.SkipSubtree();
+        count++;
+      }
+      ASSERT_EQ(9, count);
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestFilesystem, testDirectoryIteratorSymlink) {
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateCarsDirectory(basePath));
+
+    //symbolic links to directories are not followed
+    std::string link_path = basePath + "/link";
+    ASSERT_EQ(0, symlink("cars", link_path.c_str()));
+
+    DirectoryIterator iterator;
+    ASSERT_TRUE(iterator.Open(basePath.c_str(), -1));
+    DirectoryEntry entry;
+    bool found = false;
+    while (iterator.Next(entry)) {
+      ASSERT_EQ(std::string::npos, entry.path.find("link/"));
+      if (entry.name == "link") {
+        ASSERT_EQ(ENTRY_SYMLINK, entry.type);
+        found = true;
+      }
+    }
+    ASSERT_TRUE(found);
+
+    //cleanup, symbolic links are deleted without following them
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(basePath.c_str()));
+    ASSERT_FALSE(ra::filesystem::DirectoryExists(basePath.c_str()));
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testVisitDirectory) {
+    //test NULL
+    {
+      DirectoryEntryCollector visitor;
+      ASSERT_FALSE(filesystem::VisitDirectory(NULL, -1, &visitor));
+      ASSERT_FALSE(filesystem::VisitDirectory(".", -1, NULL));
+    }
+
+    //create cars directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    {
+      bool carsOK = CreateCarsDirectory(basePath);
+      ASSERT_TRUE(carsOK);
+    }
+
+    //visit all
+    {
+      DirectoryEntryCollector visitor;
+      ASSERT_TRUE(filesystem::VisitDirectory(basePath.c_str(), -1, &visitor));
+      ASSERT_EQ(12, visitor.entries_.size());
+    }
+
+    //visit with limited depth
+    {
+      DirectoryEntryCollector visitor;
+      ASSERT_TRUE(filesystem::VisitDirectory(basePath.c_str(), 0, &visitor));
+      ASSERT_EQ(1, visitor.entries_.size());
+      ASSERT_EQ("cars", visitor.entries_[0].name);
+    }
+
+    //prune a subdirectory
+    {
+      DirectoryEntryCollector visitor;
+      visitor.skipped_name_ = "Toyota";
+      ASSERT_TRUE(filesystem::VisitDirectory(basePath.c_str(), -1, &visitor));
+      ASSERT_EQ(10, visitor.entries_.size());
+      for (size_t i = 0; i < visitor.entries_.size(); i++) {
+        ASSERT_NE("Camry.txt", visitor.entries_[i].name);
+        ASSERT_NE("Corolla.txt", visitor.entries_[i].name);
+      }
+    }
+
+    //stop early
+    {
+      DirectoryEntryCollector visitor;
+      visitor.stop_after_ = 3;
+      ASSERT_TRUE(filesystem::VisitDirectory(basePath.c_str(), -1, &visitor));
+      ASSERT_EQ(3, visitor.entries_.size());
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestFilesystem, testFindFileFromPaths) {
     //test no result
     {
@@ -1973,6 +2427,287 @@ namespace ra { namespace filesystem { namespace test
     ASSERT_TRUE(functor.hasProgressEnd());
   }
   //--------------------------------------------------------------------------------------------------
+  class CopyFileProgressRecorder : public virtual ra::filesystem::IProgressReport {
+  public:
+    virtual ~CopyFileProgressRecorder() {};
+    virtual void OnProgressReport(double progress) {
+      values.push_back(progress);
+    }
+    std::vector<double> values;
+  };
+  TEST_F(TestFilesystem, testCopyFileLarge) {
+    const std::string temp_dir = filesystem::GetTemporaryDirectory();
+    const std::string source_path = temp_dir + ra::filesystem::GetPathSeparator() + ra::testing::GetTestQualifiedName() + ".source.tmp";
+    const std::string output_path = temp_dir + ra::filesystem::GetPathSeparator() + ra::testing::GetTestQualifiedName() + ".output.tmp";
+
+    //create a file larger than a single copy chunk
+    static const size_t FILE_SIZE = 20 * 1024 * 1024 + 123;
+    ASSERT_TRUE(ra::testing::CreateFile(source_path.c_str(), FILE_SIZE));
+
+    CopyFileProgressRecorder recorder;
+    double start = ra::timing::GetMicrosecondsTimer();
+    bool copied = ra::filesystem::CopyFile(source_path, output_path, &recorder);
+    double end = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(copied);
+    printf("Copied %u bytes in %.3f seconds.\n", (unsigned int)FILE_SIZE, end - start);
+
+    ASSERT_EQ(FILE_SIZE, ra::filesystem::GetFileSize(output_path.c_str()));
+    std::string reason;
+    ASSERT_TRUE(ra::testing::IsFileEquals(source_path.c_str(), output_path.c_str(), reason)) << reason;
+
+    //assert progress starts at 0, ends at 1 and never goes backward
+    ASSERT_GE(recorder.values.size(), 2u);
+    ASSERT_EQ(0.0, recorder.values.front());
+    ASSERT_EQ(1.0, recorder.values.back());
+    for (size_t i = 1; i < recorder.values.size(); i++) {
+      ASSERT_GE(recorder.values[i], recorder.values[i - 1]);
+      ASSERT_LE(recorder.values[i], 1.0);
+    }
+
+    //copy over an existing larger file truncates the destination
+    ASSERT_TRUE(ra::testing::CreateFile(source_path.c_str(), 100));
+    ASSERT_TRUE(ra::filesystem::CopyFile(source_path, output_path));
+    ASSERT_EQ(100u, ra::filesystem::GetFileSize(output_path.c_str()));
+
+    //copy an empty file
+    ASSERT_TRUE(ra::testing::CreateFile(source_path.c_str(), 0));
+    CopyFileProgressRecorder empty_recorder;
+    ASSERT_TRUE(ra::filesystem::CopyFile(source_path, output_path, &empty_recorder));
+    ASSERT_TRUE(ra::filesystem::FileExists(output_path.c_str()));
+    ASSERT_EQ(0u, ra::filesystem::GetFileSize(output_path.c_str()));
+    ASSERT_EQ(1.0, empty_recorder.values.back());
+
+    //copy a file that does not exists
+    ASSERT_FALSE(ra::filesystem::CopyFile(source_path + ".notfound", output_path));
+
+    ASSERT_TRUE(ra::filesystem::DeleteFile(source_path.c_str()));
+    ASSERT_TRUE(ra::filesystem::DeleteFile(output_path.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifdef __linux__
+  TEST_F(TestFilesystem, testCopyFileSparse) {
+    const std::string temp_dir = filesystem::GetTemporaryDirectory();
+    const std::string source_path = temp_dir + ra::filesystem::GetPathSeparator() + ra::testing::GetTestQualifiedName() + ".source.tmp";
+    const std::string output_path = temp_dir + ra::filesystem::GetPathSeparator() + ra::testing::GetTestQualifiedName() + ".output.tmp";
+
+    //create a 1 GB sparse file with data at the beginning and in the middle of the file
+    static const uint64_t FILE_SIZE = 1024ull * 1024 * 1024;
+    static const uint64_t MIDDLE_OFFSET = 512ull * 1024 * 1024;
+    {
+      FILE * f = fopen(source_path.c_str(), "wb");
+      ASSERT_TRUE(f != NULL);
+      const std::string data(100 * 1024, 'a');
+      ASSERT_EQ(data.size(), fwrite(data.c_str(), 1, data.size(), f));
+      ASSERT_EQ(0, fseeko(f, (off_t)MIDDLE_OFFSET, SEEK_SET));
+      ASSERT_EQ(data.size(), fwrite(data.c_str(), 1, data.size(), f));
+      fclose(f);
+    }
+    ASSERT_EQ(0, truncate(source_path.c_str(), (off_t)FILE_SIZE)); //leave a hole at the end of the file
+
+    ra::filesystem::FileInfo source_info;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(source_path.c_str(), source_info));
+    if (source_info.blocks * 512 >= FILE_SIZE) {
+      ra::filesystem::DeleteFile(source_path.c_str());
+      printf("Skipping tests. The file system does not support sparse files.\n");
+      return;
+    }
+
+    CopyFileProgressRecorder recorder;
+    double start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::filesystem::CopyFile(source_path, output_path, &recorder));
+    double end = ra::timing::GetMicrosecondsTimer();
+    printf("Copied a sparse file of %llu bytes in %.3f seconds.\n", (unsigned long long)FILE_SIZE, end - start);
+
+    //assert the holes are preserved
+    ra::filesystem::FileInfo output_info;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(output_path.c_str(), output_info));
+    ASSERT_EQ(FILE_SIZE, output_info.size);
+    ASSERT_LT(output_info.blocks * 512, 16ull * 1024 * 1024);
+    ASSERT_EQ(1.0, recorder.values.back());
+
+    //assert the data was copied at the right offsets
+    {
+      FILE * f = fopen(output_path.c_str(), "rb");
+      ASSERT_TRUE(f != NULL);
+      char buffer[4] = {0};
+      ASSERT_EQ(4u, fread(buffer, 1, 4, f));
+      ASSERT_EQ(std::string("aaaa"), std::string(buffer, 4));
+      ASSERT_EQ(0, fseeko(f, (off_t)MIDDLE_OFFSET - 2, SEEK_SET));
+      ASSERT_EQ(4u, fread(buffer, 1, 4, f));
+      ASSERT_EQ(std::string("\0\0aa", 4), std::string(buffer, 4));
+      ASSERT_EQ(0, fseeko(f, (off_t)FILE_SIZE - 4, SEEK_SET));
+      ASSERT_EQ(4u, fread(buffer, 1, 4, f));
+      ASSERT_EQ(std::string(4, '\0'), std::string(buffer, 4));
+      fclose(f);
+    }
+
+    ASSERT_TRUE(ra::filesystem::DeleteFile(source_path.c_str()));
+    ASSERT_TRUE(ra::filesystem::DeleteFile(output_path.c_str()));
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+#ifdef __linux__
+  TEST_F(TestFilesystem, testCopyFileProcFile) {
+    //files in /proc reports a size of 0 but have content
+    const std::string output_path = filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparator() + ra::testing::GetTestQualifiedName() + ".tmp";
+
+    ASSERT_TRUE(ra::filesystem::CopyFile("/proc/self/status", output_path));
+    ASSERT_GT(ra::filesystem::GetFileSize(output_path.c_str()), 0u);
+
+    ASSERT_TRUE(ra::filesystem::DeleteFile(output_path.c_str()));
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+  ra::strings::StringVector GetRelativePaths(const std::string & path) {
+    ra::strings::StringVector files;
+    ra::filesystem::FindFiles(files, path.c_str(), -1);
+    for (size_t i = 0; i < files.size(); i++) {
+      files[i] = files[i].substr(path.size());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+  TEST_F(TestFilesystem, testCopyDirectory) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string source_dir = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName() + ".source";
+    const std::string output_dir = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName() + ".output";
+    ra::filesystem::DeleteDirectory(source_dir.c_str());
+    ra::filesystem::DeleteDirectory(output_dir.c_str());
+
+    ASSERT_TRUE(CreateDirectoryTree(source_dir, 2, 3, 20));
+    const std::string large_file = source_dir + separator + "large.bin";
+    ASSERT_TRUE(ra::testing::CreateFile(large_file.c_str(), 5 * 1024 * 1024 + 7));
+    const std::string small_file = source_dir + separator + "dir0" + separator + "small.txt";
+    ASSERT_TRUE(ra::filesystem::WriteTextFile(small_file, "small file content"));
+    ASSERT_TRUE(ra::filesystem::CreateDirectory((source_dir + separator + "empty").c_str()));
+#ifndef _WIN32
+    ASSERT_EQ(0, chmod(small_file.c_str(), 0640));
+    ASSERT_EQ(0, link(large_file.c_str(), (source_dir + separator + "dir1" + separator + "large.link").c_str()));
+    ASSERT_EQ(0, symlink("../large.bin", (source_dir + separator + "dir2" + separator + "large.symlink").c_str()));
+#endif
+
+    //test missing source directory
+    ASSERT_FALSE(ra::filesystem::CopyDirectory(source_dir + ".notfound", output_dir));
+
+    //test copy with default options
+    CopyFileProgressRecorder recorder;
+    double start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::filesystem::CopyDirectory(source_dir, output_dir, ra::filesystem::CopyDirectoryOptions(), &recorder));
+    double end = ra::timing::GetMicrosecondsTimer();
+    printf("Copied directory in %.3f seconds.\n", end - start);
+
+    ra::strings::StringVector source_files = GetRelativePaths(source_dir);
+    ra::strings::StringVector output_files = GetRelativePaths(output_dir);
+    ASSERT_EQ(source_files, output_files);
+    ASSERT_TRUE(ra::testing::IsFileEquals(large_file.c_str(), (output_dir + separator + "large.bin").c_str()));
+    ASSERT_TRUE(ra::filesystem::DirectoryExists((output_dir + separator + "empty").c_str()));
+
+    //assert progress starts at 0, ends at 1 and never goes backward
+    ASSERT_GE(recorder.values.size(), 2u);
+    ASSERT_EQ(0.0, recorder.values.front());
+    ASSERT_EQ(1.0, recorder.values.back());
+    for (size_t i = 1; i < recorder.values.size(); i++) {
+      ASSERT_GE(recorder.values[i], recorder.values[i - 1]);
+    }
+
+    ra::filesystem::FileInfo source_info;
+    ra::filesystem::FileInfo output_info;
+#ifndef _WIN32
+    //assert mode bits are preserved
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(small_file.c_str(), source_info));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "dir0" + separator + "small.txt").c_str(), output_info));
+    ASSERT_EQ(source_info.mode, output_info.mode);
+
+    //assert symbolic links are recreated
+    std::string output_symlink = output_dir + separator + "dir2" + separator + "large.symlink";
+    struct stat symlink_stat;
+    ASSERT_EQ(0, lstat(output_symlink.c_str(), &symlink_stat));
+    ASSERT_TRUE(S_ISLNK(symlink_stat.st_mode));
+
+    //assert hard links are copied as distinct files by default
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "large.bin").c_str(), output_info));
+    ASSERT_EQ((uint32_t)1, output_info.link_count);
+#endif
+
+    //test overwrite disabled
+    const std::string output_small_file = output_dir + separator + "dir0" + separator + "small.txt";
+    ASSERT_TRUE(ra::filesystem::WriteTextFile(output_small_file, "modified"));
+    ra::filesystem::CopyDirectoryOptions options;
+    options.overwrite = false;
+    ASSERT_TRUE(ra::filesystem::CopyDirectory(source_dir, output_dir, options, NULL));
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(output_small_file, content));
+    ASSERT_EQ(std::string("modified"), content);
+
+    //test overwrite enabled
+    ASSERT_TRUE(ra::filesystem::CopyDirectory(source_dir, output_dir));
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(output_small_file, content));
+    ASSERT_EQ(std::string("small file content"), content);
+
+    //test preserving modification times and hard links
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(output_dir.c_str()));
+    options = ra::filesystem::CopyDirectoryOptions();
+    options.preserve_times = true;
+    options.preserve_hardlinks = true;
+    ASSERT_TRUE(ra::filesystem::CopyDirectory(source_dir, output_dir, options, NULL));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(large_file.c_str(), source_info));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "large.bin").c_str(), output_info));
+    ASSERT_EQ(source_info.modified_time, output_info.modified_time);
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((source_dir + separator + "dir1").c_str(), source_info));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "dir1").c_str(), output_info));
+    ASSERT_EQ(source_info.modified_time, output_info.modified_time);
+#ifndef _WIN32
+    ra::filesystem::FileInfo link_info;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "large.bin").c_str(), output_info));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo((output_dir + separator + "dir1" + separator + "large.link").c_str(), link_info));
+    ASSERT_EQ((uint32_t)2, output_info.link_count);
+    ASSERT_EQ(output_info.inode, link_info.inode);
+#endif
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(source_dir.c_str()));
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(output_dir.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testCopyDirectoryBenchmark) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string source_dir = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName() + ".source";
+    const std::string output_dir = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName() + ".output";
+    ra::filesystem::DeleteDirectory(source_dir.c_str());
+    ra::filesystem::DeleteDirectory(output_dir.c_str());
+
+    //create many small files
+    ASSERT_TRUE(CreateDirectoryTree(source_dir, 2, 10, 20));
+    ra::strings::StringVector files;
+    ASSERT_TRUE(ra::filesystem::FindFiles(files, source_dir.c_str(), -1));
+
+    //copy with a single thread, one file at a time
+    double start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(output_dir.c_str()));
+    for (size_t i = 0; i < files.size(); i++) {
+      std::string output_path = output_dir + files[i].substr(source_dir.size());
+      if (ra::filesystem::DirectoryExists(files[i].c_str()))
+        ASSERT_TRUE(ra::filesystem::CreateDirectory(output_path.c_str()));
+      else
+        ASSERT_TRUE(ra::filesystem::CopyFile(files[i], output_path));
+    }
+    double sequential_time = ra::timing::GetMicrosecondsTimer() - start;
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(output_dir.c_str()));
+
+    //copy with CopyDirectory()
+    start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::filesystem::CopyDirectory(source_dir, output_dir));
+    double parallel_time = ra::timing::GetMicrosecondsTimer() - start;
+    ASSERT_EQ(GetRelativePaths(source_dir), GetRelativePaths(output_dir));
+
+    printf("Copied %u entries. Loop: %.3f seconds, CopyDirectory: %.3f seconds with %u threads.\n",
+      (unsigned int)files.size(), sequential_time, parallel_time, (unsigned int)ra::threading::GetProcessorCount());
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(source_dir.c_str()));
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(output_dir.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestFilesystem, testReadFile) {
     //test file not found
     {
@@ -2099,6 +2834,89 @@ namespace ra { namespace filesystem { namespace test
     ra::filesystem::DeleteFile(file_path.c_str());
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testReadTextFileNormalize) {
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".txt";
+
+    struct TEST_CASE {
+      const char * content;
+      const char * expected;
+    };
+    static const TEST_CASE test_cases[] = {
+      {"", ""},
+      {"abc", "abc"},
+      {"a\r\nb\r\nc", "a\nb\nc"},
+      {"\r\n\r\n", "\n\n"},
+      {"a\rb\r", "a\rb\r"},           //isolated CR characters are kept
+      {"a\r\r\nb\n\r", "a\r\nb\n\r"},
+      {"unix\nfile\n", "unix\nfile\n"},
+    };
+    for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+      const TEST_CASE & test_case = test_cases[i];
+      ASSERT_TRUE(ra::filesystem::WriteFile(file_path, test_case.content));
+
+      std::string content;
+      ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, content, true));
+      ASSERT_EQ(std::string(test_case.expected), content) << "content=" << test_case.content;
+
+      ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, content, false));
+      ASSERT_EQ(std::string(test_case.content), content);
+    }
+
+    //test file not found
+    std::string content = "not empty";
+    ASSERT_FALSE(ra::filesystem::ReadTextFile("this file is not found", content, true));
+    ASSERT_TRUE(content.empty());
+
+#ifdef __linux__
+    //test files which size is unknown
+    ASSERT_TRUE(ra::filesystem::ReadTextFile("/proc/self/status", content, false));
+    ASSERT_FALSE(content.empty());
+#endif
+
+    //cleanup
+    ra::filesystem::DeleteFile(file_path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testReadTextFileBenchmark) {
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".txt";
+
+    //create a 128 MB text file with CRLF line endings
+    {
+      FILE * f = fopen(file_path.c_str(), "wb");
+      ASSERT_TRUE(f != NULL);
+      const std::string line = "2020-01-01 00:00:00 INFO This is a typical line of a log file with some content.\r\n";
+      for (size_t i = 0; i < 128 * 1024 * 1024 / line.size(); i++) {
+        fwrite(line.c_str(), 1, line.size(), f);
+      }
+      fclose(f);
+    }
+
+    //previous implementation: read line by line and join the lines
+    double start = ra::timing::GetMicrosecondsTimer();
+    ra::strings::StringVector lines;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, lines, false));
+    std::string joined = ra::strings::Join(lines, "");
+    double lines_time = ra::timing::GetMicrosecondsTimer() - start;
+    lines.clear();
+
+    start = ra::timing::GetMicrosecondsTimer();
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, content, false));
+    double single_read_time = ra::timing::GetMicrosecondsTimer() - start;
+    ASSERT_EQ(joined.size(), content.size());
+    joined.clear();
+
+    start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, content, true));
+    double normalize_time = ra::timing::GetMicrosecondsTimer() - start;
+
+    printf("Read %u bytes. Lines and Join(): %.3f seconds, single read: %.3f seconds, single read with CRLF normalization: %.3f seconds.\n",
+      (unsigned int)ra::filesystem::GetFileSize(file_path.c_str()), lines_time, single_read_time, normalize_time);
+
+    //cleanup
+    ra::filesystem::DeleteFile(file_path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestFilesystem, testWriteTextFileFromString) {
     const std::string newline = ra::environment::GetLineSeparator();
     const std::string content =
@@ -2307,6 +3125,147 @@ namespace ra { namespace filesystem { namespace test
     }
   }
   //--------------------------------------------------------------------------------------------------
+  size_t CountTemporaryFiles(const std::string & directory) {
+    ra::strings::StringVector files;
+    ra::filesystem::FindFiles(files, directory.c_str(), 0);
+    size_t count = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+      if (files[i].find(".tmp") != std::string::npos)
+        count++;
+    }
+    return count;
+  }
+  TEST_F(TestFilesystem, testAtomicWriteFile) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName();
+    ra::filesystem::DeleteDirectory(directory.c_str());
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(directory.c_str()));
+    const std::string file_path = directory + separator + "state.dat";
+
+    //test new file
+    ASSERT_TRUE(ra::filesystem::AtomicWriteFile(file_path, "first"));
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadFile(file_path, content));
+    ASSERT_EQ(std::string("first"), content);
+
+    //test replacing an existing file
+#ifndef _WIN32
+    ASSERT_EQ(0, chmod(file_path.c_str(), 0640));
+#endif
+    ASSERT_TRUE(ra::filesystem::AtomicWriteFile(file_path, std::string("second\0binary", 13)));
+    ASSERT_TRUE(ra::filesystem::ReadFile(file_path, content));
+    ASSERT_EQ(std::string("second\0binary", 13), content);
+#ifndef _WIN32
+    ra::filesystem::FileInfo info;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), info));
+    ASSERT_EQ((uint32_t)0640, info.mode & 0777);
+#endif
+
+    //test empty content
+    ASSERT_TRUE(ra::filesystem::AtomicWriteFile(file_path, ""));
+    ASSERT_EQ(0, ra::filesystem::GetFileSize(file_path.c_str()));
+
+    //test invalid directory
+    ASSERT_FALSE(ra::filesystem::AtomicWriteFile(directory + separator + "missing" + separator + "state.dat", "data"));
+
+    ASSERT_EQ(0, CountTemporaryFiles(directory));
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(directory.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testDurableWriteBatch) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName();
+    ra::filesystem::DeleteDirectory(directory.c_str());
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(directory.c_str()));
+
+    static const size_t NUM_FILES = 50;
+    ra::strings::StringVector paths;
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      paths.push_back(directory + separator + "state" + ra::strings::ToString(i) + ".dat");
+    }
+    ASSERT_TRUE(ra::filesystem::WriteFile(paths[0], "previous content"));
+
+    //files are not modified until the batch is committed
+    {
+      DurableWriteBatch batch;
+      for (size_t i = 0; i < NUM_FILES; i++) {
+        ASSERT_TRUE(batch.Add(paths[i], "content of file " + ra::strings::ToString(i)));
+      }
+      ASSERT_EQ(NUM_FILES, batch.GetCount());
+      ASSERT_FALSE(ra::filesystem::FileExists(paths[1].c_str()));
+
+      std::string content;
+      ASSERT_TRUE(ra::filesystem::ReadFile(paths[0], content));
+      ASSERT_EQ(std::string("previous content"), content);
+
+      ASSERT_TRUE(batch.Commit());
+      ASSERT_EQ(0, batch.GetCount());
+    }
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      std::string content;
+      ASSERT_TRUE(ra::filesystem::ReadFile(paths[i], content));
+      ASSERT_EQ("content of file " + ra::strings::ToString(i), content);
+    }
+    ASSERT_EQ(0, CountTemporaryFiles(directory));
+
+    //test uncommitted files are discarded
+    {
+      DurableWriteBatch batch;
+      ASSERT_TRUE(batch.Add(paths[0], "discarded"));
+      ASSERT_TRUE(batch.Add(directory + separator + "new.dat", "discarded"));
+      ASSERT_EQ(2, CountTemporaryFiles(directory));
+      batch.Clear();
+      ASSERT_EQ(0, batch.GetCount());
+      ASSERT_EQ(0, CountTemporaryFiles(directory));
+
+      ASSERT_TRUE(batch.Add(paths[0], "discarded"));
+    }
+    ASSERT_EQ(0, CountTemporaryFiles(directory));
+    ASSERT_FALSE(ra::filesystem::FileExists((directory + separator + "new.dat").c_str()));
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadFile(paths[0], content));
+    ASSERT_EQ(std::string("content of file 0"), content);
+
+    //test invalid directory
+    DurableWriteBatch batch;
+    ASSERT_FALSE(batch.Add(directory + separator + "missing" + separator + "state.dat", "data"));
+    ASSERT_TRUE(batch.Commit()); //empty batch
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(directory.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testDurableWriteBatchBenchmark) {
+    const std::string separator = ra::filesystem::GetPathSeparatorStr();
+    const std::string directory = ra::filesystem::GetTemporaryDirectory() + separator + ra::testing::GetTestQualifiedName();
+    ra::filesystem::DeleteDirectory(directory.c_str());
+    ASSERT_TRUE(ra::filesystem::CreateDirectory(directory.c_str()));
+
+    static const size_t NUM_FILES = 200;
+    const std::string data(512, 'a');
+
+    double start = ra::timing::GetMicrosecondsTimer();
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      ASSERT_TRUE(ra::filesystem::AtomicWriteFile(directory + separator + "atomic" + ra::strings::ToString(i) + ".dat", data));
+    }
+    double atomic_time = ra::timing::GetMicrosecondsTimer() - start;
+
+    start = ra::timing::GetMicrosecondsTimer();
+    DurableWriteBatch batch;
+    for (size_t i = 0; i < NUM_FILES; i++) {
+      ASSERT_TRUE(batch.Add(directory + separator + "batch" + ra::strings::ToString(i) + ".dat", data));
+    }
+    ASSERT_TRUE(batch.Commit());
+    double batch_time = ra::timing::GetMicrosecondsTimer() - start;
+
+    printf("Wrote %u files. AtomicWriteFile(): %.3f seconds, DurableWriteBatch: %.3f seconds.\n", (unsigned int)NUM_FILES, atomic_time, batch_time);
+
+    //cleanup
+    ASSERT_TRUE(ra::filesystem::DeleteDirectory(directory.c_str()));
+  }
+  //--------------------------------------------------------------------------------------------------
   TEST_F(TestFilesystem, testFileReplace) {
     //create a test file
     static const std::string sentence = "The quick brown fox jumps over the lazy dog.";
@@ -2337,6 +3296,117 @@ namespace ra { namespace filesystem { namespace test
     ra::filesystem::DeleteFile(file_path.c_str());
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestFilesystem, testFileReplaceLargeFile) {
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".txt";
+    static const size_t CHUNK_SIZE = 1024 * 1024; //chunk size of FileReplace()
+
+    //build a content with occurrences at the beginning, at the end and across chunk boundaries
+    const std::string pattern = "needle";
+    std::string content(3 * CHUNK_SIZE + 10, '.');
+    const size_t offsets[] = { 0, 100, CHUNK_SIZE - 3, 2 * CHUNK_SIZE - 1, 2 * CHUNK_SIZE + 6, content.size() - pattern.size() };
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+      content.replace(offsets[i], pattern.size(), pattern);
+    }
+
+    struct TEST_CASE {
+      const char * old_value;
+      const char * new_value;
+    };
+    static const TEST_CASE test_cases[] = {
+      {"needle", "pin"},
+      {"needle", "a much longer replacement value"},
+      {"needle", ""},
+      {"needle", "needle needle"},
+      {"e", "E"},
+      {"not found", "anything"},
+    };
+    for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+      const TEST_CASE & test_case = test_cases[i];
+      ASSERT_TRUE(ra::filesystem::WriteFile(file_path, content));
+
+      std::string expected = content;
+      ra::strings::Replace(expected, test_case.old_value, test_case.new_value);
+
+      ASSERT_TRUE(ra::filesystem::FileReplace(file_path, test_case.old_value, test_case.new_value));
+
+      std::string actual;
+      ASSERT_TRUE(ra::filesystem::ReadFile(file_path, actual));
+      ASSERT_EQ(expected.size(), actual.size()) << "old_value=" << test_case.old_value << " new_value=" << test_case.new_value;
+      ASSERT_TRUE(expected == actual) << "old_value=" << test_case.old_value << " new_value=" << test_case.new_value;
+    }
+
+#ifndef _WIN32
+    //the file is not rewritten if the value is not found
+    ra::filesystem::FileInfo before;
+    ra::filesystem::FileInfo after;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), before));
+    ASSERT_TRUE(ra::filesystem::FileReplace(file_path, "not found", "anything"));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), after));
+    ASSERT_EQ(before.inode, after.inode);
+
+    //permissions are preserved when the file is replaced
+    ASSERT_EQ(0, chmod(file_path.c_str(), 0640));
+    ASSERT_TRUE(ra::filesystem::FileReplace(file_path, ".", "_"));
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), after));
+    ASSERT_EQ((uint32_t)0640, after.mode & 0777);
+#endif
+
+    //no temporary files are left behind
+    ra::strings::StringVector files;
+    ASSERT_TRUE(ra::filesystem::FindFiles(files, ra::filesystem::GetCurrentDirectory().c_str(), 0));
+    for (size_t i = 0; i < files.size(); i++) {
+      ASSERT_TRUE(files[i].find(file_path + ".") == std::string::npos) << files[i];
+    }
+
+    //test file not found
+    ASSERT_FALSE(ra::filesystem::FileReplace(file_path + ".notfound", "a", "b"));
+
+    //cleanup
+    ra::filesystem::DeleteFile(file_path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestFilesystem, testFileReplaceLinks) {
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".txt";
+    const std::string hardlink_path = ra::testing::GetTestQualifiedName() + ".hardlink.txt";
+    const std::string symlink_path = ra::testing::GetTestQualifiedName() + ".symlink.txt";
+    ra::filesystem::DeleteFile(hardlink_path.c_str());
+    ra::filesystem::DeleteFile(symlink_path.c_str());
+
+    ASSERT_TRUE(ra::filesystem::WriteFile(file_path, "the quick brown fox"));
+    ASSERT_EQ(0, link(file_path.c_str(), hardlink_path.c_str()));
+    ASSERT_EQ(0, symlink(file_path.c_str(), symlink_path.c_str()));
+
+    ra::filesystem::FileInfo before;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), before));
+
+    //replace through the symbolic link
+    ASSERT_TRUE(ra::filesystem::FileReplace(symlink_path, "quick", "slow"));
+
+    //assert the symbolic link is kept
+    struct stat symlink_stat;
+    ASSERT_EQ(0, lstat(symlink_path.c_str(), &symlink_stat));
+    ASSERT_TRUE(S_ISLNK(symlink_stat.st_mode));
+
+    //assert the hard links still share the same file
+    ra::filesystem::FileInfo after;
+    ASSERT_TRUE(ra::filesystem::GetFileInfo(file_path.c_str(), after));
+    ASSERT_EQ(before.inode, after.inode);
+    ASSERT_EQ(2, after.link_count);
+
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadFile(hardlink_path, content));
+    ASSERT_EQ("the slow brown fox", content);
+    ASSERT_TRUE(ra::filesystem::ReadFile(file_path, content));
+    ASSERT_EQ("the slow brown fox", content);
+
+    //cleanup
+    ra::filesystem::DeleteFile(symlink_path.c_str());
+    ra::filesystem::DeleteFile(hardlink_path.c_str());
+    ra::filesystem::DeleteFile(file_path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif
 } //namespace test
 } //namespace filesystem
 } //namespace ra
@@ -0,0 +1,136 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestJobRunner.h"
+#include "rapidassist/jobrunner.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+#ifndef _WIN32
+  class JobExitCounter : public IJobListener {
+  public:
+    JobExitCounter() : count(0) {}
+    virtual void OnJobExit(const Job & /*job*/, const JobResult & /*result*/) {
+      count++;
+    }
+    size_t count;
+  };
+#endif
+  //--------------------------------------------------------------------------------------------------
+  void TestJobRunner::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestJobRunner::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestJobRunner, testRun) {
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    JobExitCounter counter;
+    JobRunner runner;
+    runner.SetListener(&counter);
+    runner.SetMaxParallelism(4);
+    ASSERT_EQ(4, runner.GetMaxParallelism());
+
+    static const size_t NUM_JOBS = 20;
+    for (size_t i = 0; i < NUM_JOBS; i++) {
+      std::string command = std::string("exit ") + ra::strings::ToString(i);
+      ASSERT_EQ(i, runner.AddCommandLine(command, curr_dir));
+    }
+    ASSERT_EQ(NUM_JOBS, runner.GetJobCount());
+
+    //some jobs have a non-zero exit code
+    ASSERT_FALSE(runner.Run());
+    ASSERT_EQ(0, runner.GetJobCount());
+    ASSERT_EQ(NUM_JOBS, counter.count);
+
+    //assert results are in the order jobs were added
+    const JobResultList & results = runner.GetResults();
+    ASSERT_EQ(NUM_JOBS, results.size());
+    for (size_t i = 0; i < NUM_JOBS; i++) {
+      const JobResult & result = results[i];
+      ASSERT_EQ(i, result.index);
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, result.pid);
+      ASSERT_EQ((int)i, result.exit_code);
+      ASSERT_EQ(0, result.term_signal);
+      ASSERT_GE(result.runtime, 0.0);
+    }
+
+    //all jobs successful
+    runner.AddCommandLine("exit 0", curr_dir);
+    runner.AddCommandLine("true", curr_dir);
+    ASSERT_TRUE(runner.Run());
+    ASSERT_EQ(2, runner.GetResults().size());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestJobRunner, testMaxParallelism) {
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    //8 jobs of 0.5 seconds, 4 at a time, is expected to take 1 second
+    JobRunner runner;
+    runner.SetMaxParallelism(4);
+    static const size_t NUM_JOBS = 8;
+    for (size_t i = 0; i < NUM_JOBS; i++) {
+      runner.AddCommandLine("sleep 0.5", curr_dir);
+    }
+
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(runner.Run());
+    double time_end = ra::timing::GetMicrosecondsTimer();
+    double elapsed = time_end - time_start;
+    printf("Running %d jobs of 0.5 seconds with a parallelism of %d took %.3f seconds\n", (int)NUM_JOBS, (int)runner.GetMaxParallelism(), elapsed);
+
+    ASSERT_GE(elapsed, 0.95);
+    ASSERT_LT(elapsed, 1.9);
+
+    //a single job at a time
+    runner.SetMaxParallelism(0);
+    ASSERT_EQ(1, runner.GetMaxParallelism());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestJobRunner, testInvalidJob) {
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    JobExitCounter counter;
+    JobRunner runner;
+    runner.SetListener(&counter);
+    runner.Add("/this/executable/does/not/exist", curr_dir, ra::strings::StringVector());
+    runner.AddCommandLine("exit 0", curr_dir);
+    ASSERT_FALSE(runner.Run());
+    ASSERT_EQ(2, counter.count);
+
+    const JobResultList & results = runner.GetResults();
+    ASSERT_EQ(2, results.size());
+    ASSERT_EQ(ra::process::INVALID_PROCESS_ID, results[0].pid);
+    ASSERT_EQ(-1, results[0].exit_code);
+    ASSERT_EQ(0, results[1].exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //_WIN32
+} //namespace test
+} //namespace process
+} //namespace ra
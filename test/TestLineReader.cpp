@@ -0,0 +1,173 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestLineReader.h"
+#include "rapidassist/linereader.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace filesystem { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestLineReader::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestLineReader::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  ra::strings::StringVector ReadAllLines(const std::string & path, bool trim_newline_characters, size_t buffer_size) {
+    ra::strings::StringVector lines;
+    LineReader reader;
+    if (!reader.Open(path, trim_newline_characters, buffer_size))
+      return lines;
+    std::string line;
+    while (reader.Next(line)) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestLineReader, testOpen) {
+    LineReader reader;
+    ASSERT_FALSE(reader.IsOpen());
+    ASSERT_FALSE(reader.Open("this file is not found"));
+    ASSERT_FALSE(reader.IsOpen());
+
+    const char * data = NULL;
+    size_t size = 0;
+    ASSERT_FALSE(reader.Next(data, size));
+
+    //test empty file
+    std::string path = ra::testing::GetTestQualifiedName() + ".txt";
+    ASSERT_TRUE(ra::filesystem::WriteFile(path, ""));
+    ASSERT_TRUE(reader.Open(path));
+    ASSERT_TRUE(reader.IsOpen());
+    ASSERT_FALSE(reader.Next(data, size));
+    ASSERT_FALSE(reader.HasError());
+    ASSERT_EQ(0, reader.GetLineCount());
+
+    reader.Close();
+    ASSERT_FALSE(reader.IsOpen());
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestLineReader, testNext) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".txt";
+    ASSERT_TRUE(ra::filesystem::WriteFile(path, "first\nsecond\r\n\nlast"));
+
+    //test with different buffer sizes to split lines between blocks
+    static const size_t buffer_sizes[] = { 1, 2, 3, 5, 64, LineReader::DEFAULT_BUFFER_SIZE };
+    for (size_t i = 0; i < sizeof(buffer_sizes) / sizeof(buffer_sizes[0]); i++) {
+      ra::strings::StringVector lines = ReadAllLines(path, true, buffer_sizes[i]);
+      ASSERT_EQ(4, lines.size()) << "buffer_size=" << buffer_sizes[i];
+      ASSERT_EQ("first", lines[0]);
+      ASSERT_EQ("second", lines[1]);
+      ASSERT_EQ("", lines[2]);
+      ASSERT_EQ("last", lines[3]);
+
+      lines = ReadAllLines(path, false, buffer_sizes[i]);
+      ASSERT_EQ(4, lines.size()) << "buffer_size=" << buffer_sizes[i];
+      ASSERT_EQ("first\n", lines[0]);
+      ASSERT_EQ("second\r\n", lines[1]);
+      ASSERT_EQ("\n", lines[2]);
+      ASSERT_EQ("last", lines[3]);
+    }
+
+    //test line count
+    LineReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    const char * data = NULL;
+    size_t size = 0;
+    while (reader.Next(data, size)) {
+    }
+    ASSERT_EQ(4, reader.GetLineCount());
+    ASSERT_FALSE(reader.HasError());
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestLineReader, testLongLines) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".txt";
+
+    //lines longer than the buffer and longer than the previous 10 KB limit of ReadTextFile()
+    const std::string long_line(1024 * 1024, 'a');
+    const std::string content = "short\n" + long_line + "\nshort\n" + long_line;
+    ASSERT_TRUE(ra::filesystem::WriteFile(path, content));
+
+    ra::strings::StringVector lines = ReadAllLines(path, true, 1000);
+    ASSERT_EQ(4, lines.size());
+    ASSERT_EQ("short", lines[0]);
+    ASSERT_EQ(long_line, lines[1]);
+    ASSERT_EQ("short", lines[2]);
+    ASSERT_EQ(long_line, lines[3]);
+
+    //ReadTextFile() does not split long lines
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(path, lines, true));
+    ASSERT_EQ(4, lines.size());
+    ASSERT_EQ(long_line, lines[1]);
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestLineReader, testBenchmark) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".txt";
+
+    //create a 50 MB log file
+    {
+      FILE * f = fopen(path.c_str(), "wb");
+      ASSERT_TRUE(f != NULL);
+      const std::string line = "2020-01-01 00:00:00 INFO This is a typical line of a log file with some content.\n";
+      for (size_t i = 0; i < 50 * 1024 * 1024 / line.size(); i++) {
+        fwrite(line.c_str(), 1, line.size(), f);
+      }
+      fclose(f);
+    }
+
+    double start = ra::timing::GetMicrosecondsTimer();
+    ra::strings::StringVector lines;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(path, lines, true));
+    double read_text_file_time = ra::timing::GetMicrosecondsTimer() - start;
+
+    start = ra::timing::GetMicrosecondsTimer();
+    LineReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    const char * data = NULL;
+    size_t size = 0;
+    uint64_t total_size = 0;
+    while (reader.Next(data, size)) {
+      total_size += size;
+    }
+    double line_reader_time = ra::timing::GetMicrosecondsTimer() - start;
+    ASSERT_EQ(lines.size(), reader.GetLineCount());
+
+    printf("Read %u lines. ReadTextFile(): %.3f seconds, LineReader: %.3f seconds.\n", (unsigned int)lines.size(), read_text_file_time, line_reader_time);
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace filesystem
+} //namespace ra
@@ -0,0 +1,145 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestMappedFile.h"
+#include "rapidassist/mappedfile.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/testing.h"
+
+#include <string.h> //for memcmp()
+
+namespace ra { namespace filesystem { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestMappedFile::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestMappedFile::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMappedFile, testOpen) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".bin";
+    ASSERT_TRUE(ra::testing::CreateFile(path.c_str(), 100000));
+
+    std::string expected;
+    ASSERT_TRUE(ra::filesystem::ReadFile(path, expected));
+
+    MappedFile file;
+    ASSERT_FALSE(file.IsOpen());
+    ASSERT_EQ(NULL, file.GetData());
+    ASSERT_EQ(0, file.GetSize());
+
+    static const MappedFile::AccessPattern patterns[] = { MappedFile::ACCESS_NORMAL, MappedFile::ACCESS_SEQUENTIAL, MappedFile::ACCESS_RANDOM };
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+      ASSERT_TRUE(file.Open(path, patterns[i]));
+      ASSERT_TRUE(file.IsOpen());
+      ASSERT_EQ(expected.size(), file.GetSize());
+      ASSERT_TRUE(file.GetData() != NULL);
+      ASSERT_EQ(0, memcmp(expected.data(), file.GetData(), expected.size()));
+    }
+
+    file.Close();
+    ASSERT_FALSE(file.IsOpen());
+    ASSERT_EQ(NULL, file.GetData());
+    ASSERT_EQ(0, file.GetSize());
+
+#ifndef _WIN32
+    //the mapping stays valid after the file is deleted
+    {
+      MappedFile other;
+      ASSERT_TRUE(other.Open(path));
+      ASSERT_TRUE(ra::filesystem::DeleteFile(path.c_str()));
+      ASSERT_EQ(0, memcmp(expected.data(), other.GetData(), expected.size()));
+    }
+#endif
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMappedFile, testOpenInvalid) {
+    MappedFile file;
+    ASSERT_FALSE(file.Open("/this/file/does/not/exist"));
+    ASSERT_FALSE(file.IsOpen());
+
+    //directories cannot be mapped
+    ASSERT_FALSE(file.Open(ra::filesystem::GetCurrentDirectory()));
+    ASSERT_FALSE(file.IsOpen());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMappedFile, testEmptyFile) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".bin";
+    ASSERT_TRUE(ra::filesystem::WriteFile(path, ""));
+
+    MappedFile file;
+    ASSERT_TRUE(file.Open(path));
+    ASSERT_TRUE(file.IsOpen());
+    ASSERT_EQ(0, file.GetSize());
+    ASSERT_EQ(NULL, file.GetData());
+    ASSERT_FALSE(file.WillNeed(0, 10));
+    file.Close();
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMappedFile, testWillNeed) {
+    std::string path = ra::testing::GetTestQualifiedName() + ".bin";
+    ASSERT_TRUE(ra::testing::CreateFile(path.c_str(), 100000));
+
+    MappedFile file;
+    ASSERT_FALSE(file.WillNeed(0, 10)); //not opened
+    ASSERT_TRUE(file.Open(path, MappedFile::ACCESS_RANDOM));
+    ASSERT_TRUE(file.WillNeed(0, 100000));
+    ASSERT_TRUE(file.WillNeed(5000, 10)); //unaligned offset
+    ASSERT_TRUE(file.WillNeed(99990, 1000)); //length larger than the file
+    ASSERT_FALSE(file.WillNeed(100000, 10)); //offset out of range
+    file.Close();
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestMappedFile, testLargeFile) {
+    if (sizeof(size_t) < sizeof(uint64_t))
+      return; //a 32-bit address space cannot map the file
+
+    //create a sparse file larger than 4 GB
+    static const uint64_t FILE_SIZE = 5ULL * 1024 * 1024 * 1024 + 7;
+    std::string path = ra::testing::GetTestQualifiedName() + ".bin";
+    ASSERT_TRUE(ra::testing::CreateFileSparse(path.c_str(), FILE_SIZE));
+
+    MappedFile file;
+    ASSERT_TRUE(file.Open(path, MappedFile::ACCESS_RANDOM));
+    ASSERT_EQ(FILE_SIZE, file.GetSize());
+
+    //read at the end of the file
+    const uint8_t * data = file.GetData();
+    ASSERT_EQ(0, data[FILE_SIZE - 1]);
+    ASSERT_EQ(0, data[FILE_SIZE / 2]);
+    file.Close();
+
+    ra::filesystem::DeleteFile(path.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace filesystem
+} //namespace ra
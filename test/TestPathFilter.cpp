@@ -0,0 +1,300 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPathFilter.h"
+#include "rapidassist/pathfilter.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/strings.h"
+
+#include <algorithm> //for std::sort()
+
+namespace ra { namespace filesystem { namespace test
+{
+  bool CreateSourceDirectory(const std::string & base_path) {
+    // base_path
+    // |-README.md
+    // |-src
+    // | |-main.cpp
+    // | |-debug.log
+    // |-build
+    // | |-main.o
+    // | |-logs
+    // |   |-build.log
+    // |-logs
+    //   |-1.log
+    //   |-keep.log
+
+    ra::strings::StringVector directories;
+    directories.push_back(base_path + "/src");
+    directories.push_back(base_path + "/build/logs");
+    directories.push_back(base_path + "/logs");
+    for (size_t i = 0; i < directories.size(); i++) {
+      std::string & directory = directories[i];
+      filesystem::NormalizePath(directory);
+      if (!filesystem::CreateDirectory(directory.c_str()))
+        return false;
+    }
+
+    ra::strings::StringVector files;
+    files.push_back(base_path + "/README.md");
+    files.push_back(base_path + "/src/main.cpp");
+    files.push_back(base_path + "/src/debug.log");
+    files.push_back(base_path + "/build/main.o");
+    files.push_back(base_path + "/build/logs/build.log");
+    files.push_back(base_path + "/logs/1.log");
+    files.push_back(base_path + "/logs/keep.log");
+    for (size_t i = 0; i < files.size(); i++) {
+      std::string & file = files[i];
+      filesystem::NormalizePath(file);
+      if (!ra::testing::CreateFile(file.c_str()))
+        return false;
+    }
+
+    return true;
+  }
+
+  //returns the sorted relative paths of the given files using '/' as separator
+  ra::strings::StringVector GetRelativePaths(const std::string & base_path, const ra::strings::StringVector & files) {
+    ra::strings::StringVector paths;
+    for (size_t i = 0; i < files.size(); i++) {
+      std::string path = files[i].substr(base_path.size() + 1);
+      ra::strings::Replace(path, "\\", "/");
+      paths.push_back(path);
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPathFilter::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPathFilter::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathFilter, testCompile) {
+    GlobPattern glob;
+    ASSERT_FALSE(glob.Compile(""));
+    ASSERT_FALSE(glob.Compile("   "));
+    ASSERT_FALSE(glob.Compile("# comment"));
+    ASSERT_FALSE(glob.Compile("/"));
+
+    ASSERT_TRUE(glob.Compile("*.log"));
+    ASSERT_FALSE(glob.IsNegated());
+    ASSERT_FALSE(glob.IsDirectoryOnly());
+    ASSERT_EQ("*.log", glob.GetPattern());
+
+    ASSERT_TRUE(glob.Compile("!build/"));
+    ASSERT_TRUE(glob.IsNegated());
+    ASSERT_TRUE(glob.IsDirectoryOnly());
+
+    //escaped special characters
+    ASSERT_TRUE(glob.Compile("\\#file"));
+    ASSERT_FALSE(glob.IsNegated());
+    ASSERT_TRUE(glob.Match("#file", false));
+    ASSERT_TRUE(glob.Compile("\\!file"));
+    ASSERT_FALSE(glob.IsNegated());
+    ASSERT_TRUE(glob.Match("!file", false));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathFilter, testMatchWildcards) {
+    GlobPattern glob;
+
+    ASSERT_TRUE(glob.Compile("*.log"));
+    ASSERT_TRUE(glob.Match("a.log", false));
+    ASSERT_TRUE(glob.Match(".log", false));
+    ASSERT_TRUE(glob.Match("dir/sub/a.log", false));
+    ASSERT_FALSE(glob.Match("a.log.txt", false));
+    ASSERT_FALSE(glob.Match("a.txt", false));
+
+    ASSERT_TRUE(glob.Compile("file?.txt"));
+    ASSERT_TRUE(glob.Match("file1.txt", false));
+    ASSERT_FALSE(glob.Match("file.txt", false));
+    ASSERT_FALSE(glob.Match("file12.txt", false));
+
+    ASSERT_TRUE(glob.Compile("file[0-9a].txt"));
+    ASSERT_TRUE(glob.Match("file5.txt", false));
+    ASSERT_TRUE(glob.Match("filea.txt", false));
+    ASSERT_FALSE(glob.Match("fileb.txt", false));
+
+    ASSERT_TRUE(glob.Compile("file[!0-9].txt"));
+    ASSERT_FALSE(glob.Match("file5.txt", false));
+    ASSERT_TRUE(glob.Match("fileb.txt", false));
+
+    //unterminated class is a literal
+    ASSERT_TRUE(glob.Compile("file[0"));
+    ASSERT_TRUE(glob.Match("file[0", false));
+
+    ASSERT_TRUE(glob.Compile("a*b*c"));
+    ASSERT_TRUE(glob.Match("abc", false));
+    ASSERT_TRUE(glob.Match("aXbYbZc", false));
+    ASSERT_FALSE(glob.Match("aXbYcZ", false));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathFilter, testMatchDirectories) {
+    GlobPattern glob;
+
+    //directory only
+    ASSERT_TRUE(glob.Compile("build/"));
+    ASSERT_TRUE(glob.Match("build", true));
+    ASSERT_TRUE(glob.Match("src/build", true));
+    ASSERT_FALSE(glob.Match("build", false));
+
+    //anchored patterns
+    ASSERT_TRUE(glob.Compile("/build"));
+    ASSERT_TRUE(glob.Match("build", true));
+    ASSERT_FALSE(glob.Match("src/build", true));
+
+    ASSERT_TRUE(glob.Compile("doc/*.md"));
+    ASSERT_TRUE(glob.Match("doc/README.md", false));
+    ASSERT_FALSE(glob.Match("doc/api/README.md", false));
+    ASSERT_FALSE(glob.Match("src/doc/README.md", false));
+
+    //leading **
+    ASSERT_TRUE(glob.Compile("**/*.log"));
+    ASSERT_TRUE(glob.Match("a.log", false));
+    ASSERT_TRUE(glob.Match("x/y/z/a.log", false));
+
+    //middle **
+    ASSERT_TRUE(glob.Compile("a/**/b"));
+    ASSERT_TRUE(glob.Match("a/b", false));
+    ASSERT_TRUE(glob.Match("a/x/b", false));
+    ASSERT_TRUE(glob.Match("a/x/y/b", false));
+    ASSERT_FALSE(glob.Match("a/x/y/c", false));
+
+    //trailing **
+    ASSERT_TRUE(glob.Compile("logs/**"));
+    ASSERT_TRUE(glob.Match("logs/1.log", false));
+    ASSERT_TRUE(glob.Match("logs/a/b", false));
+    ASSERT_FALSE(glob.Match("logs", true));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathFilter, testIsExcluded) {
+    PathFilter filter;
+    ASSERT_FALSE(filter.IsExcluded("build/main.o", false));
+
+    ASSERT_TRUE(filter.AddExcludePattern("*.log"));
+    ASSERT_TRUE(filter.AddExcludePattern("!keep.log"));
+    ASSERT_TRUE(filter.AddExcludePattern("build/"));
+    ASSERT_FALSE(filter.AddExcludePattern("# comment"));
+    ASSERT_EQ(3, filter.GetExcludeCount());
+
+    ASSERT_TRUE(filter.IsExcluded("debug.log", false));
+    ASSERT_FALSE(filter.IsExcluded("keep.log", false));
+    ASSERT_FALSE(filter.IsExcluded("logs/keep.log", false));
+    ASSERT_TRUE(filter.IsExcluded("build", true));
+    ASSERT_FALSE(filter.IsExcluded("build", false));
+    ASSERT_FALSE(filter.IsExcluded("src/main.cpp", false));
+
+    //parent directories are excluded
+    ASSERT_TRUE(filter.IsExcluded("build/main.o", false));
+    ASSERT_TRUE(filter.IsExcluded("build/logs/keep.log", false));
+
+    filter.Clear();
+    ASSERT_EQ(0, filter.GetExcludeCount());
+    ASSERT_FALSE(filter.IsExcluded("debug.log", false));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathFilter, testFindFiles) {
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateSourceDirectory(basePath));
+
+    //without patterns
+    {
+      PathFilter filter;
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(filesystem::FindFiles(expected, basePath.c_str(), -1));
+      ra::strings::StringVector files;
+      ASSERT_TRUE(filesystem::FindFiles(files, basePath.c_str(), -1, filter));
+      ASSERT_EQ(expected, files);
+    }
+
+    //include pattern
+    {
+      PathFilter filter;
+      ASSERT_TRUE(filter.AddIncludePattern("**/*.log"));
+      ra::strings::StringVector files;
+      ASSERT_TRUE(filesystem::FindFiles(files, basePath.c_str(), -1, filter));
+      ra::strings::StringVector paths = GetRelativePaths(basePath, files);
+      ASSERT_EQ(4, paths.size());
+      ASSERT_EQ("build/logs/build.log", paths[0]);
+      ASSERT_EQ("logs/1.log", paths[1]);
+      ASSERT_EQ("logs/keep.log", paths[2]);
+      ASSERT_EQ("src/debug.log", paths[3]);
+    }
+
+    //include and exclude patterns
+    {
+      PathFilter filter;
+      ASSERT_TRUE(filter.AddIncludePattern("**/*.log"));
+      ASSERT_TRUE(filter.AddExcludePattern("build/"));
+      ASSERT_TRUE(filter.AddExcludePattern("logs/*.log"));
+      ASSERT_TRUE(filter.AddExcludePattern("!logs/keep.log"));
+      ra::strings::StringVector files;
+      ASSERT_TRUE(filesystem::FindFiles(files, basePath.c_str(), -1, filter));
+      ra::strings::StringVector paths = GetRelativePaths(basePath, files);
+      ASSERT_EQ(2, paths.size());
+      ASSERT_EQ("logs/keep.log", paths[0]);
+      ASSERT_EQ("src/debug.log", paths[1]);
+    }
+
+    //ignore file
+    {
+      std::string ignore_path = basePath + ".gitignore";
+      ASSERT_TRUE(ra::filesystem::WriteFile(ignore_path, "# build outputs\nbuild/\n\n*.log\n!keep.log\n"));
+
+      PathFilter filter;
+      ASSERT_FALSE(filter.LoadIgnoreFile(basePath + ".missing"));
+      ASSERT_TRUE(filter.LoadIgnoreFile(ignore_path));
+      ASSERT_EQ(3, filter.GetExcludeCount());
+
+      ra::strings::StringVector files;
+      ASSERT_TRUE(filesystem::FindFiles(files, basePath.c_str(), -1, filter));
+      ra::strings::StringVector paths = GetRelativePaths(basePath, files);
+      ASSERT_EQ(5, paths.size());
+      ASSERT_EQ("README.md", paths[0]);
+      ASSERT_EQ("logs", paths[1]);
+      ASSERT_EQ("logs/keep.log", paths[2]);
+      ASSERT_EQ("src", paths[3]);
+      ASSERT_EQ("src/main.cpp", paths[4]);
+
+      ra::filesystem::DeleteFile(ignore_path.c_str());
+    }
+
+    //missing directory
+    {
+      PathFilter filter;
+      ra::strings::StringVector files;
+      ASSERT_FALSE(filesystem::FindFiles(files, NULL, -1, filter));
+      ASSERT_FALSE(filesystem::FindFiles(files, "/this/directory/does/not/exist", -1, filter));
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace filesystem
+} //namespace ra
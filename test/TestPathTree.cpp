@@ -0,0 +1,212 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestPathTree.h"
+#include "rapidassist/pathtree.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/strings.h"
+
+#include <algorithm> //for std::sort()
+
+namespace ra { namespace filesystem { namespace test
+{
+  //declared in TestFilesystem.cpp
+  extern bool CreateCarsDirectory(const std::string & base_path);
+  extern bool CreateDirectoryTree(const std::string & path, int depth, int num_directories, int num_files);
+
+  //--------------------------------------------------------------------------------------------------
+  void TestPathTree::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestPathTree::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTree, testAdd) {
+    PathTree tree;
+    ASSERT_EQ(0, tree.GetCount());
+
+    size_t foo = tree.Add(PathTree::INVALID_INDEX, "foo", ENTRY_DIRECTORY);
+    size_t bar = tree.Add(foo, "bar", ENTRY_DIRECTORY);
+    size_t baz = tree.Add(bar, "baz.txt", ENTRY_FILE);
+    size_t readme = tree.Add(PathTree::INVALID_INDEX, "readme.md", ENTRY_FILE);
+    ASSERT_EQ(0, foo);
+    ASSERT_EQ(1, bar);
+    ASSERT_EQ(2, baz);
+    ASSERT_EQ(3, readme);
+    ASSERT_EQ(4, tree.GetCount());
+
+    //invalid parent
+    ASSERT_EQ(PathTree::INVALID_INDEX, tree.Add(99, "invalid", ENTRY_FILE));
+    ASSERT_EQ(PathTree::INVALID_INDEX, tree.Add(0, NULL, ENTRY_FILE));
+    ASSERT_EQ(4, tree.GetCount());
+
+    ASSERT_EQ(PathTree::INVALID_INDEX, tree.GetParent(foo));
+    ASSERT_EQ(foo, tree.GetParent(bar));
+    ASSERT_EQ(bar, tree.GetParent(baz));
+    ASSERT_EQ(PathTree::INVALID_INDEX, tree.GetParent(99));
+
+    ASSERT_STREQ("foo", tree.GetName(foo));
+    ASSERT_STREQ("baz.txt", tree.GetName(baz));
+    ASSERT_EQ(NULL, tree.GetName(99));
+
+    ASSERT_EQ(ENTRY_DIRECTORY, tree.GetType(bar));
+    ASSERT_EQ(ENTRY_FILE, tree.GetType(baz));
+
+    ASSERT_EQ(0, tree.GetDepth(foo));
+    ASSERT_EQ(1, tree.GetDepth(bar));
+    ASSERT_EQ(2, tree.GetDepth(baz));
+    ASSERT_EQ(0, tree.GetDepth(readme));
+
+    //relative paths
+    const std::string separator = GetPathSeparatorStr();
+    ASSERT_EQ("foo", tree.GetPath(foo));
+    ASSERT_EQ("foo" + separator + "bar" + separator + "baz.txt", tree.GetPath(baz));
+
+    //absolute paths
+    tree.SetRootPath(separator + "home" + separator);
+    ASSERT_EQ(separator + "home", tree.GetRootPath());
+    ASSERT_EQ(separator + "home" + separator + "foo" + separator + "bar", tree.GetPath(bar));
+
+    //root of the file system
+    tree.SetRootPath(separator);
+    ASSERT_EQ(separator + "readme.md", tree.GetPath(readme));
+
+    tree.Clear();
+    ASSERT_EQ(0, tree.GetCount());
+    ASSERT_EQ("", tree.GetRootPath());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTree, testGetDepthDeepTree) {
+    PathTree tree;
+    size_t parent = PathTree::INVALID_INDEX;
+    for (int i = 0; i < 300; i++) {
+      parent = tree.Add(parent, "d", ENTRY_DIRECTORY);
+      ASSERT_EQ(i, tree.GetDepth(parent));
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTree, testGetSortedIndices) {
+    PathTree tree;
+    std::vector<size_t> indices;
+    tree.GetSortedIndices(indices);
+    ASSERT_EQ(0, indices.size());
+
+    size_t b = tree.Add(PathTree::INVALID_INDEX, "b", ENTRY_DIRECTORY);
+    size_t a_txt = tree.Add(PathTree::INVALID_INDEX, "a.txt", ENTRY_FILE);
+    size_t b_z = tree.Add(b, "z", ENTRY_FILE);
+    size_t a = tree.Add(PathTree::INVALID_INDEX, "a", ENTRY_DIRECTORY);
+    size_t a_c = tree.Add(a, "c", ENTRY_DIRECTORY);
+    size_t b_y = tree.Add(b, "y", ENTRY_FILE);
+    size_t a_c_x = tree.Add(a_c, "x", ENTRY_FILE);
+
+    //each directory is followed by its content, siblings are sorted by name
+    tree.GetSortedIndices(indices);
+    ASSERT_EQ(7, indices.size());
+    ASSERT_EQ(a, indices[0]);
+    ASSERT_EQ(a_c, indices[1]);
+    ASSERT_EQ(a_c_x, indices[2]);
+    ASSERT_EQ(a_txt, indices[3]);
+    ASSERT_EQ(b, indices[4]);
+    ASSERT_EQ(b_y, indices[5]);
+    ASSERT_EQ(b_z, indices[6]);
+
+    //in reverse order, the content of each directory is found before the directory
+    for (size_t i = 0; i < indices.size(); i++) {
+      size_t parent = tree.GetParent(indices[i]);
+      if (parent != PathTree::INVALID_INDEX) {
+        std::vector<size_t>::iterator it = std::find(indices.begin(), indices.end(), parent);
+        ASSERT_LT((size_t)(it - indices.begin()), i);
+      }
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTree, testFindFiles) {
+    PathTree tree;
+    ASSERT_FALSE(tree.FindFiles(NULL));
+    ASSERT_FALSE(tree.FindFiles("/this/directory/does/not/exist"));
+
+    //create cars directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    ASSERT_TRUE(CreateCarsDirectory(basePath));
+
+    //assert the same files are found in the same order as FindFiles()
+    for (int depth = -1; depth <= 2; depth++) {
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(ra::filesystem::FindFiles(expected, basePath.c_str(), depth));
+
+      ASSERT_TRUE(tree.FindFiles(basePath.c_str(), depth));
+      ra::strings::StringVector files;
+      tree.GetPaths(files);
+      ASSERT_EQ(expected, files) << "depth=" << depth;
+    }
+
+    //assert sorted order matches sorted full paths for this tree
+    {
+      ra::strings::StringVector expected;
+      ASSERT_TRUE(ra::filesystem::FindFiles(expected, basePath.c_str()));
+      std::sort(expected.begin(), expected.end());
+
+      ASSERT_TRUE(tree.FindFiles(basePath.c_str()));
+      std::vector<size_t> indices;
+      tree.GetSortedIndices(indices);
+      ra::strings::StringVector files;
+      for (size_t i = 0; i < indices.size(); i++) {
+        files.push_back(tree.GetPath(indices[i]));
+      }
+      ASSERT_EQ(expected, files);
+    }
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestPathTree, testMemoryUsage) {
+    //create a large directory tree
+    std::string basePath = ra::testing::GetTestQualifiedName() + "." + ra::strings::ToString(__LINE__);
+    basePath = ra::filesystem::GetPathBasedOnCurrentDirectory(basePath);
+    ASSERT_TRUE(CreateDirectoryTree(basePath, 3, 8, 4));
+
+    ra::strings::StringVector files;
+    ASSERT_TRUE(ra::filesystem::FindFiles(files, basePath.c_str()));
+    size_t vector_usage = files.capacity() * sizeof(std::string);
+    for (size_t i = 0; i < files.size(); i++) {
+      vector_usage += files[i].capacity() + 1;
+    }
+
+    PathTree tree;
+    ASSERT_TRUE(tree.FindFiles(basePath.c_str()));
+    ASSERT_EQ(files.size(), tree.GetCount());
+    size_t tree_usage = tree.GetMemoryUsage();
+
+    printf("Listing %d files uses %d bytes with a StringVector and %d bytes with a PathTree (%.1fx smaller)\n", (int)files.size(), (int)vector_usage, (int)tree_usage, (double)vector_usage / (double)tree_usage);
+    ASSERT_LT(tree_usage * 3, vector_usage);
+
+    //cleanup
+    ra::filesystem::DeleteDirectory(basePath.c_str());
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace filesystem
+} //namespace ra
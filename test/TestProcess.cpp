@@ -34,6 +34,7 @@
 #include <stdlib.h> //for system()
 #if defined(__linux__) || defined(__APPLE__)
 #include <sys/wait.h> //for WEXITSTATUS
+#include <sys/resource.h> //for RLIMIT_NOFILE
 #endif
 
 namespace ra { namespace process { namespace test
@@ -689,6 +690,371 @@ namespace ra { namespace process { namespace test
     ra::filesystem::DeleteFile(new_process_path.c_str());
   }
   //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testWaitExitLatency) {
+    //define a process that exits immediately with a specific error code
+#ifdef _WIN32
+    const int expected_error_code = 123;
+    const std::string exec_path = ra::environment::GetEnvironmentVariable("ComSpec");
+    const std::string arguments = "/c exit " + ra::strings::ToString(expected_error_code);
+#elif defined(__linux__) || defined(__APPLE__)
+    const int expected_error_code = 123;
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back(std::string("exit ") + ra::strings::ToString(expected_error_code));
+    const std::string exec_path = "/bin/sh";
+#endif
+
+    //assert that given process exists
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+
+    static const int NUM_PROCESSES = 10;
+    double time_start = ra::timing::GetMillisecondsTimer();
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      //start the process
+      const std::string curr_dir = ra::process::GetCurrentProcessDir();
+      ra::process::processid_t pid = ra::process::StartProcess(exec_path, curr_dir, arguments);
+      ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+
+      //wait for the program to exit
+      bool success = ra::process::WaitExit(pid);
+      ASSERT_TRUE(success);
+
+      //assert the exit code was not consumed by WaitExit()
+      int actual_exit_code = 0;
+      success = ra::process::GetExitCode(pid, actual_exit_code);
+      ASSERT_TRUE(success);
+      ASSERT_EQ(expected_error_code, actual_exit_code);
+    }
+    double time_end = ra::timing::GetMillisecondsTimer();
+    double elapsed_seconds = time_end - time_start;
+    printf("Waiting for %d short-lived processes took %.3f seconds\n", NUM_PROCESSES, elapsed_seconds);
+
+    //assert WaitExit() does not add a polling delay for each process
+    ASSERT_LT(elapsed_seconds, 5.0);
+  }
+  //--------------------------------------------------------------------------------------------------
+#if defined(__linux__) || defined(__APPLE__)
+  TEST_F(TestProcess, testStartProcessManyArguments) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+
+    //define more arguments than the previous limit of 10240 arguments
+    static const size_t NUM_ARGUMENTS = 20000;
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back(std::string("test $# -eq ") + ra::strings::ToString(NUM_ARGUMENTS));
+    arguments.push_back("sh"); //value of $0
+    for (size_t i = 0; i < NUM_ARGUMENTS; i++) {
+      arguments.push_back("a");
+    }
+
+    //run the process from a directory that is not the current directory
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    const std::string temp_dir = ra::filesystem::GetTemporaryDirectory();
+    ra::process::processid_t pid = ra::process::StartProcess(exec_path, temp_dir, arguments);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+
+    //assert the current directory of the current process was not modified
+    ASSERT_EQ(curr_dir, ra::filesystem::GetCurrentDirectory());
+
+    //assert all arguments were received by the process
+    int exit_code = -1;
+    ASSERT_TRUE(ra::process::WaitExit(pid, exit_code));
+    ASSERT_EQ(0, exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+  class ByteCountOutputHandler : public IOutputHandler {
+  public:
+    ByteCountOutputHandler() : stdout_size(0), stderr_size(0), num_calls(0) {}
+    virtual void OnOutput(int stream_id, const char * /*buffer*/, size_t size) {
+      if (stream_id == STDOUT_FILENO)
+        stdout_size += size;
+      else if (stream_id == STDERR_FILENO)
+        stderr_size += size;
+      num_calls++;
+    }
+    size_t stdout_size;
+    size_t stderr_size;
+    size_t num_calls;
+  };
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testExecuteAndCapture) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back("echo hello; echo world 1>&2; pwd; exit 42");
+
+    const std::string temp_dir = ra::filesystem::GetTemporaryDirectory();
+    std::string std_out;
+    std::string std_err;
+    int exit_code = 0;
+    bool success = ra::process::ExecuteAndCapture(exec_path, temp_dir, arguments, std_out, std_err, exit_code);
+    ASSERT_TRUE(success);
+    ASSERT_EQ(42, exit_code);
+    ASSERT_EQ(std::string("hello\n") + temp_dir + "\n", std_out);
+    ASSERT_EQ(std::string("world\n"), std_err);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testExecuteAndCaptureLargeOutput) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+
+    //output more data than the capacity of a pipe on both streams
+    static const size_t OUTPUT_SIZE = 10 * 1024 * 1024;
+    const std::string output_size_str = ra::strings::ToString(OUTPUT_SIZE);
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back("head -c " + output_size_str + " /dev/zero; head -c " + output_size_str + " /dev/zero 1>&2");
+
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    ByteCountOutputHandler handler;
+    int exit_code = -1;
+    bool success = ra::process::ExecuteAndCapture(exec_path, curr_dir, arguments, &handler, exit_code);
+    ASSERT_TRUE(success);
+    ASSERT_EQ(0, exit_code);
+    ASSERT_EQ(OUTPUT_SIZE, handler.stdout_size);
+    ASSERT_EQ(OUTPUT_SIZE, handler.stderr_size);
+    ASSERT_GT(handler.num_calls, 2);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testExecuteAndCaptureInvalidExecutable) {
+    ra::strings::StringVector arguments;
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    std::string std_out;
+    std::string std_err;
+    int exit_code = 0;
+    bool success = ra::process::ExecuteAndCapture("/this/file/does/not/exist", curr_dir, arguments, std_out, std_err, exit_code);
+    ASSERT_FALSE(success);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testStartProcessInvalidExecutable) {
+    ra::strings::StringVector arguments;
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    ra::process::processid_t pid = ra::process::StartProcess("/this/file/does/not/exist", curr_dir, arguments);
+    ASSERT_EQ(pid, ra::process::INVALID_PROCESS_ID);
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+#if defined(__linux__) || defined(__APPLE__)
+  processid_t StartShellCommand(const std::string & command, bool new_process_group) {
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back(command);
+    SpawnOptions options;
+    options.new_process_group = new_process_group;
+    processid_t pid = ra::process::StartProcess("/bin/sh", ra::filesystem::GetCurrentDirectory(), arguments, options);
+    return pid;
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testWaitExitTimeout) {
+    processid_t pid = StartShellCommand("sleep 5", false);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+
+    //assert the function returns when the timeout expires
+    int exit_code = 0;
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_FALSE(ra::process::WaitExit(pid, exit_code, 100));
+    double elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+    ASSERT_GE(elapsed, 0.09);
+    ASSERT_LT(elapsed, 2.0);
+    ASSERT_TRUE(ra::process::IsRunning(pid));
+    ASSERT_FALSE(ra::process::WaitExit(pid, exit_code, 0));
+    ASSERT_TRUE(ra::process::Kill(pid));
+
+    //assert the exit code of a terminated process
+    pid = StartShellCommand("exit 3", false);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+    ASSERT_TRUE(ra::process::WaitExit(pid, exit_code, 5000));
+    ASSERT_EQ(3, exit_code);
+
+    //assert a process killed by a signal
+    pid = StartShellCommand("kill -9 $$", false);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+    ASSERT_TRUE(ra::process::WaitExit(pid, exit_code, -1));
+    ASSERT_EQ(-1, exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testWaitAny) {
+    ProcessIdList pids;
+    pids.push_back(StartShellCommand("sleep 5", false));
+    pids.push_back(StartShellCommand("sleep 0.2; exit 4", false));
+    pids.push_back(StartShellCommand("sleep 5", false));
+    for (size_t i = 0; i < pids.size(); i++) {
+      ASSERT_NE(pids[i], ra::process::INVALID_PROCESS_ID);
+    }
+
+    processid_t pid = ra::process::INVALID_PROCESS_ID;
+    int exit_code = 0;
+    ASSERT_FALSE(ra::process::WaitAny(pids, 0, pid, exit_code));
+
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::process::WaitAny(pids, 5000, pid, exit_code));
+    double elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+    ASSERT_LT(elapsed, 2.0);
+    ASSERT_EQ(pids[1], pid);
+    ASSERT_EQ(4, exit_code);
+
+    ASSERT_TRUE(ra::process::Kill(pids[0]));
+    ASSERT_TRUE(ra::process::Kill(pids[2]));
+
+    ASSERT_FALSE(ra::process::WaitAny(ProcessIdList(), 0, pid, exit_code));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testTerminateTimeout) {
+    //the process ignores the TERM signal
+    processid_t pid = StartShellCommand("trap '' TERM; sleep 30", false);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+    ra::timing::Millisleep(100);
+
+    //assert the process is killed after the timeout
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    ASSERT_TRUE(ra::process::Terminate(pid, 200));
+    double elapsed = ra::timing::GetMicrosecondsTimer() - time_start;
+    ASSERT_GE(elapsed, 0.19);
+    ASSERT_LT(elapsed, 5.0);
+    ASSERT_FALSE(ra::process::IsRunning(pid));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testTerminateGroup) {
+    const std::string pid_file = ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr() + ra::testing::GetTestQualifiedName() + ".txt";
+    ra::filesystem::DeleteFile(pid_file.c_str());
+
+    //the process starts a grandchild process that ignores the TERM signal
+    const std::string command = std::string("(trap '' TERM; exec sleep 30) & echo $! > ") + pid_file + "; wait";
+    processid_t pid = StartShellCommand(command, true);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+    ASSERT_EQ(pid, getpgid(pid));
+
+    //wait for the grandchild process id
+    std::string content;
+    for (int i = 0; i < 100 && content.empty(); i++) {
+      ra::timing::Millisleep(20);
+      ra::filesystem::ReadTextFile(pid_file, content);
+    }
+    ra::filesystem::DeleteFile(pid_file.c_str());
+    processid_t grandchild_pid = ra::process::INVALID_PROCESS_ID;
+    ASSERT_TRUE(ra::strings::Parse(ra::strings::TrimRight(content, '\n'), grandchild_pid));
+    ASSERT_TRUE(ra::process::IsRunning(grandchild_pid));
+    ASSERT_EQ(pid, getpgid(grandchild_pid));
+
+    //assert the whole group is terminated
+    ASSERT_TRUE(ra::process::TerminateGroup(pid, 500));
+    ASSERT_FALSE(ra::process::IsRunning(pid));
+    for (int i = 0; i < 100 && ra::process::IsRunning(grandchild_pid); i++) {
+      ra::timing::Millisleep(10);
+    }
+    ASSERT_FALSE(ra::process::IsRunning(grandchild_pid));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testTerminateGroupGraceful) {
+    //the whole group exits on the TERM signal
+    processid_t pid = StartShellCommand("sleep 30 & sleep 30 & wait", true);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+    ra::timing::Millisleep(100);
+
+    //assert the group is terminated without waiting for the timeout
+    double time_start = ra::timing::GetMillisecondsTimer();
+    ASSERT_TRUE(ra::process::TerminateGroup(pid, 5000));
+    double elapsed = ra::timing::GetMillisecondsTimer() - time_start;
+    ASSERT_LT(elapsed, 4.0);
+    ASSERT_FALSE(ra::process::IsRunning(pid));
+
+    //invalid process groups
+    ASSERT_FALSE(ra::process::TerminateGroup(ra::process::INVALID_PROCESS_ID, 100));
+    ASSERT_FALSE(ra::process::TerminateGroup(0, 100));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testKillGroup) {
+    const std::string pid_file = ra::filesystem::GetTemporaryDirectory() + ra::filesystem::GetPathSeparatorStr() + ra::testing::GetTestQualifiedName() + ".txt";
+    ra::filesystem::DeleteFile(pid_file.c_str());
+
+    const std::string command = std::string("sleep 30 & echo $! > ") + pid_file + "; wait";
+    processid_t pid = StartShellCommand(command, true);
+    ASSERT_NE(pid, ra::process::INVALID_PROCESS_ID);
+
+    std::string content;
+    for (int i = 0; i < 100 && content.empty(); i++) {
+      ra::timing::Millisleep(20);
+      ra::filesystem::ReadTextFile(pid_file, content);
+    }
+    ra::filesystem::DeleteFile(pid_file.c_str());
+    processid_t grandchild_pid = ra::process::INVALID_PROCESS_ID;
+    ASSERT_TRUE(ra::strings::Parse(ra::strings::TrimRight(content, '\n'), grandchild_pid));
+
+    ASSERT_TRUE(ra::process::KillGroup(pid));
+    ASSERT_FALSE(ra::process::IsRunning(pid));
+    for (int i = 0; i < 100 && ra::process::IsRunning(grandchild_pid); i++) {
+      ra::timing::Millisleep(10);
+    }
+    ASSERT_FALSE(ra::process::IsRunning(grandchild_pid));
+
+    //invalid process groups
+    ASSERT_FALSE(ra::process::KillGroup(ra::process::INVALID_PROCESS_ID));
+    ASSERT_FALSE(ra::process::KillGroup(0));
+  }
+  //--------------------------------------------------------------------------------------------------
+  int RunShellCommand(const std::string & command, const SpawnOptions & options) {
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back(command);
+    processid_t pid = ra::process::StartProcess("/bin/sh", ra::filesystem::GetCurrentDirectory(), arguments, options);
+    if (pid == ra::process::INVALID_PROCESS_ID)
+      return -1;
+    int exit_code = -1;
+    if (!ra::process::WaitExit(pid, exit_code, -1))
+      return -1;
+    return exit_code;
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcess, testStartProcessSpawnOptions) {
+    //nice
+    {
+      const int base_nice = RunShellCommand("exit $(nice)", SpawnOptions());
+      ASSERT_GE(base_nice, 0);
+      SpawnOptions options;
+      options.nice_increment = 5;
+      int expected = base_nice + 5;
+      if (expected > 19)
+        expected = 19;
+      ASSERT_EQ(expected, RunShellCommand("exit $(nice)", options));
+    }
+
+    //resource limits
+    {
+      SpawnOptions options;
+      ResourceLimit limit;
+      limit.resource = RLIMIT_NOFILE;
+      limit.soft_limit = 42;
+      limit.hard_limit = 42;
+      options.resource_limits.push_back(limit);
+      ASSERT_EQ(42, RunShellCommand("exit $(ulimit -n)", options));
+    }
+
+#ifdef __linux__
+    //io priority
+    {
+      SpawnOptions options;
+      options.io_priority_class = IO_PRIORITY_CLASS_IDLE;
+      options.io_priority_level = 0;
+      ASSERT_EQ(0, RunShellCommand("exit 0", options));
+    }
+
+    //cpu affinity
+    {
+      SpawnOptions options;
+      options.cpu_affinity.push_back(0);
+      ASSERT_EQ(1, RunShellCommand("exit $(nproc)", options));
+
+      //invalid cpu
+      options.cpu_affinity[0] = -1;
+      ASSERT_EQ(-1, RunShellCommand("exit 0", options));
+    }
+#endif
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
 } //namespace test
 } //namespace process
 } //namespace ra
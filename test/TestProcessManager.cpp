@@ -0,0 +1,200 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestProcessManager.h"
+#include "rapidassist/processmanager.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+#ifndef _WIN32
+  class ProcessExitCounter : public IProcessListener {
+  public:
+    ProcessExitCounter() : count(0) {}
+    virtual void OnProcessExit(const ProcessResult & /*result*/) {
+      count++;
+    }
+    size_t count;
+  };
+
+  ra::strings::StringVector GetExitCodeArguments(int exit_code) {
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back(std::string("exit ") + ra::strings::ToString(exit_code));
+    return arguments;
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessManager::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessManager::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestProcessManager, testWaitAll) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ProcessExitCounter counter;
+    ProcessManager manager;
+    manager.SetListener(&counter);
+
+    //launch many processes concurrently, each with a different exit code
+    static const int NUM_PROCESSES = 50;
+    std::vector<ProcessHandle> handles;
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      ProcessHandle handle = manager.Start(exec_path, curr_dir, GetExitCodeArguments(i));
+      ASSERT_TRUE(handle.IsValid());
+      ASSERT_NE(handle.GetProcessId(), ra::process::INVALID_PROCESS_ID);
+      handles.push_back(handle);
+    }
+
+    double time_start = ra::timing::GetMillisecondsTimer();
+    ASSERT_TRUE(manager.WaitAll());
+    double time_end = ra::timing::GetMillisecondsTimer();
+    printf("Reaping %d processes took %.3f seconds\n", NUM_PROCESSES, time_end - time_start);
+
+    ASSERT_EQ(0, manager.GetRunningCount());
+    ASSERT_EQ((size_t)NUM_PROCESSES, counter.count);
+
+    //assert each process exit code
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      ASSERT_TRUE(handles[i].IsCompleted());
+      const ProcessResult & result = handles[i].GetResult();
+      ASSERT_EQ(handles[i].GetProcessId(), result.pid);
+      ASSERT_EQ(i, result.exit_code);
+      ASSERT_EQ(0, result.term_signal);
+      ASSERT_GE(result.runtime, 0.0);
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessManager, testWait) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ProcessManager manager;
+
+    //a process that takes some time to execute
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back("sleep 1; exit 7");
+    ProcessHandle slow_handle = manager.Start(exec_path, curr_dir, arguments);
+    ASSERT_TRUE(slow_handle.IsValid());
+
+    //a process that exits immediately
+    ProcessHandle fast_handle = manager.Start(exec_path, curr_dir, GetExitCodeArguments(3));
+    ASSERT_TRUE(fast_handle.IsValid());
+    ASSERT_EQ(2, manager.GetRunningCount());
+
+    //the result is not available while the process is running
+    ASSERT_FALSE(slow_handle.IsCompleted());
+
+    //adding a managed process returns the same process
+    ProcessHandle same_handle = manager.Add(slow_handle.GetProcessId());
+    ASSERT_EQ(slow_handle.GetProcessId(), same_handle.GetProcessId());
+    ASSERT_EQ(2, manager.GetRunningCount());
+
+    //wait for the fast process only
+    ProcessResult result;
+    ASSERT_TRUE(manager.Wait(fast_handle, result));
+    ASSERT_EQ(3, result.exit_code);
+
+    //wait for the slow process
+    ASSERT_TRUE(manager.Wait(slow_handle, result));
+    ASSERT_EQ(7, result.exit_code);
+    ASSERT_GE(result.runtime, 0.9);
+    ASSERT_EQ(0, manager.GetRunningCount());
+    ASSERT_TRUE(same_handle.IsCompleted());
+
+    //the result remains available after the process is reaped
+    ASSERT_TRUE(manager.Wait(slow_handle, result));
+    ASSERT_EQ(7, result.exit_code);
+
+    //waiting for an invalid handle fails
+    ASSERT_FALSE(manager.Wait(ProcessHandle(), result));
+
+    //waiting for a process managed by another instance fails
+    ProcessManager other_manager;
+    ProcessHandle other_handle = other_manager.Start(exec_path, curr_dir, GetExitCodeArguments(0));
+    ASSERT_TRUE(other_handle.IsValid());
+    ASSERT_FALSE(manager.Wait(other_handle, result));
+    ASSERT_TRUE(other_manager.Wait(other_handle, result));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessManager, testPoll) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ProcessManager manager;
+
+    //nothing to poll
+    ASSERT_EQ(0, manager.Poll(0));
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back("sleep 1");
+    ProcessHandle handle = manager.Start(exec_path, curr_dir, arguments);
+    ASSERT_TRUE(handle.IsValid());
+
+    //assert polling with a timeout returns without any process reaped
+    ASSERT_EQ(0, manager.Poll(0));
+    ASSERT_EQ(0, manager.Poll(100));
+    ASSERT_EQ(1, manager.GetRunningCount());
+
+    //wait indefinitely
+    ASSERT_EQ(1, manager.Poll(-1));
+    ASSERT_EQ(0, manager.GetRunningCount());
+
+    ASSERT_TRUE(handle.IsCompleted());
+    ASSERT_EQ(0, handle.GetResult().exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessManager, testTerminatedBySignal) {
+    const std::string exec_path = "/bin/sh";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ProcessManager manager;
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("-c");
+    arguments.push_back("kill -9 $$");
+    ProcessHandle handle = manager.Start(exec_path, curr_dir, arguments);
+    ASSERT_TRUE(handle.IsValid());
+
+    ProcessResult result;
+    ASSERT_TRUE(manager.Wait(handle, result));
+    ASSERT_EQ(-1, result.exit_code);
+    ASSERT_EQ(9, result.term_signal);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif
+} //namespace test
+} //namespace process
+} //namespace ra
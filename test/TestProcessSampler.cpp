@@ -0,0 +1,147 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestProcessSampler.h"
+#include "rapidassist/processsampler.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/testing.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessSampler::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessSampler::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifdef __linux__
+  TEST_F(TestProcessSampler, testSample) {
+    const processid_t curr_pid = ra::process::GetCurrentProcessId();
+
+    ProcessSampler sampler;
+    ASSERT_FALSE(sampler.Add(ra::process::INVALID_PROCESS_ID));
+    ASSERT_TRUE(sampler.Add(curr_pid));
+    ASSERT_FALSE(sampler.Add(curr_pid)); //already sampled
+    ASSERT_EQ(1, sampler.GetProcessCount());
+
+    //generate some cpu and io activity between samples
+    ASSERT_EQ(1, sampler.Sample());
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".txt";
+    ASSERT_TRUE(ra::testing::CreateFile(file_path.c_str(), 100000));
+    std::string content;
+    ASSERT_TRUE(ra::filesystem::ReadFile(file_path, content));
+    ra::filesystem::DeleteFile(file_path.c_str());
+    ASSERT_EQ(1, sampler.Sample());
+
+    ProcessSampleList samples;
+    sampler.GetSamples(samples);
+    ASSERT_EQ(2, samples.size());
+    const ProcessSample & first = samples[0];
+    const ProcessSample & last = samples[1];
+    ASSERT_EQ(curr_pid, first.pid);
+    ASSERT_EQ(curr_pid, last.pid);
+    ASSERT_LE(first.timestamp, last.timestamp);
+    ASSERT_GT(last.rss, (uint64_t)0);
+    ASSERT_GE(last.user_time + last.system_time, first.user_time + first.system_time);
+    ASSERT_GT(last.voluntary_ctxt_switches + last.nonvoluntary_ctxt_switches, (uint64_t)0);
+    ASSERT_GE(last.write_chars, first.write_chars + 100000);
+    ASSERT_GE(last.read_chars, first.read_chars + 100000);
+
+    ASSERT_TRUE(sampler.Remove(curr_pid));
+    ASSERT_FALSE(sampler.Remove(curr_pid));
+    ASSERT_EQ(0, sampler.GetProcessCount());
+    ASSERT_EQ(0, sampler.Sample());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessSampler, testRingBuffer) {
+    const processid_t curr_pid = ra::process::GetCurrentProcessId();
+
+    static const size_t CAPACITY = 4;
+    ProcessSampler sampler(CAPACITY);
+    ASSERT_EQ(CAPACITY, sampler.GetCapacity());
+    ASSERT_TRUE(sampler.Add(curr_pid));
+
+    //fill the buffer more than its capacity
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(1, sampler.Sample());
+    }
+    ASSERT_EQ(CAPACITY, sampler.GetSampleCount());
+
+    //assert samples are ordered from the oldest to the most recent
+    ProcessSampleList samples;
+    sampler.GetSamples(samples);
+    ASSERT_EQ(CAPACITY, samples.size());
+    for (size_t i = 1; i < samples.size(); i++) {
+      ASSERT_LE(samples[i - 1].timestamp, samples[i].timestamp);
+    }
+
+    //assert the dump contains a header and a line per sample
+    const std::string file_path = ra::testing::GetTestQualifiedName() + ".csv";
+    ASSERT_TRUE(sampler.Dump(file_path));
+    ra::strings::StringVector lines;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, lines));
+    ra::filesystem::DeleteFile(file_path.c_str());
+    ASSERT_EQ(CAPACITY + 1, lines.size());
+    ASSERT_EQ(0, lines[0].find("pid,timestamp,"));
+    ASSERT_EQ(0, lines[1].find(ra::strings::ToString(curr_pid) + ","));
+
+    sampler.Clear();
+    ASSERT_EQ(0, sampler.GetSampleCount());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessSampler, testRun) {
+    const std::string exec_path = "/bin/sleep";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("1");
+    processid_t pid = ra::process::StartProcess(exec_path, curr_dir, arguments);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+
+    ProcessSampler sampler;
+    ASSERT_TRUE(sampler.Add(pid));
+
+    //sample until the child process terminates
+    sampler.Run(50);
+    ASSERT_EQ(0, sampler.GetProcessCount());
+    ASSERT_GE(sampler.GetSampleCount(), 10);
+
+    ProcessSampleList samples;
+    sampler.GetSamples(samples);
+    for (size_t i = 0; i < samples.size(); i++) {
+      ASSERT_EQ(pid, samples[i].pid);
+    }
+
+    int exit_code = -1;
+    ASSERT_TRUE(ra::process::WaitExit(pid, exit_code));
+    ASSERT_EQ(0, exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //__linux__
+} //namespace test
+} //namespace process
+} //namespace ra
@@ -0,0 +1,126 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestProcessSnapshot.h"
+#include "rapidassist/processsnapshot.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessSnapshot::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestProcessSnapshot::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifdef __linux__
+  TEST_F(TestProcessSnapshot, testUpdate) {
+    ProcessSnapshot snapshot;
+    ASSERT_TRUE(snapshot.GetProcesses().empty());
+    ASSERT_TRUE(snapshot.Update());
+
+    const ProcessInfoList & processes = snapshot.GetProcesses();
+    ASSERT_FALSE(processes.empty());
+
+    //assert processes are sorted
+    for (size_t i = 1; i < processes.size(); i++) {
+      ASSERT_LT(processes[i - 1].pid, processes[i].pid);
+    }
+
+    //assert the current process is found with valid statistics
+    const processid_t curr_pid = ra::process::GetCurrentProcessId();
+    const ProcessInfo * info = snapshot.Find(curr_pid);
+    ASSERT_TRUE(info != NULL);
+    ASSERT_EQ(curr_pid, info->pid);
+    ASSERT_EQ(getppid(), info->ppid);
+    ASSERT_EQ('R', info->state);
+    ASSERT_GE(info->num_threads, 1);
+    ASSERT_GT(info->rss, (uint64_t)0);
+    ASSERT_GE(info->user_time, 0.0);
+    ASSERT_GE(info->system_time, 0.0);
+
+    //the name is the truncated executable filename
+    const std::string filename = ra::filesystem::GetFilename(ra::process::GetCurrentProcessPath().c_str());
+    ASSERT_EQ(filename.substr(0, 15), info->name);
+
+    //assert an invalid process is not found
+    ASSERT_TRUE(snapshot.Find(ra::process::INVALID_PROCESS_ID) == NULL);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessSnapshot, testChildProcess) {
+    const std::string exec_path = "/bin/sleep";
+    ASSERT_TRUE(ra::filesystem::FileExists(exec_path.c_str()));
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    ra::strings::StringVector arguments;
+    arguments.push_back("5");
+    processid_t pid = ra::process::StartProcess(exec_path, curr_dir, arguments);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    ra::timing::Millisleep(200);
+
+    ProcessSnapshot snapshot;
+    ASSERT_TRUE(snapshot.Update());
+    const ProcessInfo * info = snapshot.Find(pid);
+    ASSERT_TRUE(info != NULL);
+    ASSERT_EQ(ra::process::GetCurrentProcessId(), info->ppid);
+    ASSERT_EQ('S', info->state);
+    ASSERT_EQ(std::string("sleep"), info->name);
+
+    //a terminated process is reported as a zombie until it is reaped
+    ASSERT_TRUE(ra::process::Kill(pid));
+    ASSERT_TRUE(snapshot.Update());
+    info = snapshot.Find(pid);
+    ASSERT_TRUE(info == NULL || info->state == 'Z');
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestProcessSnapshot, testBenchmarkUpdate) {
+    ProcessSnapshot snapshot;
+    ASSERT_TRUE(snapshot.Update());
+
+    static const int NUM_UPDATES = 100;
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    for (int i = 0; i < NUM_UPDATES; i++) {
+      ASSERT_TRUE(snapshot.Update());
+    }
+    double time_end = ra::timing::GetMicrosecondsTimer();
+    double snapshot_time = (time_end - time_start) / NUM_UPDATES;
+
+    time_start = ra::timing::GetMicrosecondsTimer();
+    for (int i = 0; i < NUM_UPDATES; i++) {
+      ProcessIdList processes = ra::process::GetProcesses();
+      ASSERT_FALSE(processes.empty());
+    }
+    time_end = ra::timing::GetMicrosecondsTimer();
+    double get_processes_time = (time_end - time_start) / NUM_UPDATES;
+
+    printf("ProcessSnapshot::Update() of %d processes took %.3f ms\n", (int)snapshot.GetProcesses().size(), snapshot_time * 1000.0);
+    printf("GetProcesses() took %.3f ms\n", get_processes_time * 1000.0);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //__linux__
+} //namespace test
+} //namespace process
+} //namespace ra
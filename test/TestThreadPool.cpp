@@ -0,0 +1,143 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestThreadPool.h"
+#include "rapidassist/threadpool.h"
+
+#include <vector>
+
+namespace ra { namespace threading { namespace test
+{
+  //increments a counter of the worker that runs the task
+  class CountTask : public ITask {
+  public:
+    CountTask(std::vector<int> * counters) : counters_(counters) {}
+    virtual void Run(ThreadPool & /*pool*/, size_t worker_index) {
+      (*counters_)[worker_index]++;
+    }
+  private:
+    std::vector<int> * counters_;
+  };
+
+  //submits a binary tree of tasks from running tasks
+  class TreeTask : public ITask {
+  public:
+    TreeTask(std::vector<int> * counters, int depth) : counters_(counters), depth_(depth) {}
+    virtual void Run(ThreadPool & pool, size_t worker_index) {
+      (*counters_)[worker_index]++;
+      if (depth_ > 0) {
+        pool.Submit(new TreeTask(counters_, depth_ - 1), worker_index);
+        pool.Submit(new TreeTask(counters_, depth_ - 1), worker_index);
+      }
+    }
+  private:
+    std::vector<int> * counters_;
+    int depth_;
+  };
+
+  int Sum(const std::vector<int> & values) {
+    int sum = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+      sum += values[i];
+    }
+    return sum;
+  }
+
+  //--------------------------------------------------------------------------------------------------
+  void TestThreadPool::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestThreadPool::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestThreadPool, testGetProcessorCount) {
+    ASSERT_GE(GetProcessorCount(), (size_t)1);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestThreadPool, testGetThreadCount) {
+    {
+      ThreadPool pool(3);
+      ASSERT_EQ(3, pool.GetThreadCount());
+    }
+    {
+      ThreadPool pool(0);
+      ASSERT_EQ(GetProcessorCount(), pool.GetThreadCount());
+    }
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestThreadPool, testSubmit) {
+    static const int NUM_TASKS = 1000;
+    static const size_t NUM_THREADS = 4;
+
+    //each worker owns a counter so no synchronization is required
+    std::vector<int> counters(NUM_THREADS, 0);
+
+    ThreadPool pool(NUM_THREADS);
+    for (int i = 0; i < NUM_TASKS; i++) {
+      pool.Submit(new CountTask(&counters));
+    }
+    pool.Wait();
+
+    ASSERT_EQ(NUM_TASKS, Sum(counters));
+
+    //assert the pool can be reused
+    for (int i = 0; i < NUM_TASKS; i++) {
+      pool.Submit(new CountTask(&counters), 0);
+    }
+    pool.Wait();
+
+    ASSERT_EQ(2 * NUM_TASKS, Sum(counters));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestThreadPool, testSubmitFromTask) {
+    static const size_t NUM_THREADS = 4;
+    static const int DEPTH = 10;
+    static const int NUM_TASKS = (1 << (DEPTH + 1)) - 1;
+
+    std::vector<int> counters(NUM_THREADS, 0);
+
+    ThreadPool pool(NUM_THREADS);
+    pool.Submit(new TreeTask(&counters, DEPTH));
+    pool.Wait();
+
+    ASSERT_EQ(NUM_TASKS, Sum(counters));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestThreadPool, testDestructorWaitsForTasks) {
+    static const size_t NUM_THREADS = 2;
+    static const int DEPTH = 8;
+    static const int NUM_TASKS = (1 << (DEPTH + 1)) - 1;
+
+    std::vector<int> counters(NUM_THREADS, 0);
+    {
+      ThreadPool pool(NUM_THREADS);
+      pool.Submit(new TreeTask(&counters, DEPTH));
+    }
+
+    ASSERT_EQ(NUM_TASKS, Sum(counters));
+  }
+  //--------------------------------------------------------------------------------------------------
+} //namespace test
+} //namespace threading
+} //namespace ra
@@ -0,0 +1,160 @@
+/**********************************************************************************
+ * MIT License
+ * 
+ * Copyright (c) 2018 Antoine Beauchamp
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+#include "TestZygote.h"
+#include "rapidassist/zygote.h"
+#include "rapidassist/process.h"
+#include "rapidassist/filesystem.h"
+#include "rapidassist/timing.h"
+
+namespace ra { namespace process { namespace test
+{
+#ifndef _WIN32
+  ra::strings::StringVector GetImmediateExitCodeArguments(int exit_code) {
+    ra::strings::StringVector arguments;
+    arguments.push_back(std::string("--ImmediateExitCode=") + ra::strings::ToString(exit_code));
+    return arguments;
+  }
+#endif
+  //--------------------------------------------------------------------------------------------------
+  void TestZygote::SetUp() {
+  }
+  //--------------------------------------------------------------------------------------------------
+  void TestZygote::TearDown() {
+  }
+  //--------------------------------------------------------------------------------------------------
+#ifndef _WIN32
+  TEST_F(TestZygote, testStartStop) {
+    const std::string exec_path = ra::process::GetCurrentProcessPath();
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    Zygote zygote;
+    ASSERT_FALSE(zygote.IsStarted());
+    ASSERT_TRUE(zygote.Start(exec_path, curr_dir));
+    ASSERT_TRUE(zygote.IsStarted());
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, zygote.GetZygoteProcessId());
+    ASSERT_FALSE(zygote.Start(exec_path, curr_dir));
+    ASSERT_TRUE(zygote.Stop());
+    ASSERT_FALSE(zygote.IsStarted());
+    ASSERT_FALSE(zygote.Stop());
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestZygote, testSpawn) {
+    const std::string exec_path = ra::process::GetCurrentProcessPath();
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    Zygote zygote;
+    ASSERT_TRUE(zygote.Start(exec_path, curr_dir));
+
+    //spawn multiple children before waiting for any of them
+    static const int NUM_PROCESSES = 10;
+    ProcessIdList pids;
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      processid_t pid = zygote.Spawn(curr_dir, GetImmediateExitCodeArguments(i));
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      pids.push_back(pid);
+    }
+
+    //wait in reverse order
+    for (int i = NUM_PROCESSES - 1; i >= 0; i--) {
+      int exit_code = -1;
+      ASSERT_TRUE(zygote.WaitExit(pids[i], exit_code));
+      ASSERT_EQ(i, exit_code);
+    }
+
+    //unknown or already waited processes
+    int exit_code = -1;
+    ASSERT_FALSE(zygote.WaitExit(pids[0], exit_code));
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestZygote, testSpawnDirectory) {
+    const std::string exec_path = ra::process::GetCurrentProcessPath();
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+    const std::string temp_dir = ra::filesystem::GetTemporaryDirectory();
+
+    Zygote zygote;
+    ASSERT_TRUE(zygote.Start(exec_path, curr_dir));
+
+    //the child must run in the requested directory
+    ra::strings::StringVector arguments;
+    arguments.push_back("--SaveGetCurrentDirectory");
+    processid_t pid = zygote.Spawn(temp_dir, arguments);
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    int exit_code = -1;
+    ASSERT_TRUE(zygote.WaitExit(pid, exit_code));
+    ASSERT_EQ(0, exit_code);
+
+    const std::string file_path = ra::process::GetCurrentProcessDir() + ra::filesystem::GetPathSeparatorStr() + "SaveGetCurrentDirectory.txt";
+    std::string child_dir;
+    ASSERT_TRUE(ra::filesystem::ReadTextFile(file_path, child_dir));
+    ra::filesystem::DeleteFile(file_path.c_str());
+    ASSERT_EQ(temp_dir, child_dir);
+
+    //an invalid directory fails the child, not the zygote
+    pid = zygote.Spawn("/this/directory/does/not/exist", GetImmediateExitCodeArguments(0));
+    ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+    ASSERT_TRUE(zygote.WaitExit(pid, exit_code));
+    ASSERT_EQ(127, exit_code);
+  }
+  //--------------------------------------------------------------------------------------------------
+  TEST_F(TestZygote, testBenchmarkSpawn) {
+    const std::string exec_path = ra::process::GetCurrentProcessPath();
+    const std::string curr_dir = ra::filesystem::GetCurrentDirectory();
+
+    static const int NUM_PROCESSES = 100;
+
+    //spawn with StartProcess()
+    double time_start = ra::timing::GetMicrosecondsTimer();
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      processid_t pid = ra::process::StartProcess(exec_path, curr_dir, GetImmediateExitCodeArguments(1));
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      int exit_code = -1;
+      ASSERT_TRUE(ra::process::WaitExit(pid, exit_code));
+      ASSERT_EQ(1, exit_code);
+    }
+    double time_end = ra::timing::GetMicrosecondsTimer();
+    double start_process_time = time_end - time_start;
+
+    //spawn with a zygote
+    Zygote zygote;
+    ASSERT_TRUE(zygote.Start(exec_path, curr_dir));
+    time_start = ra::timing::GetMicrosecondsTimer();
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+      processid_t pid = zygote.Spawn(curr_dir, GetImmediateExitCodeArguments(1));
+      ASSERT_NE(ra::process::INVALID_PROCESS_ID, pid);
+      int exit_code = -1;
+      ASSERT_TRUE(zygote.WaitExit(pid, exit_code));
+      ASSERT_EQ(1, exit_code);
+    }
+    time_end = ra::timing::GetMicrosecondsTimer();
+    double zygote_time = time_end - time_start;
+
+    printf("Spawning and waiting %d processes with StartProcess() took %.3f seconds (%.3f ms per process)\n", NUM_PROCESSES, start_process_time, start_process_time * 1000.0 / NUM_PROCESSES);
+    printf("Spawning and waiting %d processes with Zygote::Spawn() took %.3f seconds (%.3f ms per process)\n", NUM_PROCESSES, zygote_time, zygote_time * 1000.0 / NUM_PROCESSES);
+  }
+  //--------------------------------------------------------------------------------------------------
+#endif //_WIN32
+} //namespace test
+} //namespace process
+} //namespace ra
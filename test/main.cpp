@@ -33,6 +33,7 @@
 #include "rapidassist/environment.h"
 #include "rapidassist/process.h"
 #include "rapidassist/filesystem.h"
+#include "rapidassist/zygote.h"
 
 #include "CommandLineMgr.h"
 
@@ -60,6 +61,12 @@ int main(int argc, char **argv) {
   std::string tmp;
   bool found = false;
 
+#ifndef _WIN32
+  //Serve spawn requests if launched as a zygote.
+  //Children returns from this call with their own arguments.
+  ra::process::RunZygote(argc, argv);
+#endif
+
   //validate --OutputGetCurrentProcessPathUtf8
   found = ra::cli::ParseArgument("OutputGetCurrentProcessPathUtf8", tmp, argc, argv);
   if (found)
@@ -189,6 +196,13 @@ int main(int argc, char **argv) {
     return ra::test::ExitCode(exit_code);
   }
 
+  //validate --ImmediateExitCode
+  found = ra::cli::ParseArgument("ImmediateExitCode", exit_code, argc, argv);
+  if (found)
+  {
+    return ra::test::ImmediateExitCode(exit_code);
+  }
+
   //define default values for xml output report
   std::string outputXml = "xml:" "rapidassist_unittest";
 #ifdef _WIN32